@@ -0,0 +1,473 @@
+#include "network_headers.h"
+#include "header_dsl.h"
+#include "utils.h"
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <arpa/inet.h>
+
+using namespace cppscapy;
+
+bool ipv4_ok(std::string_view text) {
+    IPv4Address address;
+    return IPv4Address::parse(text, address) == std::errc();
+}
+
+bool ipv6_ok(std::string_view text) {
+    IPv6Address address;
+    return IPv6Address::parse(text, address) == std::errc();
+}
+
+void test_ipv4() {
+    std::cout << "Test 1: IPv4 dotted quads\n";
+
+    IPv4Address address;
+    assert(IPv4Address::parse("192.168.1.1", address) == std::errc());
+    assert(address.to_uint32() == IPv4Address(192, 168, 1, 1).to_uint32());
+    assert(IPv4Address::parse("0.0.0.0", address) == std::errc());
+    assert(IPv4Address::parse("255.255.255.255", address) == std::errc());
+    assert(address.to_uint32() == 0xFFFFFFFF);
+
+    for (const char* bad : {"", "1", "1.2.3", "1.2.3.", ".1.2.3", "1..2.3", "1.2.3.4.", "1.2.3.4 ",
+                            "01.2.3.4", "1.2.3.0004", "a.b.c.d", "1.2.3.4\xff", "1,2,3,4"}) {
+        assert(!ipv4_ok(bad));
+    }
+    assert(IPv4Address::parse("256.1.1.1", address) == std::errc::result_out_of_range);
+    assert(IPv4Address::parse("1.2.3.999", address) == std::errc::result_out_of_range);
+    // A failed parse leaves the value untouched
+    assert(address.to_uint32() == 0xFFFFFFFF);
+
+    // from_chars reads a prefix and reports where it stopped
+    const char line[] = "10.1.2.3,10.4.5.6,443";
+    IPv4Address src, dst;
+    auto first = from_chars(line, line + sizeof(line) - 1, src);
+    assert(first.ec == std::errc() && *first.ptr == ',');
+    auto second = from_chars(first.ptr + 1, line + sizeof(line) - 1, dst);
+    assert(second.ec == std::errc() && *second.ptr == ',');
+    assert(src.to_string() == "10.1.2.3" && dst.to_string() == "10.4.5.6");
+    auto error = from_chars(line + 17, line + sizeof(line) - 1, dst);
+    assert(error.ec == std::errc::invalid_argument && error.ptr == line + 17);
+
+    // Agrees with inet_pton on random and mutated inputs
+    std::mt19937 rng(7);
+    const char alphabet[] = "0123456789..";
+    for (int i = 0; i < 200000; ++i) {
+        std::string text;
+        if (i % 2) {
+            text = std::to_string(rng() % 300) + "." + std::to_string(rng() % 256) + "." +
+                   std::to_string(rng() % 256) + "." + std::to_string(rng() % 270);
+        } else {
+            size_t length = rng() % 17;
+            for (size_t k = 0; k < length; ++k) {
+                text += alphabet[rng() % (sizeof(alphabet) - 1)];
+            }
+        }
+        uint32_t expected = 0;
+        bool valid = inet_pton(AF_INET, text.c_str(), &expected) == 1;
+        assert(ipv4_ok(text) == valid);
+        if (valid) {
+            IPv4Address::parse(text, address);
+            assert(address.to_uint32() == expected);
+        }
+    }
+
+    std::cout << "  OK\n\n";
+}
+
+void test_ipv6() {
+    std::cout << "Test 2: IPv6 text forms\n";
+
+    const char* good[] = {
+        "::", "::1", "1::", "2001:db8::1", "2001:DB8:0:0:8:800:200C:417A", "fe80::1:2:3:4:5:6",
+        "1:2:3:4:5:6:7:8", "1:2:3:4:5:6:7::", "::2:3:4:5:6:7:8", "::ffff:192.168.1.1",
+        "64:ff9b::10.0.0.1", "1:2:3:4:5:6:1.2.3.4", "0:0:0:0:0:0:0:0"
+    };
+    for (const char* text : good) {
+        std::array<uint8_t, 16> expected{};
+        assert(inet_pton(AF_INET6, text, expected.data()) == 1);
+        IPv6Address address;
+        assert(IPv6Address::parse(text, address) == std::errc());
+        assert(address.to_bytes() == expected);
+    }
+
+    const char* bad[] = {
+        "", ":", ":::", "1:2", "1::2::3", "12345::", "1:2:3:4:5:6:7:8:9", "1:2:3:4:5:6:7:8::",
+        "1:2:3:4:5:6:7:1.2.3.4", "::1.2.3", "::1.2.3.256", "g::", "1:", ":1", "::ffff:01.2.3.4"
+    };
+    for (const char* text : bad) {
+        std::array<uint8_t, 16> scratch{};
+        assert(inet_pton(AF_INET6, text, scratch.data()) != 1);
+        assert(!ipv6_ok(text));
+    }
+
+    // Random addresses through inet_ntop's text (compressed and mixed forms)
+    std::mt19937 rng(11);
+    for (int i = 0; i < 100000; ++i) {
+        std::array<uint8_t, 16> bytes{};
+        for (auto& b : bytes) {
+            b = (rng() % 3 == 0) ? static_cast<uint8_t>(rng()) : 0;
+        }
+        char text[INET6_ADDRSTRLEN];
+        inet_ntop(AF_INET6, bytes.data(), text, sizeof(text));
+        IPv6Address address;
+        assert(IPv6Address::parse(text, address) == std::errc());
+        assert(address.to_bytes() == bytes);
+    }
+
+    std::cout << "  OK\n\n";
+}
+
+void test_mac() {
+    std::cout << "Test 3: MAC addresses\n";
+
+    MacAddress mac;
+    assert(MacAddress::parse("aa:BB:cc:00:11:ff", mac) == std::errc());
+    assert(mac.to_bytes() == (std::array<uint8_t, 6>{0xAA, 0xBB, 0xCC, 0x00, 0x11, 0xFF}));
+    assert(MacAddress::parse("0-1-2-a-b-c", mac) == std::errc());
+    assert(mac.to_bytes() == (std::array<uint8_t, 6>{0, 1, 2, 0xA, 0xB, 0xC}));
+    for (const char* bad : {"", "aa:bb:cc:dd:ee", "aa:bb:cc:dd:ee:ff:", "aa:bb-cc:dd:ee:ff",
+                            "aaa:bb:cc:dd:ee:ff", "gg:bb:cc:dd:ee:ff", "aa:bb:cc:dd:ee:f g"}) {
+        assert(MacAddress::parse(bad, mac) != std::errc());
+    }
+
+    // The throwing constructors are built on the same parsers
+    bool threw = false;
+    try {
+        MacAddress("not a mac");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    dsl::IPv4Header ip;
+    ip.set_src_ip(std::string("10.20.30.40"));
+    assert(ip.src_ip() == 0x0A141E28);
+
+    std::cout << "  OK\n\n";
+}
+
+std::string text_of(const IPv6Address& address) {
+    char buffer[IPV6_TEXT_SIZE];
+    auto result = to_chars(buffer, buffer + sizeof(buffer), address);
+    assert(result.ec == std::errc());
+    return std::string(buffer, result.ptr);
+}
+
+void test_formatting() {
+    std::cout << "Test 4: Formatting into caller buffers\n";
+
+    // Round trips, and every IPv4 octet width against inet_ntop
+    for (uint32_t value : {0u, 0x01020304u, 0x0A00FF09u, 0x7F000001u, 0xC0A86401u, 0xFFFFFFFFu}) {
+        IPv4Address address(detail::network_order32(value));
+        char expected[INET_ADDRSTRLEN];
+        uint32_t network = address.to_uint32();
+        inet_ntop(AF_INET, &network, expected, sizeof(expected));
+        assert(address.to_string() == expected);
+    }
+    for (uint32_t octet = 0; octet < 256; ++octet) {
+        IPv4Address address(static_cast<uint8_t>(octet), 0, static_cast<uint8_t>(255 - octet), 1);
+        IPv4Address parsed;
+        assert(IPv4Address::parse(address.to_string(), parsed) == std::errc());
+        assert(parsed.to_uint32() == address.to_uint32());
+    }
+    assert(MacAddress(0x00, 0x1A, 0x2B, 0xC3, 0xD4, 0xFF).to_string() == "00:1a:2b:c3:d4:ff");
+
+    // RFC 5952 canonical forms
+    auto v6 = [](const char* text) {
+        IPv6Address address;
+        assert(IPv6Address::parse(text, address) == std::errc());
+        return address;
+    };
+    assert(text_of(v6("2001:0DB8:0000:0000:0000:0000:0000:0001")) == "2001:db8::1");
+    assert(text_of(v6("2001:db8:0:0:1:0:0:1")) == "2001:db8::1:0:0:1");     // first run on a tie
+    assert(text_of(v6("2001:db8:0:1:1:1:1:1")) == "2001:db8:0:1:1:1:1:1");  // no "::" for one group
+    assert(text_of(v6("1:0:0:2:0:0:0:3")) == "1:0:0:2::3");                 // longest run
+    assert(text_of(v6("::")) == "::" && text_of(v6("::1")) == "::1" && text_of(v6("1::")) == "1::");
+    assert(text_of(v6("::ffff:c0a8:101")) == "::ffff:192.168.1.1");
+    assert(text_of(v6("::c0a8:101")) == "::c0a8:101");  // IPv4-compatible is deprecated
+
+    // Agrees with inet_ntop, except glibc still prints IPv4-compatible
+    // addresses (first 96 bits zero) in dotted form
+    std::mt19937 rng(5);
+    for (int i = 0; i < 100000; ++i) {
+        std::array<uint8_t, 16> bytes{};
+        for (auto& b : bytes) {
+            b = (rng() % 3 == 0) ? static_cast<uint8_t>(rng()) : 0;
+        }
+        if (i % 7 == 0) {
+            bytes = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF, bytes[12], bytes[13], bytes[14], bytes[15]};
+        }
+        if (std::all_of(bytes.begin(), bytes.begin() + 12, [](uint8_t b) { return b == 0; })) {
+            continue;
+        }
+        char expected[INET6_ADDRSTRLEN];
+        inet_ntop(AF_INET6, bytes.data(), expected, sizeof(expected));
+        assert(text_of(IPv6Address(bytes)) == expected);
+    }
+
+    // RFC 5952 text is at most 39 characters; short buffers are reported
+    IPv6Address longest = v6("ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255");
+    IPv6Address mapped_max = v6("::ffff:255.255.255.255");
+    char buffer[IPV6_TEXT_SIZE];
+    auto fits = to_chars(buffer, buffer + sizeof(buffer), longest);
+    assert(fits.ec == std::errc() && fits.ptr == buffer + 39);
+    auto too_small = to_chars(buffer, buffer + 10, mapped_max);
+    assert(too_small.ec == std::errc::value_too_large && too_small.ptr == buffer + 10);
+    char quad[IPV4_TEXT_SIZE];
+    auto full = to_chars(quad, quad + sizeof(quad), IPv4Address::broadcast());
+    assert(full.ec == std::errc() && full.ptr == quad + sizeof(quad));
+
+    std::ostringstream stream;
+    stream << IPv4Address(10, 0, 0, 1) << ' ' << v6("fe80::1") << ' ' << MacAddress::broadcast();
+    assert(stream.str() == "10.0.0.1 fe80::1 ff:ff:ff:ff:ff:ff");
+
+    std::cout << "  OK\n\n";
+}
+
+// Literals are checked at compile time; "1.2.3.256"_ipv4 in a constant
+// expression does not build
+constexpr auto LITERAL_GATEWAY = "10.0.0.1"_ipv4;
+constexpr auto LITERAL_ROUTER = "aa:BB:cc:00:11:ff"_mac;
+constexpr auto LITERAL_SERVER = "2001:db8::1"_ipv6;
+static_assert(LITERAL_GATEWAY.to_uint32() == IPv4Address(10, 0, 0, 1).to_uint32(), "_ipv4");
+static_assert(LITERAL_ROUTER.to_bytes()[1] == 0xBB && LITERAL_ROUTER.to_bytes()[5] == 0xFF, "_mac");
+static_assert(LITERAL_SERVER.to_bytes()[0] == 0x20 && LITERAL_SERVER.to_bytes()[15] == 0x01, "_ipv6");
+static_assert(("::ffff:192.168.1.1"_ipv6).to_bytes()[12] == 192, "embedded dotted quad");
+static_assert(utils::common_ips::google_dns1().to_uint32() == IPv4Address(8, 8, 8, 8).to_uint32(), "common_ips");
+
+void test_literals() {
+    std::cout << "Test 5: Address literals\n";
+
+    // The constexpr parsers accept exactly what the runtime parsers accept
+    auto literal_ok = [](auto parse, std::string_view text) {
+        try {
+            parse(text);
+            return true;
+        } catch (const std::invalid_argument&) {
+            return false;
+        }
+    };
+    auto v4 = [](std::string_view text) { return detail::parse_ipv4_literal(text); };
+    auto v6 = [](std::string_view text) { return detail::parse_ipv6_literal(text); };
+    auto mac = [](std::string_view text) { return detail::parse_mac_literal(text); };
+
+    std::mt19937 rng(13);
+    const char alphabet4[] = "0123456789..";
+    const char alphabet6[] = "0123456789abcdefABCDEF:::..";
+    for (int i = 0; i < 200000; ++i) {
+        std::string text;
+        size_t length = rng() % 24;
+        const char* alphabet = (i % 2) ? alphabet4 : alphabet6;
+        size_t size = (i % 2) ? sizeof(alphabet4) - 1 : sizeof(alphabet6) - 1;
+        for (size_t k = 0; k < length; ++k) {
+            text += alphabet[rng() % size];
+        }
+        assert(literal_ok(v4, text) == ipv4_ok(text));
+        assert(literal_ok(v6, text) == ipv6_ok(text));
+        if (ipv6_ok(text)) {
+            IPv6Address parsed;
+            IPv6Address::parse(text, parsed);
+            assert(v6(text).to_bytes() == parsed.to_bytes());
+        }
+    }
+    for (const char* text : {"aa:bb:cc:dd:ee:ff", "0-1-2-a-b-c", "aa:bb-cc:dd:ee:ff", "aaa:bb:cc:dd:ee:ff",
+                             "aa:bb:cc:dd:ee", "aa:bb:cc:dd:ee:ff:", ""}) {
+        MacAddress parsed;
+        assert(literal_ok(mac, text) == (MacAddress::parse(text, parsed) == std::errc()));
+    }
+
+    // Outside a constant expression a bad literal throws like the constructors
+    bool threw = false;
+    try {
+        auto bad = "1.2.3.256"_ipv4;
+        (void)bad;
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    dsl::IPv4Header ip;
+    ip.set_dst_ip(LITERAL_GATEWAY);
+    assert(ip.dst_ip() == 0x0A000001);
+
+    std::cout << "  OK\n\n";
+}
+
+void benchmark_parsing() {
+    std::cout << "Test 6: Parsing a flow CSV column (1M addresses)\n";
+
+    const size_t count = 1000000;
+    std::mt19937 rng(3);
+    std::string csv4, csv6;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t ip = rng();
+        csv4 += std::to_string(ip >> 24) + "." + std::to_string((ip >> 16) & 0xFF) + "." +
+                std::to_string((ip >> 8) & 0xFF) + "." + std::to_string(ip & 0xFF) + "\n";
+        std::array<uint8_t, 16> bytes{0x20, 0x01, 0x0d, 0xb8};
+        for (size_t k = 8; k < 16; ++k) bytes[k] = static_cast<uint8_t>(rng());
+        char text[INET6_ADDRSTRLEN];
+        inet_ntop(AF_INET6, bytes.data(), text, sizeof(text));
+        csv6 += text;
+        csv6 += "\n";
+    }
+
+    auto time = [](const char* name, size_t bytes, auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        uint64_t sink = body();
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(7) << 1e9 * seconds / 1000000 << " ns/addr  "
+                  << std::setw(6) << bytes / seconds / 1e6 << " MB/s (sink " << (sink & 0xF) << ")\n";
+    };
+
+    time("IPv4 from_chars", csv4.size(), [&] {
+        uint64_t sink = 0;
+        const char* p = csv4.data();
+        const char* end = p + csv4.size();
+        IPv4Address address;
+        while (p < end) {
+            auto result = from_chars(p, end, address);
+            sink += address.to_uint32();
+            p = result.ptr + 1;
+        }
+        return sink;
+    });
+    time("IPv4 std::string + IPv4Address", csv4.size(), [&] {
+        uint64_t sink = 0;
+        size_t start = 0;
+        while (start < csv4.size()) {
+            size_t newline = csv4.find('\n', start);
+            sink += IPv4Address(csv4.substr(start, newline - start)).to_uint32();
+            start = newline + 1;
+        }
+        return sink;
+    });
+    time("IPv4 inet_pton", csv4.size(), [&] {
+        uint64_t sink = 0;
+        size_t start = 0;
+        while (start < csv4.size()) {
+            size_t newline = csv4.find('\n', start);
+            uint32_t value = 0;
+            inet_pton(AF_INET, csv4.substr(start, newline - start).c_str(), &value);
+            sink += value;
+            start = newline + 1;
+        }
+        return sink;
+    });
+    time("IPv6 from_chars", csv6.size(), [&] {
+        uint64_t sink = 0;
+        const char* p = csv6.data();
+        const char* end = p + csv6.size();
+        IPv6Address address;
+        while (p < end) {
+            auto result = from_chars(p, end, address);
+            sink += address.to_bytes()[15];
+            p = result.ptr + 1;
+        }
+        return sink;
+    });
+    time("IPv6 inet_pton", csv6.size(), [&] {
+        uint64_t sink = 0;
+        size_t start = 0;
+        while (start < csv6.size()) {
+            size_t newline = csv6.find('\n', start);
+            std::array<uint8_t, 16> value{};
+            inet_pton(AF_INET6, csv6.substr(start, newline - start).c_str(), value.data());
+            sink += value[15];
+            start = newline + 1;
+        }
+        return sink;
+    });
+    std::cout << "\n";
+}
+
+void benchmark_formatting() {
+    std::cout << "Test 7: Formatting 1M addresses\n";
+
+    const size_t count = 1000000;
+    std::mt19937 rng(9);
+    std::vector<IPv4Address> v4;
+    std::vector<IPv6Address> v6;
+    for (size_t i = 0; i < count; ++i) {
+        v4.emplace_back(static_cast<uint32_t>(rng()));
+        std::array<uint8_t, 16> bytes{0x20, 0x01, 0x0d, 0xb8};
+        for (size_t k = 8; k < 16; ++k) bytes[k] = static_cast<uint8_t>(rng());
+        v6.emplace_back(bytes);
+    }
+
+    auto time = [](const char* name, auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        uint64_t sink = body();
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(7) << 1e9 * seconds / 1000000
+                  << " ns/addr (sink " << (sink & 0xF) << ")\n";
+    };
+
+    time("IPv4 to_chars", [&] {
+        uint64_t sink = 0;
+        char buffer[IPV4_TEXT_SIZE];
+        for (const auto& address : v4) {
+            sink += to_chars(buffer, buffer + sizeof(buffer), address).ptr - buffer;
+        }
+        return sink;
+    });
+    time("IPv4 inet_ntop", [&] {
+        uint64_t sink = 0;
+        char buffer[INET_ADDRSTRLEN];
+        for (const auto& address : v4) {
+            uint32_t network = address.to_uint32();
+            sink += std::strlen(inet_ntop(AF_INET, &network, buffer, sizeof(buffer)));
+        }
+        return sink;
+    });
+    time("IPv4 dotted std::to_string concat", [&] {
+        uint64_t sink = 0;
+        for (const auto& address : v4) {
+            uint32_t ip = detail::network_order32(address.to_uint32());
+            sink += (std::to_string((ip >> 24) & 0xFF) + "." + std::to_string((ip >> 16) & 0xFF) + "." +
+                     std::to_string((ip >> 8) & 0xFF) + "." + std::to_string(ip & 0xFF)).size();
+        }
+        return sink;
+    });
+    time("IPv6 to_chars", [&] {
+        uint64_t sink = 0;
+        char buffer[IPV6_TEXT_SIZE];
+        for (const auto& address : v6) {
+            sink += to_chars(buffer, buffer + sizeof(buffer), address).ptr - buffer;
+        }
+        return sink;
+    });
+    time("IPv6 inet_ntop", [&] {
+        uint64_t sink = 0;
+        char buffer[INET6_ADDRSTRLEN];
+        for (const auto& address : v6) {
+            auto bytes = address.to_bytes();
+            sink += std::strlen(inet_ntop(AF_INET6, bytes.data(), buffer, sizeof(buffer)));
+        }
+        return sink;
+    });
+    std::cout << "\n";
+}
+
+int main() {
+    std::cout << "=== Testing Address Text ===\n\n";
+
+    test_ipv4();
+    test_ipv6();
+    test_mac();
+    test_formatting();
+    test_literals();
+    benchmark_parsing();
+    benchmark_formatting();
+
+    std::cout << "=== Address Text Tests Complete ===\n";
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include "address_prefix.h"
+#include "network_headers.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <set>
+#include <sstream>
+
+using namespace cppscapy;
+
+constexpr IPv4Prefix TEN_SLASH_8("10.1.2.3"_ipv4, 8);
+static_assert(TEN_SLASH_8.network().to_uint32() == ("10.0.0.0"_ipv4).to_uint32(), "host bits cleared");
+static_assert(TEN_SLASH_8.contains("10.255.0.1"_ipv4) && !TEN_SLASH_8.contains("11.0.0.0"_ipv4), "contains");
+static_assert(TEN_SLASH_8.size() == (1u << 24), "size");
+static_assert(IPv4Prefix("0.0.0.0"_ipv4, 0).size() == (uint64_t(1) << 32), "/0 size");
+
+void test_ipv4_prefix() {
+    std::cout << "Test 1: IPv4 prefixes\n";
+
+    IPv4Prefix prefix("192.168.1.77/24");
+    assert(prefix.to_string() == "192.168.1.0/24");
+    assert(prefix.length() == 24 && prefix.size() == 256);
+    assert(prefix.netmask().to_string() == "255.255.255.0");
+    assert(prefix.last().to_string() == "192.168.1.255");
+    assert(prefix.contains("192.168.1.200"_ipv4) && !prefix.contains("192.168.2.0"_ipv4));
+    assert(IPv4Prefix("192.168.0.0/16").contains(prefix) && !prefix.contains(IPv4Prefix("192.168.0.0/16")));
+    assert(prefix[5].to_string() == "192.168.1.5");
+
+    // Iteration visits every address once, in order
+    uint32_t expected = detail::host_order("192.168.1.0"_ipv4);
+    size_t count = 0;
+    for (IPv4Address address : prefix) {
+        assert(detail::host_order(address) == expected++);
+        ++count;
+    }
+    assert(count == 256);
+    IPv4Prefix host("8.8.8.8/32");
+    assert(host.size() == 1 && (*host.begin()).to_string() == "8.8.8.8" && host.begin() + 1 == host.end());
+    assert(IPv4Prefix("255.255.255.0/24").last().to_string() == "255.255.255.255");
+
+    // Splits cover the prefix exactly, with sizes differing by at most one
+    auto parts = IPv4Prefix("10.0.0.0/22").split(3);
+    assert(parts.size() == 3);
+    assert(parts[0].size() == 342 && parts[1].size() == 341 && parts[2].size() == 341);
+    assert(parts[0].begin() == IPv4Prefix("10.0.0.0/22").begin() && parts[0].end() == parts[1].begin());
+    assert(parts[2].end() == IPv4Prefix("10.0.0.0/22").end());
+    assert(IPv4Prefix("10.0.0.0/31").split(8).size() == 2);
+    assert(IPv4Prefix("0.0.0.0/0").split(4)[3].size() == (uint64_t(1) << 30));
+
+    // Samples stay inside the prefix and reach all of a small one
+    std::mt19937 rng(1);
+    std::set<uint32_t> seen;
+    IPv4Prefix small("172.16.5.0/28");
+    for (int i = 0; i < 2000; ++i) {
+        IPv4Address address = small.sample(rng);
+        assert(small.contains(address));
+        seen.insert(address.to_uint32());
+    }
+    assert(seen.size() == 16);
+
+    // Text forms
+    IPv4Prefix parsed;
+    for (const char* bad : {"10.0.0.0", "10.0.0.0/", "10.0.0.0/33", "10.0.0.0/08", "10.0.0.0/-1",
+                            "10.0.0.0/8 ", "10.0.0/8", "/8"}) {
+        assert(IPv4Prefix::parse(bad, parsed) != std::errc());
+    }
+    assert(IPv4Prefix::parse("10.0.0.0/33", parsed) == std::errc::result_out_of_range);
+    assert(IPv4Prefix::parse("0.0.0.0/0", parsed) == std::errc() && parsed.size() == (uint64_t(1) << 32));
+    bool threw = false;
+    try {
+        IPv4Prefix("1.2.3.4"_ipv4, 40);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "  OK\n\n";
+}
+
+void test_ipv6_prefix() {
+    std::cout << "Test 2: IPv6 prefixes\n";
+
+    IPv6Prefix prefix("2001:db8:abcd:12::1/48");
+    assert(prefix.to_string() == "2001:db8:abcd::/48");
+    assert(prefix.last().to_string() == "2001:db8:abcd:ffff:ffff:ffff:ffff:ffff");
+    assert(prefix.contains("2001:db8:abcd:ffff::1"_ipv6) && !prefix.contains("2001:db8:abce::"_ipv6));
+    assert(IPv6Prefix("2001:db8::/32").contains(prefix));
+    assert(prefix.size() == (detail::uint128(1) << 80));
+    assert(prefix[0x1234].to_string() == "2001:db8:abcd::1234");
+
+    IPv6Prefix slash120("fe80::100/120");
+    size_t count = 0;
+    for (IPv6Address address : slash120) {
+        assert(slash120.contains(address));
+        ++count;
+    }
+    assert(count == 256);
+
+    // A /48 sweep split four ways: each worker gets a /50
+    auto parts = prefix.split(4);
+    assert(parts.size() == 4);
+    assert((*parts[1].begin()).to_string() == "2001:db8:abcd:4000::");
+    assert(parts[3].end() == prefix.end());
+
+    std::mt19937_64 rng(2);
+    IPv6Prefix wide("2001:db8::/32");
+    bool high_bit = false;
+    bool low_bit = false;
+    for (int i = 0; i < 1000; ++i) {
+        IPv6Address address = wide.sample(rng);
+        assert(wide.contains(address));
+        high_bit |= (address.to_bytes()[4] & 0x80) != 0;
+        low_bit |= (address.to_bytes()[15] & 0x01) != 0;
+    }
+    assert(high_bit && low_bit);
+
+    // The first draw is the high half, whatever the compiler
+    std::mt19937_64 first(9), second(9);
+    std::uniform_int_distribution<uint64_t> bits;
+    uint64_t high = bits(second);
+    uint64_t low = bits(second);
+    detail::uint128 sampled = detail::host_order(IPv6Prefix("::/0").sample(first));
+    assert(sampled == ((detail::uint128(high) << 64) | low));
+
+    IPv6Prefix parsed;
+    assert(IPv6Prefix::parse("::/0", parsed) == std::errc() && parsed.length() == 0);
+    assert(IPv6Prefix::parse("::1/128", parsed) == std::errc() && parsed.size() == 1);
+    assert(IPv6Prefix::parse("::1/129", parsed) == std::errc::result_out_of_range);
+    assert(IPv6Prefix::parse("2001:db8::/", parsed) == std::errc::invalid_argument);
+
+    std::ostringstream stream;
+    stream << IPv4Prefix("10.0.0.0/8") << ' ' << IPv6Prefix("2001:db8::/32");
+    assert(stream.str() == "10.0.0.0/8 2001:db8::/32");
+
+    std::cout << "  OK\n\n";
+}
+
+void benchmark_sweep() {
+    std::cout << "Test 3: Sweeping a /12 (1M addresses)\n";
+
+    IPv4Prefix prefix("172.16.0.0/12");
+    auto time = [](const char* name, auto&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        uint64_t sink = body();
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(8) << 1e9 * seconds / (1 << 20)
+                  << " ns/addr (sink " << (sink & 0xF) << ")\n";
+    };
+
+    time("IPv4Prefix iteration", [&] {
+        uint64_t sink = 0;
+        for (IPv4Address address : prefix) {
+            sink += address.to_uint32();
+        }
+        return sink;
+    });
+    time("IPv4Prefix::sample", [&] {
+        std::mt19937 rng(3);
+        uint64_t sink = 0;
+        for (size_t i = 0; i < prefix.size(); ++i) {
+            sink += prefix.sample(rng).to_uint32();
+        }
+        return sink;
+    });
+    time("IPv4Address(std::string)", [&] {
+        uint64_t sink = 0;
+        for (uint32_t b = 0; b < 16; ++b) {
+            for (uint32_t c = 0; c < 256; ++c) {
+                for (uint32_t d = 0; d < 256; ++d) {
+                    sink += IPv4Address("172." + std::to_string(16 + b) + "." + std::to_string(c) + "." +
+                                        std::to_string(d)).to_uint32();
+                }
+            }
+        }
+        return sink;
+    });
+    std::cout << "\n";
+}
+
+int main() {
+    std::cout << "=== Testing Address Prefixes ===\n\n";
+
+    test_ipv4_prefix();
+    test_ipv6_prefix();
+    benchmark_sweep();
+
+    std::cout << "=== Address Prefix Tests Complete ===\n";
+    return 0;
+}
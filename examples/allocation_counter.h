@@ -0,0 +1,36 @@
+#pragma once
+// Counts heap allocations so tests can check that a path needs none:
+//
+//   size_t before = allocations;
+//   ...
+//   assert(allocations == before);
+//
+// Replaces the global operator new and delete, so include it from exactly
+// one source file of a test executable.
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
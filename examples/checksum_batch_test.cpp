@@ -0,0 +1,187 @@
+#include "checksum.h"
+#include "utils.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+
+using namespace cppscapy;
+
+const checksum::Kernel all_kernels[] = {
+    checksum::Kernel::Scalar,
+    checksum::Kernel::SSE2,
+    checksum::Kernel::AVX2,
+    checksum::Kernel::AVX512
+};
+
+// Ethernet + IPv4 + UDP/TCP/ICMP frames with valid checksums, cycling protocols
+std::vector<uint8_t> make_ipv4_frame(size_t n) {
+    IPv4Address src(10, 0, static_cast<uint8_t>(n >> 8), static_cast<uint8_t>(n));
+    IPv4Address dst(192, 168, 1, static_cast<uint8_t>(n * 7));
+    auto payload = utils::random::random_bytes_seeded(n % 97, static_cast<uint32_t>(n));
+    EthernetHeader eth(MacAddress("00:11:22:33:44:55"), MacAddress("66:77:88:99:aa:bb"),
+                       EthernetHeader::ETHERTYPE_IPV4);
+
+    PacketBuilder builder;
+    builder.ethernet(eth);
+    switch (n % 3) {
+        case 0: {
+            IPv4Header ip(src, dst, IPv4Header::PROTOCOL_UDP);
+            ip.length(IPv4Header::MIN_SIZE + UDPHeader::SIZE + payload.size()).id(static_cast<uint16_t>(n));
+            builder.ipv4(ip).udp(UDPHeader(1000, 2000, UDPHeader::SIZE + payload.size()));
+            break;
+        }
+        case 1: {
+            IPv4Header ip(src, dst, IPv4Header::PROTOCOL_TCP);
+            ip.length(IPv4Header::MIN_SIZE + TCPHeader::MIN_SIZE + payload.size()).ttl(static_cast<uint8_t>(n));
+            builder.ipv4(ip).tcp(TCPHeader(40000, 80).seq_num(static_cast<uint32_t>(n)));
+            break;
+        }
+        default: {
+            IPv4Header ip(src, dst, IPv4Header::PROTOCOL_ICMP);
+            ip.length(IPv4Header::MIN_SIZE + ICMPHeader::MIN_SIZE + payload.size());
+            builder.ipv4(ip).icmp(ICMPHeader(ICMPHeader::TYPE_ECHO_REQUEST, 0).sequence(static_cast<uint16_t>(n)));
+            break;
+        }
+    }
+    return builder.payload(payload).build();
+}
+
+void test_header_kernels() {
+    std::cout << "Test 1: Batched IPv4 header sums match the scalar sum\n";
+
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<const uint8_t*> headers;
+    for (size_t n = 0; n < 53; ++n) {
+        frames.push_back(utils::random::random_bytes_seeded(20, static_cast<uint32_t>(n + 1)));
+    }
+    for (const auto& frame : frames) {
+        headers.push_back(frame.data());
+    }
+
+    for (auto kernel : all_kernels) {
+        if (!checksum::kernel_supported(kernel)) {
+            continue;
+        }
+        std::vector<uint16_t> sums(headers.size());
+        checksum::partial_ipv4_headers_with(kernel, headers.data(), headers.size(), sums.data());
+        for (size_t i = 0; i < headers.size(); ++i) {
+            assert(sums[i] == checksum::partial(headers[i], 20));
+        }
+        std::cout << "  " << checksum::kernel_name(kernel) << ": OK\n";
+    }
+    std::cout << "\n";
+}
+
+void test_failure_bitmask() {
+    std::cout << "Test 2: Failure bitmask over mixed packets\n";
+
+    std::vector<std::vector<uint8_t>> frames;
+    for (size_t n = 0; n < 200; ++n) {
+        frames.push_back(make_ipv4_frame(n));
+    }
+
+    // IPv4 with a 4-byte option (IHL 6) goes through the scalar path
+    auto with_options = make_ipv4_frame(1000);
+    with_options.insert(with_options.begin() + 34, {1, 1, 1, 0});
+    with_options[14] = 0x46;
+    uint16_t total = ((with_options[16] << 8) | with_options[17]) + 4;
+    with_options[16] = total >> 8;
+    with_options[17] = total & 0xFF;
+    with_options[24] = with_options[25] = 0;
+    uint16_t ip_checksum = checksum::compute(with_options.data() + 14, 24);
+    with_options[24] = ip_checksum >> 8;
+    with_options[25] = ip_checksum & 0xFF;
+    frames.push_back(with_options);
+
+    // IPv6 + UDP
+    IPv6Header ip6(IPv6Address("2001:db8::1"), IPv6Address("2001:db8::2"), IPv6Header::NEXT_HEADER_UDP);
+    ip6.payload_length(UDPHeader::SIZE + 5);
+    frames.push_back(PacketBuilder().ipv6(ip6).udp(UDPHeader(53, 53, UDPHeader::SIZE + 5))
+                         .payload(std::string("hello")).build());
+
+    std::vector<utils::PacketRef> refs;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        bool ipv6 = i == frames.size() - 1;
+        bool options = i == frames.size() - 2;
+        size_t l3 = ipv6 ? 0 : 14;
+        size_t l4 = ipv6 ? 40 : (options ? 14 + 24 : 14 + 20);
+        refs.push_back({frames[i].data(), frames[i].size(), l3, l4});
+    }
+
+    auto failures = utils::verify_checksums(refs);
+    assert(failures.size() == (refs.size() + 63) / 64);
+    for (uint64_t word : failures) {
+        assert(word == 0);
+    }
+
+    // Corrupt the transport data of some packets and the IPv4 header of others
+    std::vector<size_t> corrupted = {0, 7, 63, 64, 100, 131, 199, frames.size() - 2, frames.size() - 1};
+    for (size_t i : corrupted) {
+        if (i % 2 == 1 && i < 200) {
+            frames[i][22] ^= 0x5A; // TTL
+        } else {
+            frames[i].back() ^= 0x5A;
+        }
+    }
+    // Truncated capture
+    refs[150].length -= 3;
+    corrupted.push_back(150);
+
+    failures = utils::verify_checksums(refs);
+    size_t failed = 0;
+    for (size_t i = 0; i < refs.size(); ++i) {
+        bool is_failed = (failures[i / 64] >> (i % 64)) & 1;
+        bool expected = std::find(corrupted.begin(), corrupted.end(), i) != corrupted.end();
+        assert(is_failed == expected);
+        failed += is_failed;
+    }
+
+    std::cout << "  " << failed << " of " << refs.size() << " packets flagged: OK\n\n";
+}
+
+void benchmark_batch() {
+    std::cout << "Test 3: Header verification throughput\n";
+
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<utils::PacketRef> refs;
+    for (size_t n = 0; n < 4096; ++n) {
+        frames.push_back(make_ipv4_frame(n));
+    }
+    for (const auto& frame : frames) {
+        refs.push_back({frame.data(), frame.size(), 14, 0});
+    }
+
+    const int iterations = 200;
+    size_t sink = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (const auto& ref : refs) {
+            sink += utils::verify_ipv4_checksum(ref.data + 14, ref.length - 14);
+        }
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        sink += utils::verify_checksums(refs)[0] & 1;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double packets = static_cast<double>(refs.size()) * iterations;
+    std::cout << "  verify_ipv4_checksum: " << std::fixed << std::setprecision(1)
+              << packets / std::chrono::duration<double>(middle - start).count() / 1e6 << " Mpps\n"
+              << "  verify_checksums:     "
+              << packets / std::chrono::duration<double>(end - middle).count() / 1e6 << " Mpps"
+              << " (sink " << (sink & 0xF) << ")\n\n";
+}
+
+int main() {
+    std::cout << "=== Testing Batch Checksum Verification ===\n\n";
+
+    test_header_kernels();
+    test_failure_bitmask();
+    benchmark_batch();
+
+    std::cout << "=== Batch Checksum Verification Tests Complete ===\n";
+    return 0;
+}
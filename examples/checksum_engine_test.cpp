@@ -0,0 +1,308 @@
+#include "checksum.h"
+#include "utils.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <atomic>
+
+using namespace cppscapy;
+
+// Straightforward RFC 1071 reference implementation
+uint16_t reference_checksum(const uint8_t* data, size_t length) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i + 1 < length; i += 2) {
+        sum += (data[i] << 8) | data[i + 1];
+    }
+    if (length % 2 == 1) {
+        sum += data[length - 1] << 8;
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return static_cast<uint16_t>(~sum);
+}
+
+const checksum::Kernel all_kernels[] = {
+    checksum::Kernel::Scalar,
+    checksum::Kernel::SSE2,
+    checksum::Kernel::AVX2,
+    checksum::Kernel::AVX512
+};
+
+void test_kernels_match_reference() {
+    std::cout << "Test 1: Every supported kernel matches the reference\n";
+
+    // Extra bytes at the front let us test misaligned starts
+    auto buffer = utils::random::random_bytes_seeded(4096 + 64, 42);
+
+    for (auto kernel : all_kernels) {
+        if (!checksum::kernel_supported(kernel)) {
+            std::cout << "  " << checksum::kernel_name(kernel) << ": not supported, skipped\n";
+            continue;
+        }
+
+        for (size_t offset = 0; offset < 8; ++offset) {
+            for (size_t length = 0; length <= 4096; length += (length < 300 ? 1 : 61)) {
+                const uint8_t* data = buffer.data() + offset;
+                uint16_t expected = reference_checksum(data, length);
+                uint16_t actual = static_cast<uint16_t>(~checksum::partial_with(kernel, data, length));
+                assert(actual == expected);
+            }
+        }
+        std::cout << "  " << checksum::kernel_name(kernel) << ": OK\n";
+    }
+
+    // All-ones data is the worst case for carries
+    std::vector<uint8_t> ones(65536, 0xFF);
+    for (auto kernel : all_kernels) {
+        if (checksum::kernel_supported(kernel)) {
+            assert(static_cast<uint16_t>(~checksum::partial_with(kernel, ones.data(), ones.size())) ==
+                   reference_checksum(ones.data(), ones.size()));
+        }
+    }
+
+    std::cout << "\n";
+}
+
+void test_chaining() {
+    std::cout << "Test 2: Chained partial sums\n";
+
+    auto data = utils::random::random_bytes_seeded(1000, 7);
+
+    // Splitting at an even offset must give the same result
+    uint16_t first = checksum::partial(data.data(), 500);
+    uint16_t chained = checksum::finish(checksum::partial(data.data() + 500, 500, first));
+    assert(chained == checksum::compute(data));
+    assert(chained == reference_checksum(data.data(), data.size()));
+
+    std::cout << "  Chained checksum: 0x" << std::hex << chained << std::dec << "\n\n";
+}
+
+void test_scatter_gather() {
+    std::cout << "Test 3: Scatter-gather segments with odd boundaries\n";
+
+    auto data = utils::random::random_bytes_seeded(2001, 11);
+    uint16_t expected = reference_checksum(data.data(), data.size());
+
+    // Split the buffer at a variety of odd and even points
+    const size_t cuts[][3] = {{1, 2, 3}, {7, 500, 501}, {0, 0, 2001}, {999, 1000, 1999}, {2, 4, 1001}};
+    for (const auto& cut : cuts) {
+        checksum::Segment segments[4] = {
+            {data.data(), cut[0]},
+            {data.data() + cut[0], cut[1] - cut[0]},
+            {data.data() + cut[1], cut[2] - cut[1]},
+            {data.data() + cut[2], data.size() - cut[2]}
+        };
+        assert(checksum::finish(checksum::partial(segments, 4)) == expected);
+    }
+
+    // UDP checksum against an explicitly concatenated pseudo-header + datagram
+    IPv4Address src("192.168.1.10");
+    IPv4Address dst("10.1.2.3");
+    auto payload = utils::random::random_bytes_seeded(9001, 13);
+    UDPHeader udp(5000, 6000, UDPHeader::SIZE + payload.size());
+
+    std::vector<uint8_t> concatenated;
+    auto src_bytes = src.to_bytes();
+    auto dst_bytes = dst.to_bytes();
+    concatenated.insert(concatenated.end(), src_bytes.begin(), src_bytes.end());
+    concatenated.insert(concatenated.end(), dst_bytes.begin(), dst_bytes.end());
+    uint16_t udp_length = UDPHeader::SIZE + payload.size();
+    for (uint8_t b : {uint8_t(0), uint8_t(17), uint8_t(udp_length >> 8), uint8_t(udp_length & 0xFF)}) {
+        concatenated.push_back(b);
+    }
+    auto udp_bytes = udp.to_bytes();
+    concatenated.insert(concatenated.end(), udp_bytes.begin(), udp_bytes.end());
+    concatenated.insert(concatenated.end(), payload.begin(), payload.end());
+
+    assert(udp.calculate_checksum(src, dst, payload) == reference_checksum(concatenated.data(), concatenated.size()));
+
+    std::cout << "  Segmented sums and UDP pseudo-header: OK\n\n";
+}
+
+void test_callers_use_engine() {
+    std::cout << "Test 4: Library checksum paths agree\n";
+
+    IPv4Header ip(IPv4Address("192.168.1.100"), IPv4Address("10.0.0.1"), IPv4Header::PROTOCOL_UDP);
+    ip.ttl(64).id(0x1c46).length(60);
+    auto header = ip.to_bytes();
+
+    assert(utils::verify_ipv4_checksum(header));
+    assert(utils::calculate_ipv4_header_checksum(header) == ((header[10] << 8) | header[11]));
+
+    std::cout << "  IPv4 header checksum: 0x" << std::hex << ((header[10] << 8) | header[11])
+              << std::dec << "\n\n";
+}
+
+void test_fused_copy() {
+    std::cout << "Test 5: Fused copy + checksum\n";
+
+    auto buffer = utils::random::random_bytes_seeded(4096 + 64, 99);
+    std::vector<uint8_t> destination(4096 + 64);
+
+    for (auto kernel : all_kernels) {
+        if (!checksum::kernel_supported(kernel)) {
+            continue;
+        }
+
+        for (size_t offset = 0; offset < 8; ++offset) {
+            for (size_t length = 0; length <= 4096; length += (length < 300 ? 1 : 61)) {
+                std::fill(destination.begin(), destination.end(), 0xA5);
+                const uint8_t* src = buffer.data() + offset;
+                uint8_t* dst = destination.data() + (7 - offset);
+                uint16_t sum = checksum::partial_copy_with(kernel, dst, src, length, 0x1234);
+                assert(sum == checksum::partial_with(checksum::Kernel::Scalar, src, length, 0x1234));
+                assert(std::equal(src, src + length, dst));
+                assert(dst[length] == 0xA5);
+            }
+        }
+        std::cout << "  " << checksum::kernel_name(kernel) << ": OK\n";
+    }
+
+    // PacketBuilder folds payload into the pending UDP checksum as it copies
+    IPv4Address src("192.0.2.1");
+    IPv4Address dst("198.51.100.7");
+    auto payload = utils::random::random_bytes_seeded(100001, 17);
+    UDPHeader udp(7, 9, UDPHeader::SIZE + payload.size());
+    IPv4Header ip(src, dst, IPv4Header::PROTOCOL_UDP);
+    ip.length(IPv4Header::MIN_SIZE + UDPHeader::SIZE + payload.size());
+
+    auto packet = PacketBuilder().ipv4(ip).udp(udp)
+        .payload(payload.data(), 3).payload(payload.data() + 3, payload.size() - 3).build();
+    assert(((packet[26] << 8) | packet[27]) == udp.calculate_checksum(src, dst, payload));
+
+    std::cout << "  PacketBuilder pending UDP checksum: OK\n\n";
+}
+
+void test_parallel() {
+    std::cout << "Test 6: Parallel sums are bit-identical to the scalar path\n";
+
+    size_t saved_threshold = checksum::parallel_threshold();
+    checksum::set_parallel_threads(4);
+    checksum::set_parallel_threshold(4096);
+
+    auto buffer = utils::random::random_bytes_seeded(300000 + 64, 23);
+    for (size_t offset = 0; offset < 4; ++offset) {
+        for (size_t length : {4096, 4097, 10001, 65536, 299999}) {
+            const uint8_t* data = buffer.data() + offset;
+            assert(checksum::partial(data, length, 0x1234) ==
+                   checksum::partial_with(checksum::Kernel::Scalar, data, length, 0x1234));
+        }
+    }
+
+    // Several threads sharing the pool
+    std::vector<std::thread> callers;
+    std::atomic<int> mismatches{0};
+    uint16_t expected = checksum::partial_with(checksum::Kernel::Scalar, buffer.data() + 1, 250001);
+    for (int t = 0; t < 4; ++t) {
+        callers.emplace_back([&] {
+            for (int i = 0; i < 50; ++i) {
+                if (checksum::partial(buffer.data() + 1, 250001) != expected) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    assert(mismatches == 0);
+
+    // IPv6 UDP jumbogram through the regular entry point
+    IPv6Address src("2001:db8::1");
+    IPv6Address dst("2001:db8::2");
+    auto payload = utils::random::random_bytes_seeded(5 * 1024 * 1024 + 3, 29);
+    UDPHeader udp(9000, 9001, 0);
+    uint16_t parallel_result = udp.calculate_checksum(src, dst, payload);
+    checksum::set_parallel_threshold(0);
+    assert(udp.calculate_checksum(src, dst, payload) == parallel_result);
+
+    checksum::set_parallel_threshold(saved_threshold);
+    checksum::set_parallel_threads(0);
+    std::cout << "  Odd offsets, concurrent callers and 5 MB jumbogram: OK\n\n";
+}
+
+void benchmark_kernels() {
+    std::cout << "Test 7: Kernel throughput (64 KB buffer)\n";
+
+    auto buffer = utils::random::random_bytes_seeded(65536, 1);
+    const int iterations = 2000;
+
+    for (auto kernel : all_kernels) {
+        if (!checksum::kernel_supported(kernel)) {
+            continue;
+        }
+
+        uint32_t sink = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            sink += checksum::partial_with(kernel, buffer.data(), buffer.size());
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        double gbps = (static_cast<double>(buffer.size()) * iterations) / seconds / 1e9;
+        std::cout << "  " << std::setw(7) << checksum::kernel_name(kernel) << ": "
+                  << std::fixed << std::setprecision(2) << gbps << " GB/s"
+                  << " (sink " << (sink & 0xF) << ")\n";
+    }
+
+    // Fused copy + sum against copy followed by a second pass
+    std::vector<uint8_t> destination(buffer.size());
+    uint32_t sink = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        std::memcpy(destination.data(), buffer.data(), buffer.size());
+        sink += checksum::partial(destination);
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sink += checksum::partial_copy(destination.data(), buffer.data(), buffer.size());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double bytes = static_cast<double>(buffer.size()) * iterations;
+    std::cout << "  memcpy + sum: " << std::fixed << std::setprecision(2)
+              << bytes / std::chrono::duration<double>(middle - start).count() / 1e9 << " GB/s\n"
+              << "  partial_copy: "
+              << bytes / std::chrono::duration<double>(end - middle).count() / 1e9 << " GB/s"
+              << " (sink " << (sink & 0xF) << ")\n";
+
+    // Single-threaded against the worker pool on a large buffer
+    auto large = utils::random::random_bytes_seeded(64 * 1024 * 1024, 31);
+    size_t saved_threshold = checksum::parallel_threshold();
+    for (size_t threshold : {size_t(0), saved_threshold}) {
+        checksum::set_parallel_threshold(threshold);
+        auto large_start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < 20; ++i) {
+            sink += checksum::partial(large);
+        }
+        auto large_end = std::chrono::high_resolution_clock::now();
+        std::cout << "  64 MB " << (threshold ? "parallel" : "single-threaded") << " ("
+                  << (threshold ? checksum::parallel_threads() : 1) << " threads): "
+                  << large.size() * 20.0 / std::chrono::duration<double>(large_end - large_start).count() / 1e9
+                  << " GB/s\n";
+    }
+    checksum::set_parallel_threshold(saved_threshold);
+
+    std::cout << "  Active kernel: " << checksum::kernel_name(checksum::active_kernel()) << "\n\n";
+}
+
+int main() {
+    std::cout << "=== Testing Checksum Engine ===\n\n";
+
+    test_kernels_match_reference();
+    test_chaining();
+    test_scatter_gather();
+    test_callers_use_engine();
+    test_fused_copy();
+    test_parallel();
+    benchmark_kernels();
+
+    std::cout << "=== Checksum Engine Tests Complete ===\n";
+    return 0;
+}
@@ -0,0 +1,309 @@
+#include "checksum.h"
+#include "packet_patch.h"
+#include "header_view.h"
+#include "utils.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+
+using namespace cppscapy;
+
+// Build IPv4 + UDP with a fully computed UDP checksum
+std::vector<uint8_t> make_udp_packet(const IPv4Address& src, const IPv4Address& dst,
+                                     const std::vector<uint8_t>& payload) {
+    UDPHeader udp(1234, 53, UDPHeader::SIZE + payload.size());
+    uint16_t udp_checksum = udp.calculate_checksum(src, dst, payload);
+
+    IPv4Header ip(src, dst, IPv4Header::PROTOCOL_UDP);
+    ip.length(IPv4Header::MIN_SIZE + UDPHeader::SIZE + payload.size()).id(0x1111);
+
+    auto packet = PacketBuilder().ipv4(ip).udp(udp).payload(payload).build();
+    packet[26] = (udp_checksum >> 8) & 0xFF;
+    packet[27] = udp_checksum & 0xFF;
+    return packet;
+}
+
+// Build IPv4 + TCP with a fully computed TCP checksum
+std::vector<uint8_t> make_tcp_packet(const IPv4Address& src, const IPv4Address& dst,
+                                     const std::vector<uint8_t>& payload) {
+    TCPHeader tcp(40000, 80);
+    tcp.seq_num(1000).flags(TCPHeader::FLAG_ACK);
+    auto tcp_bytes = tcp.to_bytes();
+    uint16_t tcp_checksum = utils::calculate_tcp_checksum(tcp_bytes, src, dst, payload);
+
+    IPv4Header ip(src, dst, IPv4Header::PROTOCOL_TCP);
+    ip.length(IPv4Header::MIN_SIZE + tcp_bytes.size() + payload.size());
+
+    auto packet = PacketBuilder().ipv4(ip).tcp(tcp).payload(payload).build();
+    packet[36] = (tcp_checksum >> 8) & 0xFF;
+    packet[37] = tcp_checksum & 0xFF;
+    return packet;
+}
+
+// Recompute the UDP checksum from scratch and compare with the stored one
+bool udp_checksum_valid(const std::vector<uint8_t>& packet) {
+    IPv4Address src(packet[12], packet[13], packet[14], packet[15]);
+    IPv4Address dst(packet[16], packet[17], packet[18], packet[19]);
+    UDPHeader udp((packet[20] << 8) | packet[21], (packet[22] << 8) | packet[23],
+                  (packet[24] << 8) | packet[25]);
+    std::vector<uint8_t> payload(packet.begin() + 28, packet.end());
+    uint16_t stored = (packet[26] << 8) | packet[27];
+    return udp.calculate_checksum(src, dst, payload) == stored;
+}
+
+bool tcp_checksum_valid(const std::vector<uint8_t>& packet) {
+    IPv4Address src(packet[12], packet[13], packet[14], packet[15]);
+    IPv4Address dst(packet[16], packet[17], packet[18], packet[19]);
+    std::vector<uint8_t> tcp_header(packet.begin() + 20, packet.begin() + 40);
+    std::vector<uint8_t> payload(packet.begin() + 40, packet.end());
+    uint16_t stored = (packet[36] << 8) | packet[37];
+    tcp_header[16] = 0;
+    tcp_header[17] = 0;
+    return utils::calculate_tcp_checksum(tcp_header, src, dst, payload) == stored;
+}
+
+void test_adjust_primitives() {
+    std::cout << "Test 1: checksum::adjust matches a full recompute\n";
+
+    auto data = utils::random::random_bytes_seeded(64, 3);
+    uint16_t original = checksum::compute(data);
+
+    // 16-bit word
+    uint16_t old_word = (data[10] << 8) | data[11];
+    data[10] = 0xAB;
+    data[11] = 0xCD;
+    assert(checksum::adjust(original, old_word, 0xABCD) == checksum::compute(data));
+
+    // 32-bit value
+    uint16_t before = checksum::compute(data);
+    uint32_t old_value = (static_cast<uint32_t>(data[20]) << 24) | (data[21] << 16) | (data[22] << 8) | data[23];
+    data[20] = 0xDE; data[21] = 0xAD; data[22] = 0xBE; data[23] = 0xEF;
+    assert(checksum::adjust32(before, old_value, 0xDEADBEEF) == checksum::compute(data));
+
+    // 128-bit address
+    before = checksum::compute(data);
+    std::array<uint8_t, 16> old_addr;
+    std::copy(data.begin() + 32, data.begin() + 48, old_addr.begin());
+    auto new_addr = IPv6Address("2001:db8::1").to_bytes();
+    std::copy(new_addr.begin(), new_addr.end(), data.begin() + 32);
+    assert(checksum::adjust128(before, old_addr, new_addr) == checksum::compute(data));
+
+    std::cout << "  16/32/128-bit adjustments: OK\n\n";
+}
+
+void test_ipv4_udp_patches() {
+    std::cout << "Test 2: IPv4 + UDP field patches\n";
+
+    auto packet = make_udp_packet(IPv4Address("192.168.1.10"), IPv4Address("10.0.0.1"),
+                                  utils::random::random_bytes_seeded(333, 5));
+    assert(utils::verify_ipv4_checksum(packet));
+    assert(udp_checksum_valid(packet));
+
+    patch::set_ipv4_ttl(packet.data(), 17);
+    patch::set_ipv4_id(packet.data(), 0xBEEF);
+    patch::set_ipv4_tos(packet.data(), 0x2E);
+    patch::set_ipv4_src(packet.data(), packet.size(), IPv4Address("172.16.5.4"));
+    patch::set_ipv4_dst(packet.data(), packet.size(), IPv4Address("8.8.8.8"));
+    patch::set_udp_src_port(packet.data() + 20, 5353);
+    patch::set_udp_dst_port(packet.data() + 20, 9999);
+
+    assert(packet[8] == 17);
+    assert(utils::verify_ipv4_checksum(packet));
+    assert(udp_checksum_valid(packet));
+
+    // A zero UDP checksum means "not computed" and must stay zero
+    packet[26] = 0;
+    packet[27] = 0;
+    patch::set_ipv4_src(packet.data(), packet.size(), IPv4Address("1.2.3.4"));
+    patch::set_udp_dst_port(packet.data() + 20, 53);
+    assert(packet[26] == 0 && packet[27] == 0);
+    assert(utils::verify_ipv4_checksum(packet));
+
+    std::cout << "  TTL, id, TOS, addresses and ports: OK\n\n";
+}
+
+void test_ipv4_tcp_patches() {
+    std::cout << "Test 3: IPv4 + TCP field patches\n";
+
+    auto packet = make_tcp_packet(IPv4Address("192.168.1.10"), IPv4Address("10.0.0.1"),
+                                  utils::random::random_bytes_seeded(101, 9));
+    assert(tcp_checksum_valid(packet));
+
+    patch::set_ipv4_dst(packet.data(), packet.size(), IPv4Address("203.0.113.7"));
+    patch::set_tcp_src_port(packet.data() + 20, 1);
+    patch::set_tcp_dst_port(packet.data() + 20, 443);
+    patch::set_tcp_seq_num(packet.data() + 20, 0xFFFFFFFF);
+    patch::set_tcp_ack_num(packet.data() + 20, 0x01020304);
+    patch::set_tcp_window_size(packet.data() + 20, 65535);
+
+    assert(utils::verify_ipv4_checksum(packet));
+    assert(tcp_checksum_valid(packet));
+
+    std::cout << "  Address, ports, seq, ack and window: OK\n\n";
+}
+
+void test_icmp_patches() {
+    std::cout << "Test 4: ICMP echo patches\n";
+
+    ICMPHeader icmp(ICMPHeader::TYPE_ECHO_REQUEST, 0);
+    icmp.identifier(1).sequence(1);
+    auto bytes = icmp.to_bytes();
+    uint16_t csum = checksum::compute(bytes);
+    bytes[2] = (csum >> 8) & 0xFF;
+    bytes[3] = csum & 0xFF;
+
+    for (uint16_t seq = 2; seq < 1000; ++seq) {
+        patch::set_icmp_sequence(bytes.data(), seq);
+    }
+    patch::set_icmp_identifier(bytes.data(), 0x4242);
+    assert(checksum::compute(bytes) == 0);
+
+    std::cout << "  Identifier and sequence: OK\n\n";
+}
+
+void test_ipv6_udp_zero_checksum() {
+    std::cout << "Test 5: IPv6 + UDP checksum that adjusts to zero\n";
+
+    IPv6Address src("2001:db8::10");
+    IPv6Address dst("2001:db8::20");
+    auto payload = utils::random::random_bytes_seeded(64, 11);
+    auto packet = PacketBuilder()
+                      .ipv6(IPv6Header(src, dst, IPv6Header::NEXT_HEADER_UDP)
+                                .payload_length(UDPHeader::SIZE + payload.size()))
+                      .udp(UDPHeader(1234, 53, UDPHeader::SIZE + payload.size()))
+                      .payload(payload)
+                      .build();
+    MutableUdpView udp(packet.data() + IPv6Header::SIZE, packet.size() - IPv6Header::SIZE);
+    udp.update_checksum(src, dst);
+
+    // Pick the last word of the new source so the adjusted checksum is 0x0000
+    auto new_bytes = src.to_bytes();
+    uint16_t old_word = (new_bytes[14] << 8) | new_bytes[15];
+    uint32_t word = 0;
+    while (word <= 0xFFFF && checksum::adjust(udp.checksum(), old_word, static_cast<uint16_t>(word)) != 0) {
+        ++word;
+    }
+    assert(word <= 0xFFFF);
+    new_bytes[14] = static_cast<uint8_t>(word >> 8);
+    new_bytes[15] = static_cast<uint8_t>(word);
+    IPv6Address new_src(new_bytes);
+
+    // Zero is not allowed over IPv6 (RFC 8200 section 8.1) and goes out as 0xFFFF
+    patch::set_ipv6_src(packet.data(), packet.size(), new_src);
+    assert(udp.checksum() == 0xFFFF);
+    assert(udp.checksum_valid(new_src, dst));
+
+    // The same through the mutable view
+    MutableIpv6View(packet.data(), packet.size()).src(src);
+    MutableIpv6View(packet.data(), packet.size()).src(new_src);
+    assert(udp.checksum() == 0xFFFF);
+
+    std::cout << "  Zero result stored as 0xFFFF: OK\n\n";
+}
+
+// IPv6 + the given extension headers + UDP, UDP checksum computed
+std::vector<uint8_t> make_ipv6_udp_packet(const IPv6Address& src, const IPv6Address& dst, uint8_t next_header,
+                                          const std::vector<uint8_t>& extensions,
+                                          const std::vector<uint8_t>& payload) {
+    UDPHeader udp(1234, 53, UDPHeader::SIZE + payload.size());
+    udp.update_checksum(src, dst, payload);
+    auto packet = IPv6Header(src, dst, next_header)
+                      .payload_length(extensions.size() + UDPHeader::SIZE + payload.size())
+                      .to_bytes();
+    packet.insert(packet.end(), extensions.begin(), extensions.end());
+    auto udp_bytes = udp.to_bytes();
+    packet.insert(packet.end(), udp_bytes.begin(), udp_bytes.end());
+    packet.insert(packet.end(), payload.begin(), payload.end());
+    return packet;
+}
+
+void test_ipv6_extension_headers() {
+    std::cout << "Test 6: IPv6 address patches behind extension headers\n";
+
+    IPv6Address src("2001:db8::10");
+    IPv6Address dst("2001:db8::20");
+    IPv6Address new_src("2001:db8:ffff::1");
+    IPv6Address new_dst("2001:db8:ffff::2");
+    auto payload = utils::random::random_bytes_seeded(40, 13);
+
+    // Hop-by-hop (8 bytes, PadN) -> destination options (16 bytes) -> first fragment -> UDP
+    std::vector<uint8_t> extensions = {
+        60, 0, 1, 4, 0, 0, 0, 0,
+        44, 1, 1, 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        17, 0, 0x00, 0x01, 0x12, 0x34, 0x56, 0x78
+    };
+    size_t udp_offset = IPv6Header::SIZE + extensions.size();
+    auto packet = make_ipv6_udp_packet(src, dst, 0, extensions, payload);
+    MutableUdpView udp(packet.data() + udp_offset, packet.size() - udp_offset);
+    assert(udp.checksum_valid(src, dst));
+
+    patch::set_ipv6_src(packet.data(), packet.size(), new_src);
+    patch::set_ipv6_dst(packet.data(), packet.size(), new_dst);
+    assert(udp.checksum_valid(new_src, new_dst));
+
+    // A non-first fragment has no transport header to fix
+    packet[IPv6Header::SIZE + 8 + 16 + 3] = 0x08;
+    uint16_t stored = udp.checksum();
+    patch::set_ipv6_src(packet.data(), packet.size(), src);
+    assert(udp.checksum() == stored);
+
+    // With segments left, the checksum covers the routing header's final
+    // destination: a new destination field leaves it alone, a new source
+    // does not
+    std::vector<uint8_t> routing = {
+        17, 2, 0, 1, 0, 0, 0, 0,
+        0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x20
+    };
+    packet = make_ipv6_udp_packet(src, dst, 43, routing, payload);
+    MutableUdpView routed(packet.data() + IPv6Header::SIZE + routing.size(),
+                          packet.size() - IPv6Header::SIZE - routing.size());
+    patch::set_ipv6_dst(packet.data(), packet.size(), new_dst);
+    assert(routed.checksum_valid(src, dst));
+    patch::set_ipv6_src(packet.data(), packet.size(), new_src);
+    assert(routed.checksum_valid(new_src, dst));
+
+    // A chain cut short by the length leaves the checksum as it was
+    packet = make_ipv6_udp_packet(src, dst, 0, extensions, payload);
+    stored = MutableUdpView(packet.data() + udp_offset, packet.size() - udp_offset).checksum();
+    patch::set_ipv6_src(packet.data(), IPv6Header::SIZE + 12, new_src);
+    assert(MutableUdpView(packet.data() + udp_offset, packet.size() - udp_offset).checksum() == stored);
+
+    std::cout << "  Hop-by-hop, destination options, fragment and routing headers: OK\n\n";
+}
+
+void test_tcp_timestamps_length() {
+    std::cout << "Test 7: TCP timestamp option length\n";
+
+    TCPHeader tcp(40000, 80);
+    tcp.flags(TCPHeader::FLAG_ACK).options(TCPOptions().nop().nop().timestamps(1, 2));
+    auto bytes = tcp.to_bytes();
+    assert(patch::set_tcp_timestamps(bytes.data(), 3, 4));
+
+    // A length byte other than 10 is not a timestamp option that can be rewritten
+    bytes[TCPHeader::MIN_SIZE + 3] = 6;
+    auto before = bytes;
+    bool threw = false;
+    try {
+        patch::set_tcp_timestamps(bytes.data(), 5, 6);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw && bytes == before);
+
+    std::cout << "  Malformed option rejected: OK\n\n";
+}
+
+int main() {
+    std::cout << "=== Testing Incremental Checksum Updates ===\n\n";
+
+    test_adjust_primitives();
+    test_ipv4_udp_patches();
+    test_ipv4_tcp_patches();
+    test_icmp_patches();
+    test_ipv6_udp_zero_checksum();
+    test_ipv6_extension_headers();
+    test_tcp_timestamps_length();
+
+    std::cout << "=== Incremental Checksum Tests Complete ===\n";
+    return 0;
+}
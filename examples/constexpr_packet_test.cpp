@@ -0,0 +1,116 @@
+#include "network_headers.h"
+#include "utils.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <cassert>
+
+using namespace cppscapy;
+
+// Everything below the static_asserts is evaluated by the compiler
+constexpr IPv4Address probe_src(10, 0, 0, 1);
+constexpr IPv4Address probe_dst(10, 0, 0, 2);
+constexpr auto probe_mac = utils::make_mac_address("001122334455");
+
+constexpr auto ping = patterns::icmp_ping_array(probe_src, probe_dst, 0x1234, 1);
+constexpr auto syn = patterns::tcp_syn_array(IPv4Address(192, 168, 1, 100), IPv4Address(192, 168, 1, 1),
+                                             40000, 80, 1000);
+constexpr std::array<uint8_t, 5> hello = {'h', 'e', 'l', 'l', 'o'};
+constexpr auto udp = patterns::udp_packet_array(probe_src, probe_dst, 5000, 53, hello);
+constexpr auto frame = patterns::ethernet_frame_array(probe_mac, MacAddress::broadcast(),
+                                                      EthernetHeader::ETHERTYPE_IPV4, ping);
+
+void test_addresses() {
+    std::cout << "Test 1: Addresses in constant expressions\n";
+
+    static_assert(same_bytes(IPv4Address(192, 168, 1, 1).to_bytes(), std::array<uint8_t, 4>{192, 168, 1, 1}));
+    static_assert(IPv4Address::localhost().to_bytes()[0] == 127);
+    static_assert(MacAddress::broadcast().is_broadcast());
+    static_assert(MacAddress::multicast_ipv4().is_multicast());
+    static_assert(!probe_mac.is_multicast());
+    static_assert(IPv6Address::localhost().to_bytes()[15] == 1);
+    static_assert(same_bytes(utils::make_ipv4_address("0a000001").to_bytes(), probe_src.to_bytes()));
+
+    // Same network-order value as the runtime parser
+    assert(IPv4Address("192.168.1.1").to_uint32() == IPv4Address(192, 168, 1, 1).to_uint32());
+    assert(IPv4Address(192, 168, 1, 1).to_string() == "192.168.1.1");
+
+    std::cout << "  OK\n\n";
+}
+
+void test_constant_frames() {
+    std::cout << "Test 2: Frames and checksums built at compile time\n";
+
+    static_assert(same_bytes(ping, utils::from_hex_string_auto("4500001c00000000400166df0a0000010a000002"
+                                                               "0800e5ca12340001")));
+    static_assert(same_bytes(syn, utils::from_hex_string_auto("45000028000000004006f71ac0a80164c0a80101"
+                                                              "9c400050000003e800000000500220006bb40000")));
+    static_assert(frame.size() == EthernetHeader::SIZE + ping.size());
+    static_assert(frame[12] == 0x08 && frame[13] == 0x00);
+
+    // IPv4 header sums to 0xFFFF including its checksum
+    constexpr auto ip_header = IPv4Header(probe_src, probe_dst, IPv4Header::PROTOCOL_UDP).ttl(1).to_array();
+    static_assert(checksum::partial(ip_header) == 0xFFFF);
+
+    std::cout << "  ICMP ping, TCP SYN, UDP and Ethernet frames: OK\n\n";
+}
+
+void test_matches_runtime() {
+    std::cout << "Test 3: Compile-time images match the runtime serializers\n";
+
+    auto runtime_ping = patterns::icmp_ping(probe_src, probe_dst, 0x1234, 1);
+    assert(std::equal(ping.begin(), ping.end(), runtime_ping.begin(), runtime_ping.end()));
+
+    auto runtime_udp = patterns::udp_packet(probe_src, probe_dst, 5000, 53,
+                                            std::vector<uint8_t>(hello.begin(), hello.end()));
+    assert(std::equal(udp.begin(), udp.end(), runtime_udp.begin(), runtime_udp.end()));
+
+    auto runtime_frame = patterns::ethernet_frame(probe_mac, MacAddress::broadcast(), EthernetHeader::ETHERTYPE_IPV4,
+                                                  runtime_ping);
+    assert(std::equal(frame.begin(), frame.end(), runtime_frame.begin(), runtime_frame.end()));
+
+    // Transport headers with a payload and the IPv6 pseudo-header
+    std::vector<uint8_t> payload(hello.begin(), hello.end());
+    TCPHeader tcp(1234, 80);
+    tcp.seq_num(7).flags(TCPHeader::FLAG_PSH | TCPHeader::FLAG_ACK);
+    auto tcp_v4 = tcp.to_array(probe_src, probe_dst, hello);
+    auto tcp_v4_runtime = tcp.to_bytes(probe_src, probe_dst, payload);
+    assert(std::equal(tcp_v4.begin(), tcp_v4.end(), tcp_v4_runtime.begin(), tcp_v4_runtime.end()));
+
+    IPv6Address src6 = IPv6Address::localhost();
+    IPv6Address dst6("2001:db8::1");
+    auto tcp_v6 = tcp.to_array(src6, dst6, hello);
+    auto tcp_v6_runtime = tcp.to_bytes(src6, dst6, payload);
+    assert(std::equal(tcp_v6.begin(), tcp_v6.end(), tcp_v6_runtime.begin(), tcp_v6_runtime.end()));
+
+    ICMPHeader echo6(ICMPHeader::TYPE_ECHO_REQUEST_V6, 0);
+    echo6.identifier(9).sequence(2);
+    auto icmp_v6 = echo6.to_array(src6, dst6, hello);
+    auto icmp_v6_runtime = echo6.to_bytes(src6, dst6, payload);
+    assert(std::equal(icmp_v6.begin(), icmp_v6.end(), icmp_v6_runtime.begin(), icmp_v6_runtime.end()));
+
+    UDPHeader udp6(5000, 53, UDPHeader::SIZE + hello.size());
+    auto udp_v6 = udp6.to_array(src6, dst6, hello);
+    assert(udp6.update_checksum(src6, dst6, payload).checksum() == ((udp_v6[6] << 8) | udp_v6[7]));
+
+    IPv6Header ip6(src6, dst6, IPv6Header::NEXT_HEADER_UDP);
+    ip6.traffic_class(0x2E).flow_label(0x12345).payload_length(13);
+    auto ip6_bytes = ip6.to_bytes();
+    auto ip6_array = ip6.to_array();
+    assert(std::equal(ip6_array.begin(), ip6_array.end(), ip6_bytes.begin(), ip6_bytes.end()));
+
+    MPLSHeader mpls(100, 5, false, 32);
+    assert(mpls.to_bytes() == std::vector<uint8_t>({0x00, 0x06, 0x4A, 0x20}));
+
+    std::cout << "  OK\n\n";
+}
+
+int main() {
+    std::cout << "=== Testing Constexpr Packet Construction ===\n\n";
+
+    test_addresses();
+    test_constant_frames();
+    test_matches_runtime();
+
+    std::cout << "=== Constexpr Packet Tests Complete ===\n";
+    return 0;
+}
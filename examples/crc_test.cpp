@@ -0,0 +1,311 @@
+#include "crc.h"
+#include "pcap_support.h"
+#include "utils.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+using namespace cppscapy;
+
+const crc::Kernel all_kernels[] = {
+    crc::Kernel::Software,
+    crc::Kernel::Hardware
+};
+
+const char* kernel_name(crc::Kernel kernel) {
+    return kernel == crc::Kernel::Hardware ? "hardware" : "software";
+}
+
+// Bit-at-a-time reference
+uint32_t reference_crc32c(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+uint32_t reference_crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+void test_crc32c_vectors() {
+    std::cout << "Test 1: CRC32c known answers (RFC 3720)\n";
+
+    std::vector<uint8_t> zeros(32, 0x00);
+    std::vector<uint8_t> ones(32, 0xFF);
+    std::vector<uint8_t> ascending(32);
+    for (size_t i = 0; i < ascending.size(); ++i) {
+        ascending[i] = static_cast<uint8_t>(i);
+    }
+    const char* digits = "123456789";
+
+    for (auto kernel : all_kernels) {
+        if (!crc::crc32c_supported(kernel)) {
+            std::cout << "  " << kernel_name(kernel) << ": not supported, skipped\n";
+            continue;
+        }
+        assert(crc::crc32c_with(kernel, zeros.data(), zeros.size()) == 0x8A9136AA);
+        assert(crc::crc32c_with(kernel, ones.data(), ones.size()) == 0x62A8AB43);
+        assert(crc::crc32c_with(kernel, ascending.data(), ascending.size()) == 0x46DD794E);
+        assert(crc::crc32c_with(kernel, reinterpret_cast<const uint8_t*>(digits), 9) == 0xE3069283);
+        std::cout << "  " << kernel_name(kernel) << ": OK\n";
+    }
+    std::cout << "\n";
+}
+
+void test_crc32c_kernels() {
+    std::cout << "Test 2: Kernels agree across lengths, alignments and chaining\n";
+
+    // Long enough to exercise both interleaved block sizes
+    auto buffer = utils::random::random_bytes_seeded(3 * 8192 * 2 + 3 * 256 + 100, 5);
+    for (auto kernel : all_kernels) {
+        if (!crc::crc32c_supported(kernel)) {
+            continue;
+        }
+        for (size_t offset = 0; offset < 8; ++offset) {
+            for (size_t length : {0, 1, 7, 8, 9, 255, 767, 768, 769, 3000, 24575, 24576, 24577, 50000}) {
+                const uint8_t* data = buffer.data() + offset;
+                assert(crc::crc32c_with(kernel, data, length) == reference_crc32c(data, length));
+            }
+        }
+    }
+
+    // Pieces chain to the CRC of the whole
+    uint32_t whole = crc::crc32c(buffer);
+    uint32_t piece = crc::crc32c(buffer.data(), 12345);
+    piece = crc::crc32c(buffer.data() + 12345, buffer.size() - 12345, piece);
+    assert(piece == whole);
+
+    std::cout << "  Active kernel: " << kernel_name(crc::crc32c_kernel()) << "\n\n";
+}
+
+// Ethernet + IPv4 + SCTP with one DATA chunk, checksum filled in place
+std::vector<uint8_t> make_sctp_frame(const std::vector<uint8_t>& user_data) {
+    std::vector<uint8_t> sctp = {
+        0x0B, 0x59, 0x0B, 0x59,  // ports 2905 -> 2905 (M3UA)
+        0xDE, 0xAD, 0xBE, 0xEF,  // verification tag
+        0x00, 0x00, 0x00, 0x00   // checksum
+    };
+    uint16_t chunk_length = static_cast<uint16_t>(16 + user_data.size());
+    std::vector<uint8_t> chunk = {
+        0x00, 0x03, static_cast<uint8_t>(chunk_length >> 8), static_cast<uint8_t>(chunk_length),
+        0x00, 0x00, 0x00, 0x01,  // TSN
+        0x00, 0x00, 0x00, 0x00,  // stream id / sequence
+        0x00, 0x00, 0x00, 0x03   // PPID (M3UA)
+    };
+    sctp.insert(sctp.end(), chunk.begin(), chunk.end());
+    sctp.insert(sctp.end(), user_data.begin(), user_data.end());
+    while (sctp.size() % 4) {
+        sctp.push_back(0);
+    }
+
+    uint32_t field = crc::sctp_checksum(sctp.data(), sctp.size());
+    sctp[8] = field >> 24;
+    sctp[9] = field >> 16;
+    sctp[10] = field >> 8;
+    sctp[11] = field;
+
+    IPv4Header ip(IPv4Address("10.0.0.1"), IPv4Address("10.0.0.2"), 132);
+    ip.length(IPv4Header::MIN_SIZE + sctp.size());
+    EthernetHeader eth(MacAddress("00:11:22:33:44:55"), MacAddress("66:77:88:99:aa:bb"),
+                       EthernetHeader::ETHERTYPE_IPV4);
+    return PacketBuilder().ethernet(eth).ipv4(ip).payload(sctp).build();
+}
+
+void test_sctp_decode() {
+    std::cout << "Test 3: SCTP checksum in the decoder\n";
+
+    auto frame = make_sctp_frame({'h', 'e', 'l', 'l', 'o'});
+    // Trailing bytes past the IPv4 total length (Ethernet padding) are not
+    // covered by the CRC
+    frame.insert(frame.end(), 6, 0);
+
+    auto decoded = pcap::utils::decode_packet(pcap::Packet(frame));
+    assert(!decoded.decode_error);
+    assert(decoded.is_sctp_packet());
+    assert(decoded.get_protocol_string() == "SCTP");
+    assert(decoded.get_src_port() == 2905);
+    assert(decoded.sctp_verification_tag == 0xDEADBEEF);
+    assert(decoded.sctp_checksum_valid);
+
+    frame[14 + 20 + 12 + 16] ^= 0x20; // Flip a bit of user data
+    decoded = pcap::utils::decode_packet(pcap::Packet(frame));
+    assert(decoded.is_sctp_packet());
+    assert(!decoded.sctp_checksum_valid);
+
+    std::cout << "  Valid and corrupted SCTP: OK\n\n";
+}
+
+void test_crc32() {
+    std::cout << "Test 4: IEEE CRC32 known answers and kernels\n";
+
+    const char* digits = "123456789";
+    const char* fox = "The quick brown fox jumps over the lazy dog";
+    auto buffer = utils::random::random_bytes_seeded(20000, 9);
+    for (auto kernel : all_kernels) {
+        if (!crc::crc32_supported(kernel)) {
+            std::cout << "  " << kernel_name(kernel) << ": not supported, skipped\n";
+            continue;
+        }
+        assert(crc::crc32_with(kernel, reinterpret_cast<const uint8_t*>(digits), 9) == 0xCBF43926);
+        assert(crc::crc32_with(kernel, reinterpret_cast<const uint8_t*>(fox), std::strlen(fox)) == 0x414FA339);
+        for (size_t offset = 0; offset < 8; ++offset) {
+            for (size_t length : {0, 1, 15, 16, 17, 63, 64, 65, 79, 80, 127, 128, 129, 1500, 9000, 19990}) {
+                const uint8_t* data = buffer.data() + offset;
+                assert(crc::crc32_with(kernel, data, length) == reference_crc32(data, length));
+            }
+        }
+        // Chaining from a non-zero CRC through the folding path
+        uint32_t piece = crc::crc32_with(kernel, buffer.data(), 100);
+        piece = crc::crc32_with(kernel, buffer.data() + 100, 5000, piece);
+        assert(piece == reference_crc32(buffer.data(), 5100));
+        std::cout << "  " << kernel_name(kernel) << ": OK\n";
+    }
+    std::cout << "  Active kernel: " << kernel_name(crc::crc32_kernel()) << "\n\n";
+}
+
+void test_fcs() {
+    std::cout << "Test 5: Ethernet FCS in the builder, pcap writer and decoder\n";
+
+    // Known frame: minimum-size broadcast, all-zero payload
+    std::vector<uint8_t> frame(60, 0);
+    std::fill(frame.begin(), frame.begin() + 6, 0xFF);
+    crc::append_fcs(frame);
+    assert(frame.size() == 64);
+    assert(crc::verify_fcs(frame));
+    // Residue of a frame followed by its FCS is the CRC32 magic constant
+    assert(crc::crc32(frame) == 0x2144DF1C);
+
+    // Short frames are padded to 60 bytes before the FCS
+    EthernetHeader eth(MacAddress("00:11:22:33:44:55"), MacAddress("66:77:88:99:aa:bb"),
+                       EthernetHeader::ETHERTYPE_IPV4);
+    UDPHeader udp(1000, 2000);
+    auto plain = PacketBuilder()
+        .ethernet(eth)
+        .ipv4(IPv4Header(IPv4Address("10.0.0.1"), IPv4Address("10.0.0.2"), IPv4Header::PROTOCOL_UDP))
+        .udp(udp)
+        .payload(std::string("hi"))
+        .build();
+    auto with_fcs = PacketBuilder()
+        .ethernet(eth)
+        .ipv4(IPv4Header(IPv4Address("10.0.0.1"), IPv4Address("10.0.0.2"), IPv4Header::PROTOCOL_UDP))
+        .udp(udp)
+        .payload(std::string("hi"))
+        .fcs()
+        .build();
+    assert(with_fcs.size() == EthernetHeader::MIN_FRAME_SIZE + EthernetHeader::FCS_SIZE);
+    assert(std::equal(plain.begin(), plain.end(), with_fcs.begin()));
+    assert(EthernetHeader::verify_fcs(with_fcs));
+
+    // Large frames are not padded
+    std::vector<uint8_t> jumbo(9000, 0xA5);
+    auto big = PacketBuilder().ethernet(eth).payload(jumbo).fcs().build();
+    assert(big.size() == EthernetHeader::SIZE + jumbo.size() + EthernetHeader::FCS_SIZE);
+    assert(crc::verify_fcs(big));
+
+    // Writer appends the FCS and flags it in the link type
+    const char* path = "crc_test_fcs.pcap";
+    {
+        pcap::PcapWriter writer(path);
+        writer.set_append_fcs();
+        bool ok = writer.open();
+        ok = ok && writer.write_packet(pcap::Packet(make_sctp_frame({'f', 'c', 's'})));
+        ok = ok && writer.write_packet(pcap::Packet(plain));
+        assert(ok);
+        (void)ok;
+    }
+    pcap::PcapReader reader(path);
+    bool opened = reader.open();
+    assert(opened);
+    (void)opened;
+    assert(reader.get_link_type() == pcap::LinkType::ETHERNET);
+    assert(reader.has_fcs());
+    assert(reader.fcs_length() == 4);
+
+    pcap::Packet packet;
+    bool read = reader.read_packet(packet);
+    assert(read);
+    auto decoded = pcap::utils::decode_packet(packet, reader.has_fcs());
+    assert(decoded.has_fcs && decoded.fcs_valid);
+    assert(decoded.sctp_checksum_valid);
+    assert(decoded.payload.size() == 16 + 4); // DATA chunk header + padded data
+
+    read = reader.read_packet(packet);
+    assert(read && packet.size() == 64);
+    (void)read;
+    decoded = pcap::utils::decode_packet(packet, reader.has_fcs());
+    assert(decoded.has_fcs && decoded.fcs_valid);
+    assert(decoded.is_udp_packet());
+
+    // A corrupted frame fails the FCS but still decodes
+    auto data = packet.data();
+    data[20] ^= 0x01;
+    decoded = pcap::utils::decode_packet(pcap::Packet(data), true);
+    assert(decoded.has_fcs && !decoded.fcs_valid);
+    assert(!decoded.decode_error);
+    reader.close();
+    std::remove(path);
+
+    std::cout << "  Builder, writer, reader and decoder: OK\n\n";
+}
+
+template <typename Fn>
+void benchmark(const char* name, bool (*supported)(crc::Kernel), Fn fn) {
+    auto buffer = utils::random::random_bytes_seeded(65536, 1);
+    const int iterations = 2000;
+    for (auto kernel : all_kernels) {
+        if (!supported(kernel)) {
+            continue;
+        }
+        uint32_t sink = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            sink += fn(kernel, buffer.data(), buffer.size());
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double gbps = static_cast<double>(buffer.size()) * iterations /
+                      std::chrono::duration<double>(end - start).count() / 1e9;
+        std::cout << "  " << name << " " << std::setw(8) << kernel_name(kernel) << ": " << std::fixed
+                  << std::setprecision(2) << gbps << " GB/s (sink " << (sink & 0xF) << ")\n";
+    }
+}
+
+void benchmark_crcs() {
+    std::cout << "Test 6: Throughput (64 KB buffer)\n";
+    benchmark("CRC32c", crc::crc32c_supported, [](crc::Kernel k, const uint8_t* d, size_t n) {
+        return crc::crc32c_with(k, d, n);
+    });
+    benchmark("CRC32 ", crc::crc32_supported, [](crc::Kernel k, const uint8_t* d, size_t n) {
+        return crc::crc32_with(k, d, n);
+    });
+    std::cout << "\n";
+}
+
+int main() {
+    std::cout << "=== Testing CRC Engines ===\n\n";
+
+    test_crc32c_vectors();
+    test_crc32c_kernels();
+    test_sctp_decode();
+    test_crc32();
+    test_fcs();
+    benchmark_crcs();
+
+    std::cout << "=== CRC Engine Tests Complete ===\n";
+    return 0;
+}
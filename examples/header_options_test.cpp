@@ -0,0 +1,198 @@
+#include "network_headers.h"
+#include "header_view.h"
+#include "packet_patch.h"
+#include "utils.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+
+using namespace cppscapy;
+
+constexpr IPv4Address src_ip(192, 168, 1, 10);
+constexpr IPv4Address dst_ip(192, 168, 1, 20);
+
+// The option layout of a Linux SYN
+constexpr TCPOptions syn_options(uint32_t tsval) {
+    return TCPOptions().mss(1460).sack_permitted().timestamps(tsval, 0).nop().window_scale(7);
+}
+
+// Options are formatted at compile time too
+static_assert(syn_options(1).size() == 20 && syn_options(1)[0] == TCPOptions::OPTION_MSS &&
+              syn_options(1).timestamp_offset() == 6 && syn_options(0x01020304).timestamp_value() == 0x01020304,
+              "constexpr TCP options");
+static_assert(IPv4Options().record_route(2).size() == 12 && IPv4Options().nop().size() == 4, "constexpr IPv4 options");
+static_assert(TCPHeader(1, 2).options(syn_options(1)).data_offset() == 10 &&
+              IPv4Header().options(IPv4Options().record_route()).ihl() == 15, "automatic ihl/data_offset");
+
+void test_tcp_options() {
+    std::cout << "Test 1: TCP options\n";
+
+    TCPHeader syn(40000, 80);
+    syn.seq_num(1000).flags(TCPHeader::FLAG_SYN).window_size(64240).options(syn_options(0x11223344));
+    assert(syn.data_offset() == 10 && syn.wire_size() == 40);
+
+    auto bytes = syn.to_bytes(src_ip, dst_ip);
+    auto expected = utils::from_hex_string("020405b4" "0402080a" "11223344" "00000000" "01030307");
+    assert(bytes.size() == 40 && std::equal(expected.begin(), expected.end(), bytes.begin() + 20));
+    assert(TcpView(bytes.data(), bytes.size()).checksum_valid(src_ip, dst_ip));
+    assert(TcpView(bytes.data(), bytes.size()).options().size() == 20);
+
+    // Compile-time and run-time checksums agree
+    auto fixed = syn.to_array(src_ip, dst_ip);
+    assert(std::equal(fixed.begin(), fixed.end(), bytes.begin()));
+
+    // Parsing keeps the options, including where the timestamp is
+    auto parsed = TCPHeader::parse(bytes.data(), bytes.size());
+    assert(parsed && parsed->options().size() == 20 && parsed->options().timestamp_value() == 0x11223344);
+    assert(parsed->to_bytes() == bytes);
+
+    // SACK blocks, NOP/EOL, padding with end-of-list
+    TCPOptions ack;
+    ack.nop().nop().sack({{100, 200}, {300, 400}});
+    assert(ack.size() == 20 && ack[2] == TCPOptions::OPTION_SACK && ack[3] == 18);
+    TCPOptions padded;
+    padded.window_scale(2);
+    assert(padded.size() == 4 && padded[3] == TCPOptions::OPTION_EOL);
+    padded.eol();
+    assert(padded.size() == 4);
+
+    // 40 bytes at most
+    TCPOptions full;
+    full.sack({{1, 2}, {3, 4}, {5, 6}, {7, 8}});
+    bool threw = false;
+    try {
+        full.timestamps(1, 2);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    assert(threw && full.size() == 36);
+
+    // The builder carries the options and completes the checksum over them
+    auto packet = PacketBuilder()
+                      .ipv4(IPv4Header(src_ip, dst_ip, IPv4Header::PROTOCOL_TCP).length(60))
+                      .tcp(syn)
+                      .build();
+    assert(packet.size() == 60 && std::equal(bytes.begin(), bytes.end(), packet.begin() + 20));
+
+    std::cout << "  OK\n\n";
+}
+
+void test_ipv4_options() {
+    std::cout << "Test 2: IPv4 options\n";
+
+    IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP);
+    ip.options(IPv4Options().nop().record_route(4));
+    assert(ip.ihl() == 10 && ip.wire_size() == 40);
+
+    uint8_t buffer[IPv4Header::MAX_SIZE];
+    assert(ip.write_to(buffer) == 40);
+    Ipv4View view(buffer, sizeof(buffer));
+    assert(view.header_length() == 40 && view.checksum_valid());
+    assert(view.options()[1] == IPv4Options::OPTION_RECORD_ROUTE && view.options()[2] == 19 && view.options()[3] == 4);
+
+    // Cached and fresh serializations cover the options alike
+    const IPv4Header& const_ip = ip;
+    ip.id(99);
+    uint8_t fresh[IPv4Header::MAX_SIZE];
+    const_ip.write_to(fresh);
+    ip.write_to(buffer);
+    assert(std::equal(buffer, buffer + 40, fresh) && view.checksum_valid());
+    assert(ip.to_bytes() == const_ip.to_bytes() && ip.to_bytes().size() == 40);
+
+    // A fixed-size buffer no longer fits; the span overload says so
+    std::array<uint8_t, IPv4Header::MIN_SIZE> fixed_part{};
+    assert(throws<std::length_error>([&] { ip.write_to(fixed_part); }));
+    assert(throws<std::length_error>([&] { const_ip.write_to(fixed_part); }));
+
+    auto parsed = IPv4Header::parse(buffer, 40);
+    assert(parsed && parsed->ihl() == 10 && parsed->to_bytes() == ip.to_bytes());
+
+    std::cout << "  OK\n\n";
+}
+
+void test_timestamp_updates() {
+    std::cout << "Test 3: Updating timestamps in place\n";
+
+    // In the header object: rewritten, not appended again
+    TCPHeader header(1234, 80);
+    header.options(syn_options(1));
+    header.timestamps(2, 3);
+    assert(header.data_offset() == 10 && header.options().timestamp_value() == 2 &&
+           header.options().timestamp_echo_reply() == 3);
+
+    // In a serialized segment, with the checksum adjusted; the option after
+    // the 3-byte window scale starts at an odd offset
+    std::vector<uint8_t> payload(100, 0x5A);
+    TCPHeader segment(1234, 80);
+    segment.flags(TCPHeader::FLAG_ACK).options(TCPOptions().window_scale(7).timestamps(5, 6));
+    auto bytes = segment.to_bytes(src_ip, dst_ip, payload);
+    bytes.insert(bytes.end(), payload.begin(), payload.end());
+    assert(patch::set_tcp_timestamps(bytes.data(), 0xDEADBEEF, 0x01020304));
+    TcpView view(bytes.data(), bytes.size());
+    assert(view.checksum_valid(src_ip, dst_ip));
+    assert(view.decode().options().timestamp_value() == 0xDEADBEEF);
+    assert(view.decode().options().timestamp_echo_reply() == 0x01020304);
+
+    MutableTcpView(bytes.data(), bytes.size()).timestamps(7, 8);
+    assert(view.checksum_valid(src_ip, dst_ip) && view.decode().options().timestamp_value() == 7);
+
+    // No timestamp option: nothing changes
+    auto plain = TCPHeader(1, 2).to_bytes(src_ip, dst_ip);
+    auto before = plain;
+    assert(!patch::set_tcp_timestamps(plain.data(), 1, 2) && plain == before);
+
+    std::cout << "  OK\n\n";
+}
+
+void benchmark_syn_flood() {
+    std::cout << "Test 4: Writing 1M TCP SYN headers with options\n";
+
+    constexpr size_t PACKETS = 1000000;
+    uint8_t out[TCPHeader::MAX_SIZE];
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t sink = 0;
+    for (size_t i = 0; i < PACKETS; ++i) {
+        TCPHeader syn(static_cast<uint16_t>(i), 80);
+        syn.seq_num(static_cast<uint32_t>(i)).flags(TCPHeader::FLAG_SYN).options(syn_options(static_cast<uint32_t>(i)));
+        syn.write_to(out, src_ip, dst_ip);
+        sink += out[16];
+    }
+    report("options rebuilt per packet", start, PACKETS, "packet", sink);
+
+    TCPHeader syn(0, 80);
+    syn.flags(TCPHeader::FLAG_SYN).options(syn_options(0));
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    for (size_t i = 0; i < PACKETS; ++i) {
+        syn.src_port(static_cast<uint16_t>(i)).seq_num(static_cast<uint32_t>(i)).timestamps(static_cast<uint32_t>(i), 0);
+        syn.write_to(out, src_ip, dst_ip);
+        sink += out[16];
+    }
+    report("preformatted, timestamps()", start, PACKETS, "packet", sink);
+
+    syn.write_to(out, src_ip, dst_ip);
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    for (size_t i = 0; i < PACKETS; ++i) {
+        patch::set_tcp_seq_num(out, static_cast<uint32_t>(i));
+        patch::set_tcp_timestamps(out, static_cast<uint32_t>(i), 0);
+        sink += out[16];
+    }
+    report("patched on the wire", start, PACKETS, "packet", sink);
+    assert(TcpView(out, syn.wire_size()).checksum_valid(src_ip, dst_ip));
+    std::cout << "\n";
+}
+
+int main() {
+    std::cout << "=== Testing Header Options ===\n\n";
+
+    test_tcp_options();
+    test_ipv4_options();
+    test_timestamp_updates();
+    benchmark_syn_flood();
+
+    std::cout << "=== Header Options Tests Complete ===\n";
+    return 0;
+}
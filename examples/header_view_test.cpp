@@ -0,0 +1,196 @@
+#include "header_view.h"
+#include "pcap_support.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+
+using namespace cppscapy;
+
+constexpr IPv4Address src_ip(192, 168, 1, 10);
+constexpr IPv4Address dst_ip(192, 168, 1, 20);
+
+// Views read constant wire images at compile time
+constexpr auto constant_syn = patterns::tcp_syn_array(src_ip, dst_ip, 40000, 80, 1000);
+static_assert(Ipv4View(constant_syn.data(), constant_syn.size()).protocol() == IPv4Header::PROTOCOL_TCP &&
+              TcpView(constant_syn.data() + 20, 20).seq_num() == 1000 &&
+              TcpView(constant_syn.data() + 20, 20).flags() == TCPHeader::FLAG_SYN, "constexpr views");
+static_assert(Ipv4View::parse(constant_syn.data(), 10).error() == ParseError::Truncated, "constexpr views");
+
+std::vector<uint8_t> tcp_frame(const std::vector<uint8_t>& payload) {
+    IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_TCP);
+    ip.id(0x1234).ttl(64).length(static_cast<uint16_t>(IPv4Header::MIN_SIZE + TCPHeader::MIN_SIZE + payload.size()));
+    TCPHeader tcp(40000, 443);
+    tcp.seq_num(7).ack_num(9).flags(TCPHeader::FLAG_ACK | TCPHeader::FLAG_PSH).window_size(1024);
+    return PacketBuilder()
+        .ethernet(EthernetHeader("00:11:22:33:44:55"_mac, "66:77:88:99:aa:bb"_mac, EthernetHeader::ETHERTYPE_IPV4))
+        .ipv4(ip)
+        .tcp(tcp)
+        .payload(payload)
+        .fcs()  // pads to the Ethernet minimum, which the views must not count
+        .build();
+}
+
+void test_read_views() {
+    std::cout << "Test 1: Reading fields through views\n";
+
+    std::vector<uint8_t> payload = {'h', 'i'};
+    auto frame = tcp_frame(payload);
+
+    auto eth = EthernetView::parse(frame.data(), frame.size());
+    assert(eth && eth->ethertype() == EthernetHeader::ETHERTYPE_IPV4);
+    assert(eth->src().to_string() == "66:77:88:99:aa:bb" && eth->dst().to_string() == "00:11:22:33:44:55");
+
+    auto ip = Ipv4View::parse(eth->payload().data(), eth->payload().size());
+    assert(ip && ip->version() == 4 && ip->header_length() == 20 && ip->id() == 0x1234 && ip->ttl() == 64);
+    assert(ip->src().to_uint32() == src_ip.to_uint32() && ip->dst().to_uint32() == dst_ip.to_uint32());
+    assert(ip->checksum_valid());
+    assert(ip->payload().size() == 22);  // FCS and padding excluded by the total length
+
+    auto tcp = TcpView::parse(ip->payload().data(), ip->payload().size());
+    assert(tcp && tcp->src_port() == 40000 && tcp->dst_port() == 443 && tcp->seq_num() == 7 && tcp->ack_num() == 9);
+    assert(tcp->flags() == (TCPHeader::FLAG_ACK | TCPHeader::FLAG_PSH) && tcp->window_size() == 1024);
+    assert(tcp->checksum_valid(ip->src(), ip->dst()));
+    assert(tcp->payload().size() == 2 && tcp->payload()[0] == 'h');
+
+    // decode() materializes the full header object
+    IPv4Header decoded = ip->decode();
+    assert(decoded.id() == 0x1234 && decoded.protocol() == IPv4Header::PROTOCOL_TCP);
+
+    // Validation mirrors the header parse() functions
+    uint8_t bad[40] = {0x45};
+    assert(Ipv4View::parse(bad, 19).error() == ParseError::Truncated);
+    bad[0] = 0x65;
+    assert(Ipv4View::parse(bad, 40).error() == ParseError::BadVersion);
+    assert(Ipv6View::parse(bad, 40));
+    bad[12] = 0x30;
+    assert(TcpView::parse(bad, 40).error() == ParseError::BadLength);
+    assert(!UdpView::parse(bad, 7) && !IcmpView::parse(bad, 7) && !MplsView::parse(bad, 3));
+
+    // Views over a pcap packet, without copying it
+    pcap::Packet packet(frame);
+    assert(packet.view<Ipv4View>(EthernetHeader::SIZE).dst().to_uint32() == dst_ip.to_uint32());
+    assert(packet.view<TcpView>(34).dst_port() == 443);
+
+    std::cout << "  OK\n\n";
+}
+
+void test_mutable_views() {
+    std::cout << "Test 2: Editing in place with checksum fix-up\n";
+
+    std::vector<uint8_t> payload(100, 0x42);
+    auto frame = tcp_frame(payload);
+    MutableIpv4View ip(frame.data() + EthernetHeader::SIZE, frame.size() - EthernetHeader::SIZE);
+    MutableTcpView tcp(ip.payload().data(), ip.payload().size());
+
+    ip.ttl(3).id(0xABCD).tos(0x10).src(IPv4Address(10, 1, 1, 1)).dst(IPv4Address(10, 2, 2, 2));
+    tcp.src_port(1).dst_port(2).seq_num(0xFFFFFFFF).ack_num(5).flags(TCPHeader::FLAG_RST).window_size(0);
+    assert(ip.ttl() == 3 && ip.id() == 0xABCD && ip.tos() == 0x10 && tcp.flags() == TCPHeader::FLAG_RST);
+    assert(ip.checksum_valid());
+    assert(tcp.checksum_valid(ip.src(), ip.dst()));
+
+    // Same bytes as building the edited packet from scratch
+    IPv4Header expected_ip(IPv4Address(10, 1, 1, 1), IPv4Address(10, 2, 2, 2), IPv4Header::PROTOCOL_TCP);
+    expected_ip.id(0xABCD).ttl(3).tos(0x10).length(static_cast<uint16_t>(40 + payload.size()));
+    TCPHeader expected_tcp(1, 2);
+    expected_tcp.seq_num(0xFFFFFFFF).ack_num(5).flags(TCPHeader::FLAG_RST).window_size(0);
+    auto expected = PacketBuilder().ipv4(expected_ip).tcp(expected_tcp).payload(payload).build();
+    assert(std::equal(expected.begin(), expected.end(), ip.data()));
+
+    // Payload edits followed by a full recompute
+    tcp.payload()[0] = 0x99;
+    assert(!tcp.checksum_valid(ip.src(), ip.dst()));
+    tcp.update_checksum(ip.src(), ip.dst());
+    assert(tcp.checksum_valid(ip.src(), ip.dst()));
+    ip.length(60);
+    assert(ip.checksum_valid() && ip.payload().size() == 40);
+    frame[EthernetHeader::SIZE + 10] ^= 0xFF;
+    assert(!ip.checksum_valid());
+    ip.update_checksum();
+    assert(ip.checksum_valid());
+
+    // UDP over IPv6
+    IPv6Address src6 = "2001:db8::1"_ipv6;
+    IPv6Address dst6 = "2001:db8::2"_ipv6;
+    std::vector<uint8_t> udp_payload = {1, 2, 3, 4, 5};
+    UDPHeader udp_header(5000, 53, static_cast<uint16_t>(UDPHeader::SIZE + udp_payload.size()));
+    auto packet6 = PacketBuilder()
+                       .ipv6(IPv6Header(src6, dst6, IPv6Header::NEXT_HEADER_UDP).payload_length(13))
+                       .udp(udp_header)
+                       .payload(udp_payload)
+                       .build();
+    MutableIpv6View ip6(packet6.data(), packet6.size());
+    MutableUdpView udp(ip6.payload().data(), ip6.payload().size());
+    assert(udp.checksum_valid(src6, dst6) && udp.payload().size() == 5);
+    ip6.src("fe80::1"_ipv6).hop_limit(1).traffic_class(0xAB).flow_label(0x12345);
+    udp.src_port(6000).dst_port(7000);
+    assert(ip6.hop_limit() == 1 && ip6.traffic_class() == 0xAB && ip6.flow_label() == 0x12345 && ip6.version() == 6);
+    assert(udp.checksum_valid(ip6.src(), ip6.dst()) && udp.src_port() == 6000);
+
+    // ICMP echo
+    ICMPHeader icmp_header(ICMPHeader::TYPE_ECHO_REQUEST, 0);
+    auto icmp_bytes = icmp_header.identifier(1).sequence(1).to_bytes(std::vector<uint8_t>(16, 7));
+    icmp_bytes.resize(24, 7);
+    MutableIcmpView icmp(icmp_bytes.data(), icmp_bytes.size());
+    assert(icmp.checksum_valid());
+    icmp.identifier(0xBEEF).sequence(2);
+    assert(icmp.checksum_valid() && icmp.identifier() == 0xBEEF && icmp.type() == ICMPHeader::TYPE_ECHO_REQUEST);
+
+    // MPLS and Ethernet have no checksum
+    auto mpls_bytes = MPLSHeader(100, 1, false, 64).to_bytes();
+    MutableMplsView mpls(mpls_bytes.data(), mpls_bytes.size());
+    mpls.label(0xFFFFF).traffic_class(5).bottom_of_stack(true).ttl(9);
+    assert(mpls.label() == 0xFFFFF && mpls.traffic_class() == 5 && mpls.bottom_of_stack() && mpls.ttl() == 9);
+    assert(mpls_bytes == MPLSHeader(0xFFFFF, 5, true, 9).to_bytes());
+    mpls.label(3);
+    assert(mpls.label() == 3 && mpls.traffic_class() == 5);
+
+    MutableEthernetView eth(frame.data(), frame.size());
+    eth.dst(MacAddress::broadcast()).ethertype(EthernetHeader::ETHERTYPE_IPV6);
+    assert(eth.dst().is_broadcast() && eth.ethertype() == EthernetHeader::ETHERTYPE_IPV6);
+
+    std::cout << "  OK\n\n";
+}
+
+void benchmark_views() {
+    std::cout << "Test 3: Reading src IP and dst port of 1M frames\n";
+
+    constexpr size_t FRAMES = 1000000;
+    std::vector<pcap::Packet> packets;
+    for (uint8_t i = 0; i < 8; ++i) {
+        packets.emplace_back(tcp_frame(std::vector<uint8_t>(512 + i, i)));
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t sink = 0;
+    for (size_t i = 0; i < FRAMES; ++i) {
+        dsl::IPv4Header ip;
+        dsl::TCPHeader tcp;
+        const auto& packet = packets[i % packets.size()];
+        packet.parse_header(ip, EthernetHeader::SIZE);
+        packet.parse_header(tcp, EthernetHeader::SIZE + 20);
+        sink += ip.src_ip() + tcp.dst_port();
+    }
+    report("Packet::parse_header (dsl)", start, FRAMES, "frame", sink);
+
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    for (size_t i = 0; i < FRAMES; ++i) {
+        auto ip = packets[i % packets.size()].view<Ipv4View>(EthernetHeader::SIZE);
+        TcpView tcp(ip.payload().data(), ip.payload().size());
+        sink += ip.src().to_uint32() + tcp.dst_port();
+    }
+    report("Ipv4View / TcpView", start, FRAMES, "frame", sink);
+    std::cout << "\n";
+}
+
+int main() {
+    std::cout << "=== Testing Header Views ===\n\n";
+
+    test_read_views();
+    test_mutable_views();
+    benchmark_views();
+
+    std::cout << "=== Header View Tests Complete ===\n";
+    return 0;
+}
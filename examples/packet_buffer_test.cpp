@@ -0,0 +1,280 @@
+#include "packet_buffer.h"
+#include "header_view.h"
+#include "allocation_counter.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+
+using namespace cppscapy;
+
+constexpr IPv4Address src_ip(10, 0, 0, 1);
+constexpr IPv4Address dst_ip(10, 0, 0, 2);
+constexpr MacAddress src_mac(0x00, 0x11, 0x22, 0x33, 0x44, 0x55);
+constexpr MacAddress dst_mac(0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb);
+
+void test_headroom_and_tailroom() {
+    std::cout << "Test 1: Headroom, tailroom, prepend, append, adjust and trim\n";
+
+    PacketBuffer buffer(64, 16);
+    assert(buffer.size() == 0 && buffer.headroom() == 16 && buffer.tailroom() == 48);
+
+    uint8_t* body = buffer.append(4);
+    body[0] = 1; body[1] = 2; body[2] = 3; body[3] = 4;
+    uint8_t* front = buffer.prepend(2);
+    front[0] = 0xAA; front[1] = 0xBB;
+    assert(front + 2 == body && buffer.data() == front);
+    assert(buffer.size() == 6 && buffer.headroom() == 14 && buffer.tailroom() == 44);
+    assert((buffer.to_bytes() == std::vector<uint8_t>{0xAA, 0xBB, 1, 2, 3, 4}));
+
+    buffer.adjust(2);
+    buffer.trim(1);
+    assert((buffer.to_bytes() == std::vector<uint8_t>{1, 2, 3}) && buffer.headroom() == 16);
+
+    // Headers are written straight into the free space
+    buffer.push(MPLSHeader(100));
+    buffer.put(UDPHeader(53, 53, 8));
+    assert(buffer.size() == 15 && MplsView(buffer.data(), 4).label() == 100);
+    assert(UdpView(buffer.data() + 7, 8).dst_port() == 53);
+
+    // Running out of room fails without changing anything
+    assert(throws<std::length_error>([&] { buffer.prepend(13); }));
+    assert(throws<std::length_error>([&] { buffer.append(45); }));
+    assert(throws<std::length_error>([&] { buffer.adjust(16); }));
+    assert(buffer.size() == 15 && buffer.headroom() == 12);
+    assert(throws<std::invalid_argument>([] { PacketBuffer(8, 9); }));
+
+    // Copies and whole packets get the room asked for
+    std::vector<uint8_t> frame = patterns::ethernet_frame(src_mac, dst_mac, EthernetHeader::ETHERTYPE_IPV4,
+                                                          std::vector<uint8_t>(46, 0x5A));
+    PacketBuffer copy(ByteSpan(frame), 32, 8);
+    assert(copy.to_bytes() == frame && copy.headroom() == 32 && copy.tailroom() == 8);
+
+    PacketBuilder builder;
+    builder.ethernet(EthernetHeader(dst_mac, src_mac, EthernetHeader::ETHERTYPE_IPV4))
+           .ipv4(IPv4Header(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP))
+           .udp(UDPHeader(1000, 2000))
+           .payload(std::vector<uint8_t>{1, 2, 3, 4})
+           .finalize();
+    buffer.reset(16);
+    buffer.put(builder);
+    assert(buffer.to_bytes() == builder.build() && buffer.headroom() == 16);
+
+    // Moving hands over the storage
+    PacketBuffer moved(std::move(buffer));
+    assert(moved.size() == builder.size() && buffer.size() == 0 && buffer.capacity() == 0);
+
+    std::cout << "  OK\n\n";
+}
+
+void test_chaining() {
+    std::cout << "Test 2: Segment chains\n";
+
+    std::vector<uint8_t> payload(5000);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    // Large payloads spill into new segments
+    PacketBuffer packet(256, 64);
+    packet.put(UDPHeader(1, 2, static_cast<uint16_t>(UDPHeader::SIZE + payload.size())));
+    packet.append_data(ByteSpan(payload), 2048);
+    assert(packet.segment_count() == 4 && packet.size() == 192 && packet.next()->size() == 2048);
+    assert(packet.total_size() == UDPHeader::SIZE + payload.size());
+    std::vector<uint8_t> flat = packet.to_bytes();
+    assert(std::equal(payload.begin(), payload.end(), flat.begin() + UDPHeader::SIZE));
+
+    // Headers still go in front of the first segment, trim() works on the last
+    packet.push(IPv4Header(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP));
+    packet.trim(4);
+    assert(packet.total_size() == IPv4Header::MIN_SIZE + UDPHeader::SIZE + payload.size() - 4);
+
+    uint8_t small[16];
+    assert(throws<std::length_error>([&] { packet.copy_to(MutableByteSpan(small)); }));
+
+    // Segments built elsewhere can be attached
+    PacketBuffer tail(ByteSpan(payload.data(), 10), 0);
+    packet.chain(std::move(tail));
+    assert(packet.segment_count() == 5 && packet.to_bytes().back() == payload[9]);
+
+    packet.reset();
+    assert(packet.segment_count() == 1 && packet.total_size() == 0);
+
+    // Long chains are freed without recursion
+    {
+        PacketBuffer head(0, 0);
+        std::vector<uint8_t> bytes(200000, 1);
+        head.append_data(ByteSpan(bytes), 1);
+        assert(head.segment_count() == 200001 && head.total_size() == 200000);
+    }
+
+    std::cout << "  OK\n\n";
+}
+
+void test_encapsulation() {
+    std::cout << "Test 3: VLAN, MPLS and VXLAN encapsulation in place\n";
+
+    std::vector<uint8_t> data(64, 0x42);
+    std::vector<uint8_t> inner = patterns::ethernet_frame(src_mac, dst_mac, EthernetHeader::ETHERTYPE_IPV4, data);
+    PacketBuffer frame(ByteSpan(inner), 128, 0);
+
+    // The first label matches the pattern, the second goes on top of it
+    encap::push_mpls(frame, MPLSHeader(100, 5, true, 33));
+    assert(frame.to_bytes() == patterns::mpls_ethernet_frame(src_mac, dst_mac, 100, 33, 5, data));
+    encap::push_mpls(frame, MPLSHeader(200));
+    auto expected = PacketBuilder()
+                        .ethernet(EthernetHeader(dst_mac, src_mac, EthernetHeader::ETHERTYPE_MPLS))
+                        .mpls(MPLSHeader(200, 0, false))
+                        .mpls(MPLSHeader(100, 5, true, 33))
+                        .payload(data)
+                        .build();
+    assert(frame.to_bytes() == expected);
+
+    MPLSHeader top = encap::pop_mpls(frame);
+    MPLSHeader bottom = encap::pop_mpls(frame);
+    assert(top.label() == 200 && bottom.label() == 100);
+    assert(frame.to_bytes() == inner && frame.headroom() == 128);
+    assert(throws<std::invalid_argument>([&] { encap::pop_mpls(frame); }));
+
+    // QinQ: tags are nested outside in, labels go after them
+    encap::push_vlan(frame, 10);
+    encap::push_vlan(frame, 20, 0x88A8);
+    encap::push_mpls(frame, MPLSHeader(300));
+    EthernetView eth(frame.data(), frame.size());
+    assert(std::equal(inner.begin(), inner.begin() + 12, frame.data()) && eth.ethertype() == 0x88A8);
+    assert(detail::load16(frame.data() + 14) == 20 && detail::load16(frame.data() + 16) == 0x8100);
+    assert(detail::load16(frame.data() + 18) == 10 && detail::load16(frame.data() + 20) == EthernetHeader::ETHERTYPE_MPLS);
+    assert(MplsView(frame.data() + 22, 4).label() == 300 && MplsView(frame.data() + 22, 4).bottom_of_stack());
+    encap::pop_mpls(frame);
+    uint16_t outer_tci = encap::pop_vlan(frame);
+    uint16_t inner_tci = encap::pop_vlan(frame);
+    assert(outer_tci == 20 && inner_tci == 10);
+    assert(frame.to_bytes() == inner);
+
+    // VXLAN: outer lengths and checksum cover the whole frame, chain included
+    frame.append_data(ByteSpan(data), 32);
+    size_t inner_size = frame.total_size();
+    IPv4Header outer_ip(IPv4Address(192, 168, 0, 1), IPv4Address(192, 168, 0, 2), 0);
+    outer_ip.ttl(16);
+    EthernetHeader outer_eth(MacAddress(2, 0, 0, 0, 0, 1), MacAddress(2, 0, 0, 0, 0, 2), 0);
+    encap::VxlanTunnel tunnel(outer_eth, outer_ip, 49152, 0xABCDEF);
+    encap::push_vxlan(frame, tunnel);
+    assert(tunnel.size() == 50 && frame.total_size() == inner_size + 50 && frame.headroom() == 78);
+    Ipv4View ip(frame.data() + 14, frame.size() - 14);
+    assert(EthernetView(frame.data(), 14).ethertype() == EthernetHeader::ETHERTYPE_IPV4);
+    assert(ip.checksum_valid() && ip.length() == inner_size + 36 && ip.protocol() == IPv4Header::PROTOCOL_UDP);
+    UdpView udp(frame.data() + 34, frame.size() - 34);
+    assert(udp.dst_port() == encap::VXLAN_PORT && udp.src_port() == 49152 && udp.length() == inner_size + 16);
+    uint32_t vni = encap::pop_vxlan(frame);
+    assert(vni == 0xABCDEF && frame.total_size() == inner_size);
+    assert(std::equal(inner.begin(), inner.end(), frame.data()));
+
+    // Outer IP options shift the UDP header
+    encap::VxlanTunnel alerted(outer_eth, outer_ip.options(IPv4Options().nop().nop().nop().eol()), 1, 7);
+    encap::push_vxlan(frame, alerted);
+    Ipv4View with_options(frame.data() + 14, frame.size() - 14);
+    assert(alerted.size() == 54 && with_options.checksum_valid() && with_options.length() == inner_size + 40);
+    assert(UdpView(frame.data() + 38, 8).length() == inner_size + 16);
+    vni = encap::pop_vxlan(frame);
+    assert(vni == 7);
+    assert(throws<std::invalid_argument>([&] { encap::VxlanTunnel(outer_eth, outer_ip, 1, 0x1000000); }));
+
+    // An IHL below five words would put the UDP header inside the IP
+    // header; the bytes there are made to look like VXLAN so only the IHL
+    // check catches it
+    PacketBuffer short_ihl(ByteSpan(inner), 128, 0);
+    encap::push_vxlan(short_ihl, tunnel);
+    uint8_t* short_ip = short_ihl.data() + EthernetHeader::SIZE;
+    short_ip[0] = 0x44;
+    detail::store16(short_ip + 18, encap::VXLAN_PORT);
+    short_ip[24] |= 0x08;
+    bool rejected = throws<std::invalid_argument>([&] { encap::pop_vxlan(short_ihl); });
+    assert(rejected && short_ihl.total_size() == inner.size() + tunnel.size());
+
+    // Short headroom is reported before anything is written
+    PacketBuffer tight(ByteSpan(inner), 40, 0);
+    assert(throws<std::length_error>([&] { encap::push_vxlan(tight, tunnel); }));
+    assert(tight.to_bytes() == inner && tight.headroom() == 40);
+    assert(throws<std::invalid_argument>([&] { encap::pop_vxlan(tight); }));
+
+    std::cout << "  OK\n\n";
+}
+
+void benchmark_encapsulation() {
+    std::cout << "Test 4: Pushing and popping headers on a 1500-byte frame, 1M times\n";
+
+    constexpr size_t ROUNDS = 1000000;
+    std::vector<uint8_t> inner = patterns::ethernet_frame(src_mac, dst_mac, EthernetHeader::ETHERTYPE_IPV4,
+                                                          std::vector<uint8_t>(1486, 0x42));
+    EthernetHeader outer_eth(MacAddress(2, 0, 0, 0, 0, 1), MacAddress(2, 0, 0, 0, 0, 2), 0);
+    IPv4Header outer_ip(IPv4Address(192, 168, 0, 1), IPv4Address(192, 168, 0, 2), 0);
+
+    // The vector way: every insert or erase near the front moves the frame
+    std::vector<uint8_t> vector_frame = inner;
+    vector_frame.reserve(inner.size() + 128);
+    auto label = MPLSHeader(100).to_array();
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t sink = 0;
+    for (size_t i = 0; i < ROUNDS; ++i) {
+        vector_frame[12] = 0x88;
+        vector_frame[13] = 0x47;
+        vector_frame.insert(vector_frame.begin() + 14, label.begin(), label.end());
+        sink += vector_frame[16];
+        vector_frame.erase(vector_frame.begin() + 14, vector_frame.begin() + 18);
+        vector_frame[12] = 0x08;
+        vector_frame[13] = 0x00;
+    }
+    report("MPLS label, vector insert/erase", start, ROUNDS, "round", sink);
+
+    PacketBuffer frame(ByteSpan(inner), 128, 0);
+    size_t buffer_allocations = allocations;
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    for (size_t i = 0; i < ROUNDS; ++i) {
+        encap::push_mpls(frame, MPLSHeader(100));
+        sink += frame.data()[16];
+        encap::pop_mpls(frame);
+    }
+    buffer_allocations = allocations - buffer_allocations;
+    report("MPLS label, PacketBuffer", start, ROUNDS, "round", sink);
+
+    // Both insert the same prebuilt headers; only the data movement differs
+    encap::VxlanTunnel tunnel(outer_eth, outer_ip, 49152, 42);
+    PacketBuffer scratch(ByteSpan(inner), 128, 0);
+    encap::push_vxlan(scratch, tunnel);
+    std::vector<uint8_t> outer(scratch.data(), scratch.data() + tunnel.size());
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    for (size_t i = 0; i < ROUNDS; ++i) {
+        vector_frame.insert(vector_frame.begin(), outer.begin(), outer.end());
+        sink += vector_frame[24];
+        vector_frame.erase(vector_frame.begin(), vector_frame.begin() + 50);
+    }
+    report("VXLAN outer, vector insert/erase", start, ROUNDS, "round", sink);
+
+    size_t before = allocations;
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    for (size_t i = 0; i < ROUNDS; ++i) {
+        encap::push_vxlan(frame, tunnel);
+        sink += frame.data()[24];
+        encap::pop_vxlan(frame);
+    }
+    buffer_allocations += allocations - before;
+    report("VXLAN outer, PacketBuffer", start, ROUNDS, "round", sink);
+    assert(buffer_allocations == 0 && frame.to_bytes() == inner && vector_frame == inner);
+    std::cout << "  PacketBuffer allocations: " << buffer_allocations << "\n\n";
+}
+
+int main() {
+    std::cout << "=== Testing Packet Buffers ===\n\n";
+
+    test_headroom_and_tailroom();
+    test_chaining();
+    test_encapsulation();
+    benchmark_encapsulation();
+
+    std::cout << "=== Packet Buffer Tests Complete ===\n";
+    return 0;
+}
@@ -0,0 +1,271 @@
+#include "network_headers.h"
+#include "header_view.h"
+#include "crc.h"
+#include "allocation_counter.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+
+using namespace cppscapy;
+
+constexpr IPv4Address src_ip(10, 0, 0, 1);
+constexpr IPv4Address dst_ip(10, 0, 0, 2);
+constexpr MacAddress src_mac(0x00, 0x11, 0x22, 0x33, 0x44, 0x55);
+constexpr MacAddress dst_mac(0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb);
+
+// Ethernet/IPv4/UDP with the UDP checksum left to the builder
+PacketBuilder& add_udp_frame(PacketBuilder& builder, uint16_t id, const std::vector<uint8_t>& payload) {
+    IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP);
+    ip.id(id).length(static_cast<uint16_t>(IPv4Header::MIN_SIZE + UDPHeader::SIZE + payload.size()));
+    return builder.ethernet(EthernetHeader(dst_mac, src_mac, EthernetHeader::ETHERTYPE_IPV4))
+        .ipv4(ip)
+        .udp(UDPHeader(5000, 53, static_cast<uint16_t>(UDPHeader::SIZE + payload.size())))
+        .payload(payload);
+}
+
+void test_build_variants() {
+    std::cout << "Test 1: build() variants produce the same bytes\n";
+
+    std::vector<uint8_t> payload = {1, 2, 3, 4, 5};
+    for (bool fcs : {false, true}) {
+        PacketBuilder builder;
+        add_udp_frame(builder, 7, payload).fcs(fcs);
+        auto copied = builder.build();
+        assert(copied.size() == builder.size());
+        assert(!fcs || (copied.size() == EthernetHeader::MIN_FRAME_SIZE + EthernetHeader::FCS_SIZE &&
+                        crc::verify_fcs(copied)));
+        UdpView udp(copied.data() + 34, UDPHeader::SIZE + payload.size());
+        assert(udp.checksum_valid(src_ip, dst_ip));
+
+        std::vector<uint8_t> into(3, 0xEE);
+        builder.build_into(into);
+        assert(into == copied);
+
+        uint8_t storage[128];
+        assert(builder.build_into(MutableByteSpan(storage)) == copied.size());
+        assert(std::equal(copied.begin(), copied.end(), storage));
+        bool threw = false;
+        try {
+            builder.build_into(MutableByteSpan(storage, copied.size() - 1));
+        } catch (const std::length_error&) {
+            threw = true;
+        }
+        assert(threw);
+
+        // Moving out leaves an empty, reusable builder
+        auto moved = std::move(builder).build();
+        assert(moved == copied && builder.size() == 0);
+        assert(builder.build().empty());
+        add_udp_frame(builder, 7, payload).fcs(fcs);
+        assert(builder.build() == copied);
+    }
+
+    // reset() forgets the headers and options (including fcs) but not the buffer
+    PacketBuilder builder;
+    add_udp_frame(builder, 1, std::vector<uint8_t>(1000, 0x42)).fcs();
+    builder.reset();
+    assert(builder.size() == 0);
+    builder.payload(std::vector<uint8_t>{9, 9});
+    assert(builder.build() == (std::vector<uint8_t>{9, 9}));
+
+    // Patterns move their result out
+    auto udp = patterns::udp_packet(src_ip, dst_ip, 1, 2, payload);
+    assert(udp.size() == 33 && Ipv4View(udp.data(), udp.size()).checksum_valid());
+    assert(UdpView(udp.data() + 20, 13).checksum_valid(src_ip, dst_ip));
+
+    std::cout << "  OK\n\n";
+}
+
+void test_no_allocations() {
+    std::cout << "Test 2: Reused builder and output do not allocate\n";
+
+    std::vector<uint8_t> payload(256, 0x11);
+    PacketBuilder builder;
+    std::vector<uint8_t> frame;
+    add_udp_frame(builder, 0, payload).fcs().build_into(frame);
+
+    size_t before = allocations;
+    for (uint16_t id = 1; id <= 1000; ++id) {
+        add_udp_frame(builder.reset(), id, payload).finalize().build_into(frame);
+    }
+    for (uint16_t id = 1; id <= 1000; ++id) {
+        add_udp_frame(builder.reset(), id, payload).fcs().build_into(frame);
+    }
+    assert(allocations == before);
+    assert(Ipv4View(frame.data() + 14, frame.size() - 14).id() == 1000 && crc::verify_fcs(frame));
+
+    // A single allocation for a moved-out packet with a reserve hint
+    before = allocations;
+    PacketBuilder sized;
+    sized.reserve(EthernetHeader::SIZE + 28 + payload.size());
+    auto packet = std::move(add_udp_frame(sized, 1, payload)).build();
+    assert(allocations - before == 1 && packet.size() == EthernetHeader::SIZE + 28 + payload.size());
+
+    std::cout << "  OK\n\n";
+}
+
+void test_finalize() {
+    std::cout << "Test 3: finalize() fixes lengths, checksums and MPLS stacks\n";
+
+    // Headers with no (or wrong) lengths come out as if set by hand
+    std::vector<uint8_t> payload = {1, 2, 3, 4, 5, 6, 7};
+    PacketBuilder manual;
+    auto expected = add_udp_frame(manual, 9, payload).build();
+    IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP);
+    ip.id(9).length(1);
+    const uint8_t stale_udp[] = {0x13, 0x88, 0x00, 0x35, 0x00, 0x01, 0x12, 0x34};
+    auto finalized = PacketBuilder()
+                         .ethernet(EthernetHeader(dst_mac, src_mac, EthernetHeader::ETHERTYPE_IPV4))
+                         .ipv4(ip)
+                         .udp(*UDPHeader::parse(stale_udp, sizeof(stale_udp)))
+                         .payload(payload)
+                         .finalize()
+                         .build();
+    assert(finalized == expected);
+
+    // VXLAN-style tunnel: the lengths and checksums of each layer cover the inner packet
+    auto tunnel = PacketBuilder()
+                      .ethernet(EthernetHeader(dst_mac, src_mac, EthernetHeader::ETHERTYPE_IPV4))
+                      .ipv4(IPv4Header(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP))
+                      .udp(UDPHeader(40000, 4789))
+                      .payload(std::vector<uint8_t>{0x08, 0, 0, 0, 0, 0, 0x2A, 0})
+                      .ethernet(EthernetHeader(dst_mac, src_mac, EthernetHeader::ETHERTYPE_IPV4))
+                      .ipv4(IPv4Header(IPv4Address(192, 168, 0, 1), IPv4Address(192, 168, 0, 2),
+                                       IPv4Header::PROTOCOL_TCP))
+                      .tcp(TCPHeader(1234, 80).flags(TCPHeader::FLAG_ACK).options(TCPOptions().timestamps(1, 2)))
+                      .payload(std::string("GET / HTTP/1.1\r\n\r\n"))
+                      .finalize()
+                      .build();
+    size_t inner = 14 + 20 + 8 + 8 + 14;
+    Ipv4View outer_ip(tunnel.data() + 14, tunnel.size() - 14);
+    Ipv4View inner_ip(tunnel.data() + inner, tunnel.size() - inner);
+    assert(outer_ip.checksum_valid() && outer_ip.length() == tunnel.size() - 14);
+    assert(inner_ip.checksum_valid() && inner_ip.length() == tunnel.size() - inner);
+    UdpView outer_udp(tunnel.data() + 34, tunnel.size() - 34);
+    assert(outer_udp.length() == tunnel.size() - 34 && outer_udp.checksum_valid(src_ip, dst_ip));
+    TcpView inner_tcp(tunnel.data() + inner + 20, tunnel.size() - inner - 20);
+    assert(inner_tcp.checksum_valid(inner_ip.src(), inner_ip.dst()));
+
+    // MPLS stack over IPv6: only the last label is bottom of stack
+    IPv6Address src6("2001:db8::1");
+    IPv6Address dst6("2001:db8::2");
+    auto labeled = PacketBuilder()
+                       .ethernet(EthernetHeader(dst_mac, src_mac, EthernetHeader::ETHERTYPE_MPLS))
+                       .mpls(MPLSHeader(100))
+                       .mpls(MPLSHeader(200))
+                       .mpls(MPLSHeader(300, 0, false))
+                       .ipv6(IPv6Header(src6, dst6, IPv6Header::NEXT_HEADER_UDP))
+                       .udp(UDPHeader(1, 2))
+                       .payload(payload)
+                       .finalize()
+                       .build();
+    assert(!MplsView(labeled.data() + 14, 4).bottom_of_stack());
+    assert(!MplsView(labeled.data() + 18, 4).bottom_of_stack());
+    assert(MplsView(labeled.data() + 22, 4).bottom_of_stack());
+    Ipv6View ip6(labeled.data() + 26, labeled.size() - 26);
+    assert(ip6.payload_length() == UDPHeader::SIZE + payload.size());
+    assert(UdpView(labeled.data() + 66, labeled.size() - 66).checksum_valid(src6, dst6));
+
+    // ICMPv6 takes the pseudo-header, ICMPv4 needs no IP header
+    auto echo6 = PacketBuilder()
+                     .ipv6(IPv6Header(src6, dst6, IPv6Header::NEXT_HEADER_ICMPV6))
+                     .icmp(ICMPHeader(ICMPHeader::TYPE_ECHO_REQUEST_V6, 0))
+                     .payload(payload)
+                     .finalize()
+                     .build();
+    assert(IcmpView(echo6.data() + 40, echo6.size() - 40).checksum_valid(src6, dst6));
+    auto echo = PacketBuilder().icmp(ICMPHeader(ICMPHeader::TYPE_ECHO_REQUEST, 0)).payload(payload).finalize().build();
+    assert(IcmpView(echo.data(), echo.size()).checksum_valid());
+
+    // The FCS is taken after finalizing
+    PacketBuilder padded;
+    add_udp_frame(padded, 9, payload).finalize().fcs();
+    assert(crc::verify_fcs(padded.build()));
+
+    // Layers are recorded in fixed storage
+    PacketBuilder deep;
+    for (size_t i = 0; i <= PacketBuilder::MAX_LAYERS; ++i) {
+        deep.mpls(MPLSHeader(static_cast<uint32_t>(i)));
+    }
+    bool threw = false;
+    try {
+        deep.finalize().build();
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    assert(threw && !deep.finalize(false).build().empty());
+
+    std::cout << "  OK\n\n";
+}
+
+void benchmark_builders() {
+    std::cout << "Test 4: Building 1M Ethernet/IPv4/UDP frames\n";
+
+    constexpr size_t FRAMES = 1000000;
+    std::vector<uint8_t> payload(64, 0xA5);
+    size_t before = allocations;
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t sink = 0;
+    for (size_t i = 0; i < FRAMES; ++i) {
+        PacketBuilder builder;
+        auto frame = add_udp_frame(builder, static_cast<uint16_t>(i), payload).build();
+        sink += frame[24];
+    }
+    report("new builder, build()", start, FRAMES, "frame", allocations - before, sink);
+
+    before = allocations;
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    for (size_t i = 0; i < FRAMES; ++i) {
+        PacketBuilder builder;
+        builder.reserve(EthernetHeader::SIZE + 28 + payload.size());
+        auto frame = std::move(add_udp_frame(builder, static_cast<uint16_t>(i), payload)).build();
+        sink += frame[24];
+    }
+    report("reserve, build() &&", start, FRAMES, "frame", allocations - before, sink);
+
+    before = allocations;
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    PacketBuilder builder;
+    std::vector<uint8_t> frame;
+    for (size_t i = 0; i < FRAMES; ++i) {
+        add_udp_frame(builder.reset(), static_cast<uint16_t>(i), payload).build_into(frame);
+        sink += frame[24];
+    }
+    report("reset(), build_into(vector)", start, FRAMES, "frame", allocations - before, sink);
+
+    // Lengths and the IPv4 checksum left to finalize(), no header sizes known
+    before = allocations;
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    for (size_t i = 0; i < FRAMES; ++i) {
+        IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP);
+        ip.id(static_cast<uint16_t>(i));
+        builder.reset()
+            .ethernet(EthernetHeader(dst_mac, src_mac, EthernetHeader::ETHERTYPE_IPV4))
+            .ipv4(ip)
+            .udp(UDPHeader(5000, 53))
+            .payload(payload)
+            .finalize()
+            .build_into(frame);
+        sink += frame[24];
+    }
+    report("reset(), finalize()", start, FRAMES, "frame", allocations - before, sink);
+    assert(Ipv4View(frame.data() + 14, frame.size() - 14).checksum_valid());
+    std::cout << "\n";
+}
+
+int main() {
+    std::cout << "=== Testing PacketBuilder Buffers ===\n\n";
+
+    test_build_variants();
+    test_no_allocations();
+    test_finalize();
+    benchmark_builders();
+
+    std::cout << "=== PacketBuilder Buffer Tests Complete ===\n";
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "packet_stack.h"
+#include "header_view.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+
+using namespace cppscapy;
+
+constexpr IPv4Address src_ip(10, 0, 0, 1);
+constexpr IPv4Address dst_ip(10, 0, 0, 2);
+constexpr MacAddress src_mac(0x00, 0x11, 0x22, 0x33, 0x44, 0x55);
+constexpr MacAddress dst_mac(0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb);
+
+constexpr auto dns_probe = EthernetHeader(dst_mac, src_mac, EthernetHeader::ETHERTYPE_IPV4)
+                         / IPv4Header(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP)
+                         / UDPHeader(4000, 53)
+                         / Payload<4>({1, 2, 3, 4});
+
+// Layout and bytes are known at compile time
+using DnsProbe = std::remove_const_t<decltype(dns_probe)>;
+static_assert(std::is_same_v<DnsProbe, Stack<EthernetHeader, IPv4Header, UDPHeader, Payload<4>>>, "/ builds a Stack");
+static_assert(DnsProbe::SIZE == 46 && DnsProbe::offset(1) == 14 && DnsProbe::offset(2) == 34 &&
+              DnsProbe::offset(3) == 42, "compile-time offsets");
+static_assert(same_bytes(Stack<IPv4Header, UDPHeader, Payload<4>>(dns_probe.get<1>(), dns_probe.get<2>(),
+                                                                  dns_probe.get<3>()).to_array(),
+                         patterns::udp_packet_array(src_ip, dst_ip, 4000, 53, std::array<uint8_t, 4>{1, 2, 3, 4})),
+              "same bytes as the hand-written constexpr pattern");
+static_assert(dns_probe.to_array()[16] == 0 && dns_probe.to_array()[17] == 32, "IPv4 total length filled in");
+
+// Layering rules; Stack<EthernetHeader, TCPHeader> fails to compile
+static_assert(!carries<EthernetHeader, TCPHeader>::value && !carries<UDPHeader, IPv4Header>::value &&
+              !carries<Payload<4>, UDPHeader>::value && carries<IPv6Header, ICMPHeader>::value,
+              "layering rules");
+
+void test_matches_builder() {
+    std::cout << "Test 1: Stacks serialize like PacketBuilder::finalize()\n";
+
+    std::vector<uint8_t> data = {0xDE, 0xAD, 0xBE, 0xEF, 0x01};
+    Payload<5> payload({0xDE, 0xAD, 0xBE, 0xEF, 0x01});
+    IPv6Address src6("2001:db8::1");
+    IPv6Address dst6("2001:db8::2");
+
+    // Ethernet/IPv4/UDP
+    EthernetHeader eth(dst_mac, src_mac, EthernetHeader::ETHERTYPE_IPV4);
+    IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP);
+    ip.id(77).ttl(3);
+    UDPHeader udp(1024, 2048);
+    auto udp_stack = eth / ip / udp / payload;
+    auto expected = PacketBuilder().ethernet(eth).ipv4(ip).udp(udp).payload(data).finalize().build();
+    assert(udp_stack.to_bytes() == expected);
+
+    // MPLS labels over IPv6/TCP: S bits, payload length, pseudo-header
+    TCPHeader tcp(443, 50000);
+    tcp.flags(TCPHeader::FLAG_ACK | TCPHeader::FLAG_PSH).seq_num(7).ack_num(9);
+    IPv6Header ip6(src6, dst6, IPv6Header::NEXT_HEADER_TCP);
+    auto labeled = EthernetHeader(dst_mac, src_mac, EthernetHeader::ETHERTYPE_MPLS)
+                 / MPLSHeader(100) / MPLSHeader(200) / ip6 / tcp / payload;
+    expected = PacketBuilder()
+                   .ethernet(EthernetHeader(dst_mac, src_mac, EthernetHeader::ETHERTYPE_MPLS))
+                   .mpls(MPLSHeader(100))
+                   .mpls(MPLSHeader(200))
+                   .ipv6(ip6)
+                   .tcp(tcp)
+                   .payload(data)
+                   .finalize()
+                   .build();
+    assert(labeled.to_bytes() == expected);
+    assert(!MplsView(expected.data() + 14, 4).bottom_of_stack() && MplsView(expected.data() + 18, 4).bottom_of_stack());
+
+    // IPv4 in IPv6 and ICMPv6: inner layers are finished before outer ones
+    auto tunnel = IPv6Header(src6, dst6, 4) / IPv4Header(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP) / udp / payload;
+    std::array<uint8_t, decltype(tunnel)::SIZE> out{};
+    assert(tunnel.write_to(out.data()) == out.size());
+    Ipv4View inner(out.data() + 40, out.size() - 40);
+    assert(inner.checksum_valid() && inner.length() == out.size() - 40);
+    assert(UdpView(out.data() + 60, out.size() - 60).checksum_valid(src_ip, dst_ip));
+    auto echo6 = Stack(ip6.next_header(IPv6Header::NEXT_HEADER_ICMPV6),
+                       ICMPHeader(ICMPHeader::TYPE_ECHO_REQUEST_V6, 0), payload).to_bytes();
+    assert(IcmpView(echo6.data() + 40, echo6.size() - 40).checksum_valid(src6, dst6));
+
+    // Caller buffers are checked; options do not fit a fixed layout
+    uint8_t small[40];
+    bool threw = false;
+    try {
+        udp_stack.write_to(MutableByteSpan(small));
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    assert(threw);
+    threw = false;
+    try {
+        (ip6 / TCPHeader(1, 2).options(TCPOptions().mss(1460))).to_array();
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Layers stay editable
+    udp_stack.get<2>().src_port(9999);
+    auto edited = udp_stack.to_bytes();
+    assert(UdpView(edited.data() + 34, edited.size() - 34).src_port() == 9999);
+    assert(UdpView(edited.data() + 34, edited.size() - 34).checksum_valid(src_ip, dst_ip));
+
+    std::cout << "  OK\n\n";
+}
+
+void benchmark_stacks() {
+    std::cout << "Test 2: Writing 1M Ethernet/IPv4/UDP frames with a 32-byte payload\n";
+
+    constexpr size_t FRAMES = 1000000;
+    Payload<32> payload;
+    for (size_t i = 0; i < payload.wire_size(); ++i) {
+        payload[i] = static_cast<uint8_t>(i);
+    }
+    std::vector<uint8_t> data(payload.bytes().begin(), payload.bytes().end());
+    EthernetHeader eth(dst_mac, src_mac, EthernetHeader::ETHERTYPE_IPV4);
+    uint8_t frame[128];
+
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t sink = 0;
+    PacketBuilder builder;
+    for (size_t i = 0; i < FRAMES; ++i) {
+        IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP);
+        ip.id(static_cast<uint16_t>(i));
+        builder.reset().ethernet(eth).ipv4(ip).udp(UDPHeader(static_cast<uint16_t>(i % 4096), 53))
+            .payload(data).finalize().build_into(MutableByteSpan(frame));
+        sink += frame[40];
+    }
+    report("PacketBuilder::finalize()", start, FRAMES, "frame", sink);
+
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    for (size_t i = 0; i < FRAMES; ++i) {
+        IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP);
+        ip.id(static_cast<uint16_t>(i));
+        (eth / ip / UDPHeader(static_cast<uint16_t>(i % 4096), 53) / payload).write_to(frame);
+        sink += frame[40];
+    }
+    report("Stack::write_to()", start, FRAMES, "frame", sink);
+    assert(UdpView(frame + 34, 40).checksum_valid(src_ip, dst_ip));
+    std::cout << "\n";
+}
+
+int main() {
+    std::cout << "=== Testing Packet Stacks ===\n\n";
+
+    test_matches_builder();
+    benchmark_stacks();
+
+    std::cout << "=== Packet Stack Tests Complete ===\n";
+    return 0;
+}
@@ -0,0 +1,272 @@
+#include "packet_template.h"
+#include "header_view.h"
+#include "crc.h"
+#include "allocation_counter.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+
+using namespace cppscapy;
+
+constexpr IPv4Address src_ip(10, 0, 0, 1);
+constexpr IPv4Address dst_ip(10, 0, 0, 2);
+constexpr MacAddress src_mac(0x00, 0x11, 0x22, 0x33, 0x44, 0x55);
+constexpr MacAddress dst_mac(0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb);
+
+using Field = PacketTemplate::Field;
+
+void test_generators() {
+    std::cout << "Test 1: Field generators\n";
+
+    auto sequence = FieldGenerator::sequence(10, 5);
+    assert(sequence.next() == 10 && sequence.next() == 15 && sequence.next() == 20);
+
+    auto list = FieldGenerator::list({7, 8});
+    assert(list.next() == 7 && list.next() == 8 && list.next() == 7);
+
+    auto range = FieldGenerator::range(3, 5);
+    assert(range.next() == 3 && range.next() == 4 && range.next() == 5 && range.next() == 3);
+
+    // Bounded and repeatable
+    auto random = FieldGenerator::random(100, 199, 42);
+    auto again = FieldGenerator::random(100, 199, 42);
+    bool seen_low = false;
+    bool seen_high = false;
+    for (int i = 0; i < 10000; ++i) {
+        uint64_t value = random.next();
+        assert(value >= 100 && value <= 199 && value == again.next());
+        seen_low |= value < 110;
+        seen_high |= value > 189;
+    }
+    assert(seen_low && seen_high);
+
+    bool threw = false;
+    try {
+        FieldGenerator::range(5, 4);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "  OK\n\n";
+}
+
+void test_stamps_match_builds() {
+    std::cout << "Test 2: Stamped packets match packets built from scratch\n";
+
+    std::vector<uint8_t> payload(37, 0x5A);
+    EthernetHeader eth(dst_mac, src_mac, EthernetHeader::ETHERTYPE_IPV4);
+    PacketTemplate udp(PacketBuilder()
+                           .ethernet(eth)
+                           .ipv4(IPv4Header(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP))
+                           .udp(UDPHeader(1000, 53))
+                           .payload(payload));
+    udp.set(Field::SRC_PORT, FieldGenerator::range(1024, 1030))
+        .set(Field::IPV4_DST, FieldGenerator::list({0x0A000002, 0xC0A80001, 0xFFFFFFFF}))
+        .set(Field::IP_ID, FieldGenerator::sequence(0xFFF0))
+        .set_payload(3, 3, FieldGenerator::random(0, 0xFFFFFF, 7))  // odd offset, odd width
+        .set_payload(10, 8, FieldGenerator::sequence(0xFFFFFFFFFFFFFFF0ull));
+
+    auto ports = FieldGenerator::range(1024, 1030);
+    auto destinations = FieldGenerator::list({0x0A000002, 0xC0A80001, 0xFFFFFFFF});
+    auto ids = FieldGenerator::sequence(0xFFF0);
+    auto tags = FieldGenerator::random(0, 0xFFFFFF, 7);
+    auto counters = FieldGenerator::sequence(0xFFFFFFFFFFFFFFF0ull);
+
+    std::vector<uint8_t> stamped;
+    for (int i = 0; i < 1000; ++i) {
+        udp.stamp_into(stamped);
+
+        IPv4Header ip(src_ip, IPv4Address(detail::network_order32(static_cast<uint32_t>(destinations.next()))),
+                      IPv4Header::PROTOCOL_UDP);
+        ip.id(static_cast<uint16_t>(ids.next()));
+        uint64_t tag = tags.next();
+        uint64_t counter = counters.next();
+        std::vector<uint8_t> data = payload;
+        for (int b = 0; b < 3; ++b) {
+            data[3 + b] = static_cast<uint8_t>(tag >> (8 * (2 - b)));
+        }
+        for (int b = 0; b < 8; ++b) {
+            data[10 + b] = static_cast<uint8_t>(counter >> (8 * (7 - b)));
+        }
+        auto expected = PacketBuilder()
+                            .ethernet(eth)
+                            .ipv4(ip)
+                            .udp(UDPHeader(static_cast<uint16_t>(ports.next()), 53))
+                            .payload(data)
+                            .finalize()
+                            .build();
+        assert(stamped == expected);
+    }
+
+    std::cout << "  OK\n\n";
+}
+
+void test_vlan_ipv6_tunnel() {
+    std::cout << "Test 3: VLAN tags, IPv6/TCP, tunnels and FCS\n";
+
+    // The 802.1Q tag is written as raw bytes between Ethernet and IPv6
+    IPv6Address src6("2001:db8::1");
+    IPv6Address dst6("2001:db8::2");
+    std::vector<uint8_t> tag = {0xA0, 0x64, 0x86, 0xDD};  // PCP 5, VLAN 100, IPv6
+    TCPHeader tcp(443, 50000);
+    tcp.flags(TCPHeader::FLAG_ACK).options(TCPOptions().timestamps(1, 2));
+    PacketTemplate tagged(PacketBuilder()
+                              .ethernet(EthernetHeader(dst_mac, src_mac, 0x8100))
+                              .payload(tag)
+                              .ipv6(IPv6Header(src6, dst6, IPv6Header::NEXT_HEADER_TCP))
+                              .tcp(tcp)
+                              .payload(std::string("hello"))
+                              .fcs());
+    tagged.set(Field::VLAN_ID, FieldGenerator::sequence(4094))
+        .set(Field::IPV6_SRC, FieldGenerator::random(0, ~uint64_t(0), 3))
+        .set(Field::TCP_SEQ, FieldGenerator::sequence(0xFFFFFFFE, 1000));
+    assert(tagged.size() == 14 + 4 + 40 + 32 + 5 + EthernetHeader::FCS_SIZE);
+
+    std::vector<uint8_t> frame;
+    for (int i = 0; i < 100; ++i) {
+        tagged.stamp_into(frame);
+        uint16_t tci = detail::load16(frame.data() + 14);
+        assert((tci >> 12) == 0xA && (tci & 0x0FFF) == ((4094 + i) & 0x0FFF));
+        Ipv6View ip(frame.data() + 18, frame.size() - 18);
+        TcpView segment(frame.data() + 58, ip.payload_length());
+        assert(segment.checksum_valid(ip.src(), ip.dst()) && crc::verify_fcs(frame));
+        assert(segment.seq_num() == static_cast<uint32_t>(0xFFFFFFFEull + 1000ull * i));
+    }
+
+    // Changing the inner source also fixes the outer UDP checksum over it
+    PacketTemplate tunnel(PacketBuilder()
+                              .ipv4(IPv4Header(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP))
+                              .udp(UDPHeader(40000, 4789))
+                              .ipv4(IPv4Header(IPv4Address(192, 168, 0, 1), IPv4Address(192, 168, 0, 2),
+                                               IPv4Header::PROTOCOL_UDP))
+                              .udp(UDPHeader(1, 2))
+                              .payload(std::vector<uint8_t>(9, 1)));
+    tunnel.set(Field::IPV4_SRC, FieldGenerator::random(0, 0xFFFFFFFF, 11))
+        .set(Field::SRC_PORT, FieldGenerator::sequence(0));
+    for (int i = 0; i < 100; ++i) {
+        tunnel.stamp_into(frame);
+        Ipv4View outer(frame.data(), frame.size());
+        Ipv4View inner(frame.data() + 28, frame.size() - 28);
+        assert(outer.checksum_valid() && inner.checksum_valid());
+        assert(UdpView(frame.data() + 20, frame.size() - 20).checksum_valid(outer.src(), outer.dst()));
+        assert(UdpView(frame.data() + 48, frame.size() - 48).checksum_valid(inner.src(), inner.dst()));
+    }
+
+    std::cout << "  OK\n\n";
+}
+
+void test_errors_and_batches() {
+    std::cout << "Test 4: Missing fields, overlaps and batches\n";
+
+    PacketTemplate ping(PacketBuilder()
+                            .ipv6(IPv6Header(IPv6Address("::1"), IPv6Address("::2"), IPv6Header::NEXT_HEADER_ICMPV6))
+                            .icmp(ICMPHeader(ICMPHeader::TYPE_ECHO_REQUEST_V6, 0))
+                            .payload(std::vector<uint8_t>(8, 0)));
+    assert(throws<std::invalid_argument>([&] { ping.set(Field::IP_ID, FieldGenerator::sequence(0)); }));
+    assert(throws<std::invalid_argument>([&] { ping.set(Field::SRC_PORT, FieldGenerator::sequence(0)); }));
+    assert(throws<std::invalid_argument>([&] { ping.set(Field::VLAN_ID, FieldGenerator::sequence(0)); }));
+    assert(throws<std::invalid_argument>([&] { ping.set_payload(4, 5, FieldGenerator::sequence(0)); }));
+    ping.set_payload(0, 4, FieldGenerator::sequence(0));
+    assert(throws<std::invalid_argument>([&] { ping.set_payload(2, 2, FieldGenerator::sequence(0)); }));
+
+    // Batches land `stride` bytes apart and stamping does not allocate
+    uint8_t ring[32 * 128];
+    size_t before = allocations;
+    for (int round = 0; round < 10; ++round) {
+        assert(ping.stamp_batch(MutableByteSpan(ring), 32, 128) == 32);
+    }
+    assert(allocations == before);
+    for (size_t i = 0; i < 32; ++i) {
+        const uint8_t* packet = ring + i * 128;
+        assert(detail::load32(packet + 48) == 10 * 32 - 32 + i);
+        assert(IcmpView(packet + 40, 16).checksum_valid(IPv6Address("::1"), IPv6Address("::2")));
+    }
+    bool threw = false;
+    try {
+        ping.stamp_batch(MutableByteSpan(ring), 33, 128);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "  OK\n\n";
+}
+
+void benchmark_generation() {
+    std::cout << "Test 5: Generating 1M 64-byte UDP flows\n";
+
+    constexpr size_t PACKETS = 1000000;
+    constexpr size_t BATCH = 32;
+    std::vector<uint8_t> payload(18, 0x42);
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t sink = 0;
+    for (size_t i = 0; i < PACKETS; ++i) {
+        auto packet = patterns::udp_packet(src_ip, dst_ip, static_cast<uint16_t>(1024 + i % 1000), 53, payload);
+        sink += packet[21];
+    }
+    report("patterns::udp_packet", start, PACKETS, "packet", sink);
+
+    EthernetHeader eth(dst_mac, src_mac, EthernetHeader::ETHERTYPE_IPV4);
+    PacketBuilder builder;
+    uint8_t frame[128];
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    for (size_t i = 0; i < PACKETS; ++i) {
+        IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP);
+        ip.id(static_cast<uint16_t>(i));
+        builder.reset().ethernet(eth).ipv4(ip).udp(UDPHeader(static_cast<uint16_t>(1024 + i % 1000), 53))
+            .payload(payload).finalize().fcs().build_into(MutableByteSpan(frame));
+        sink += frame[35];
+    }
+    report("PacketBuilder, reused", start, PACKETS, "packet", sink);
+
+    PacketTemplate flows(PacketBuilder()
+                             .ethernet(eth)
+                             .ipv4(IPv4Header(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP))
+                             .udp(UDPHeader(1024, 53))
+                             .payload(payload));
+    flows.set(Field::SRC_PORT, FieldGenerator::range(1024, 2023)).set(Field::IP_ID, FieldGenerator::sequence(0));
+    std::vector<uint8_t> ring(BATCH * 128);
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    for (size_t i = 0; i < PACKETS; i += BATCH) {
+        flows.stamp_batch(MutableByteSpan(ring), BATCH, 128);
+        sink += ring[35];
+    }
+    report("PacketTemplate, batches of 32", start, PACKETS, "packet", sink);
+    assert(Ipv4View(ring.data() + 14, 50).checksum_valid());
+    assert(UdpView(ring.data() + 34, 26).checksum_valid(src_ip, dst_ip));
+
+    PacketTemplate flows_fcs(PacketBuilder()
+                                 .ethernet(eth)
+                                 .ipv4(IPv4Header(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP))
+                                 .udp(UDPHeader(1024, 53))
+                                 .payload(payload)
+                                 .fcs());
+    flows_fcs.set(Field::SRC_PORT, FieldGenerator::range(1024, 2023)).set(Field::IP_ID, FieldGenerator::sequence(0));
+    start = std::chrono::high_resolution_clock::now();
+    sink = 0;
+    for (size_t i = 0; i < PACKETS; i += BATCH) {
+        flows_fcs.stamp_batch(MutableByteSpan(ring), BATCH, 128);
+        sink += ring[35];
+    }
+    report("PacketTemplate with FCS", start, PACKETS, "packet", sink);
+    assert(crc::verify_fcs(ring.data(), flows_fcs.size()));
+    std::cout << "\n";
+}
+
+int main() {
+    std::cout << "=== Testing Packet Templates ===\n\n";
+
+    test_generators();
+    test_stamps_match_builds();
+    test_vlan_ipv6_tunnel();
+    test_errors_and_batches();
+    benchmark_generation();
+
+    std::cout << "=== Packet Template Tests Complete ===\n";
+    return 0;
+}
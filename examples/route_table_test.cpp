@@ -0,0 +1,260 @@
+#include "route_table.h"
+#include "pcap_support.h"
+#include "utils.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace cppscapy;
+
+// Linear-scan longest prefix match for cross-checking
+template <typename Prefix, typename Address>
+uint32_t reference_lookup(const std::vector<std::pair<Prefix, uint32_t>>& routes, const Address& address) {
+    int best = -1;
+    uint32_t value = IPv4RouteTable::NO_ROUTE;
+    for (const auto& route : routes) {
+        if (route.first.contains(address) && static_cast<int>(route.first.length()) > best) {
+            best = route.first.length();
+            value = route.second;
+        }
+    }
+    return value;
+}
+
+template <typename Prefix>
+void set_route(std::vector<std::pair<Prefix, uint32_t>>& routes, const Prefix& prefix, uint32_t value) {
+    for (auto& route : routes) {
+        if (route.first == prefix) {
+            route.second = value;
+            return;
+        }
+    }
+    routes.emplace_back(prefix, value);
+}
+
+void test_ipv4_table() {
+    std::cout << "Test 1: IPv4 DIR-24-8 against a linear scan\n";
+
+    IPv4RouteTable table;
+    assert(table.lookup("10.0.0.1"_ipv4) == IPv4RouteTable::NO_ROUTE);
+    assert(table.lookup("10.0.0.1"_ipv4, 7) == 7);
+
+    table.insert(IPv4Prefix("10.0.0.0/8"), 1);
+    table.insert(IPv4Prefix("10.1.0.0/16"), 2);
+    table.insert(IPv4Prefix("10.1.2.0/24"), 3);
+    table.insert(IPv4Prefix("10.1.2.128/25"), 4);
+    table.insert(IPv4Prefix("10.1.2.200/32"), 5);
+    assert(table.lookup("10.9.9.9"_ipv4) == 1);
+    assert(table.lookup("10.1.9.9"_ipv4) == 2);
+    assert(table.lookup("10.1.2.1"_ipv4) == 3);
+    assert(table.lookup("10.1.2.129"_ipv4) == 4);
+    assert(table.lookup("10.1.2.200"_ipv4) == 5);
+    assert(table.lookup("11.0.0.0"_ipv4) == IPv4RouteTable::NO_ROUTE);
+    assert(table.size() == 5 && table.group_count() == 1);
+
+    // A shorter prefix inserted later keeps the longer ones
+    table.insert(IPv4Prefix("10.1.0.0/20"), 6);
+    assert(table.lookup("10.1.2.1"_ipv4) == 3 && table.lookup("10.1.3.1"_ipv4) == 6);
+
+    // Erasing hands addresses back to the covering route and recycles groups
+    assert(table.erase(IPv4Prefix("10.1.2.128/25")));
+    assert(!table.erase(IPv4Prefix("10.1.2.128/25")));
+    assert(table.lookup("10.1.2.129"_ipv4) == 3 && table.lookup("10.1.2.200"_ipv4) == 5);
+    assert(table.erase(IPv4Prefix("10.1.2.200/32")));
+    assert(table.lookup("10.1.2.200"_ipv4) == 3 && table.group_count() == 0);
+
+    // Random overlapping routes inside 10.0.0.0/8, with erases and updates
+    std::mt19937 rng(21);
+    IPv4Prefix space("10.0.0.0/8");
+    IPv4RouteTable random_table(256);
+    std::vector<std::pair<IPv4Prefix, uint32_t>> routes;
+    std::uniform_int_distribution<int> length_of(8, 32);
+    for (int round = 0; round < 3000; ++round) {
+        IPv4Prefix prefix(space.sample(rng), static_cast<uint8_t>(length_of(rng)));
+        if (round % 4 == 3 && !routes.empty()) {
+            size_t victim = rng() % routes.size();
+            assert(random_table.erase(routes[victim].first));
+            routes.erase(routes.begin() + static_cast<long>(victim));
+        } else {
+            uint32_t value = static_cast<uint32_t>(rng() % 50);
+            if (random_table.insert(prefix, value)) {
+                set_route(routes, prefix, value);
+            }
+        }
+    }
+    assert(random_table.size() == routes.size());
+    std::vector<IPv4Address> queries;
+    for (int i = 0; i < 20000; ++i) {
+        queries.push_back(i % 2 ? space.sample(rng) : routes[rng() % routes.size()].first.sample(rng));
+    }
+    std::vector<uint32_t> batch(queries.size());
+    random_table.lookup(queries.data(), queries.size(), batch.data());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        uint32_t expected = reference_lookup(routes, queries[i]);
+        assert(random_table.lookup(queries[i]) == expected);
+        assert(batch[i] == expected);
+    }
+
+    // Erasing everything leaves no groups behind
+    for (const auto& route : routes) {
+        assert(random_table.erase(route.first));
+    }
+    assert(random_table.size() == 0 && random_table.group_count() == 0);
+    assert(random_table.lookup("10.1.2.3"_ipv4) == IPv4RouteTable::NO_ROUTE);
+
+    // Bounded pool: a table with one group takes one /25, not a second /24's worth
+    IPv4RouteTable tiny(1);
+    assert(tiny.insert(IPv4Prefix("192.0.2.0/25"), 1));
+    assert(tiny.insert(IPv4Prefix("192.0.2.128/26"), 2));
+    assert(!tiny.insert(IPv4Prefix("198.51.100.0/25"), 3));
+    size_t before = tiny.memory_usage();
+    bool inserted = tiny.insert(IPv4Prefix("203.0.113.0/25"), 4);
+    assert(!inserted && tiny.memory_usage() == before);  // no orphaned value
+    assert(tiny.insert(IPv4Prefix("198.51.100.0/24"), 3));
+
+    std::cout << "  OK\n\n";
+}
+
+void test_ipv6_table() {
+    std::cout << "Test 2: IPv6 multibit trie against a linear scan\n";
+
+    IPv6RouteTable table;
+    table.insert(IPv6Prefix("::/0"), 9);
+    table.insert(IPv6Prefix("2001:db8::/32"), 1);
+    table.insert(IPv6Prefix("2001:db8:abcd::/48"), 2);
+    table.insert(IPv6Prefix("2001:db8:abcd:12::/64"), 3);
+    table.insert(IPv6Prefix("2001:db8:abcd:12::1/128"), 4);
+    assert(table.lookup("2001:db8:abcd:12::1"_ipv6) == 4);
+    assert(table.lookup("2001:db8:abcd:12::2"_ipv6) == 3);
+    assert(table.lookup("2001:db8:abcd:13::"_ipv6) == 2);
+    assert(table.lookup("2001:db8:1::"_ipv6) == 1);
+    assert(table.lookup("fe80::1"_ipv6) == 9);
+    assert(table.erase(IPv6Prefix("2001:db8:abcd:12::1/128")));
+    assert(table.erase(IPv6Prefix("2001:db8:abcd:12::/64")));
+    assert(table.lookup("2001:db8:abcd:12::1"_ipv6) == 2);
+
+    std::mt19937_64 rng(22);
+    IPv6Prefix space("2001:db8::/32");
+    IPv6RouteTable random_table;
+    std::vector<std::pair<IPv6Prefix, uint32_t>> routes;
+    std::uniform_int_distribution<int> length_of(32, 128);
+    for (int round = 0; round < 2000; ++round) {
+        // Cluster half the routes so they share deep groups
+        IPv6Address base = round % 2 ? space.sample(rng) : IPv6Prefix("2001:db8:1:2::/64").sample(rng);
+        IPv6Prefix prefix(base, static_cast<uint8_t>(length_of(rng)));
+        if (round % 4 == 3 && !routes.empty()) {
+            size_t victim = rng() % routes.size();
+            assert(random_table.erase(routes[victim].first));
+            routes.erase(routes.begin() + static_cast<long>(victim));
+        } else {
+            uint32_t value = static_cast<uint32_t>(rng() % 1000);
+            assert(random_table.insert(prefix, value));
+            set_route(routes, prefix, value);
+        }
+    }
+    std::vector<IPv6Address> queries;
+    for (int i = 0; i < 5000; ++i) {
+        queries.push_back(i % 2 ? space.sample(rng) : routes[rng() % routes.size()].first.sample(rng));
+    }
+    std::vector<uint32_t> batch(queries.size());
+    random_table.lookup(queries.data(), queries.size(), batch.data());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        uint32_t expected = reference_lookup(routes, queries[i]);
+        assert(random_table.lookup(queries[i]) == expected);
+        assert(batch[i] == expected);
+    }
+    for (const auto& route : routes) {
+        assert(random_table.erase(route.first));
+    }
+    assert(random_table.group_count() == 0);
+
+    std::cout << "  OK\n\n";
+}
+
+void test_packet_tagging() {
+    std::cout << "Test 3: Tagging decoded packets\n";
+
+    IPv4RouteTable customers;
+    customers.insert(IPv4Prefix("192.168.1.0/24"), 100);
+    customers.insert(IPv4Prefix("8.8.8.0/24"), 200);
+
+    auto frame = [](const IPv4Address& src, const IPv4Address& dst) {
+        return patterns::ethernet_frame(MacAddress(), MacAddress::broadcast(), 0x0800,
+                                        patterns::udp_packet(src, dst, 5353, 53, std::vector<uint8_t>(4, 0)));
+    };
+    auto to_google = frame("192.168.1.5"_ipv4, "8.8.8.8"_ipv4);
+    auto to_nowhere = frame("192.168.1.5"_ipv4, "203.0.113.1"_ipv4);
+    std::vector<utils::PacketInfo> infos = {utils::analyze_packet(to_google), utils::analyze_packet(to_nowhere)};
+    std::vector<uint32_t> tags(infos.size());
+    customers.lookup_each(infos.data(), infos.size(), tags.data(),
+                          [](const utils::PacketInfo& info) { return info.dst_ipv4; });
+    assert(tags[0] == 200 && tags[1] == IPv4RouteTable::NO_ROUTE);
+    customers.lookup_each(infos.data(), infos.size(), tags.data(),
+                          [](const utils::PacketInfo& info) { return info.src_ipv4; }, 0);
+    assert(tags[0] == 100 && tags[1] == 100);
+
+    std::vector<pcap::utils::DecodedPacket> decoded = {pcap::utils::decode_packet(pcap::Packet(to_google))};
+    customers.lookup_each(decoded.data(), decoded.size(), tags.data(),
+                          [](const pcap::utils::DecodedPacket& packet) { return packet.dst_address(); });
+    assert(tags[0] == 200);
+
+    std::cout << "  OK\n\n";
+}
+
+void benchmark_lookup() {
+    std::cout << "Test 4: 1M-prefix IPv4 table, 8M lookups\n";
+
+    // Roughly the shape of a full BGP table: mostly /24s, some shorter, a
+    // few longer than /24
+    std::mt19937 rng(23);
+    IPv4RouteTable table(1 << 15);
+    auto start = std::chrono::high_resolution_clock::now();
+    while (table.size() < 1000000) {
+        uint32_t r = rng() % 100;
+        uint8_t length = r < 60 ? 24 : r < 97 ? static_cast<uint8_t>(16 + rng() % 8) : static_cast<uint8_t>(25 + rng() % 8);
+        IPv4Address address(detail::network_order32(static_cast<uint32_t>(rng())));
+        table.insert(IPv4Prefix(address, length), static_cast<uint32_t>(rng() % 70000));
+    }
+    double build = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "  built " << table.size() << " prefixes in " << std::fixed << std::setprecision(2) << build
+              << " s, " << table.group_count() << " groups, " << table.memory_usage() / (1 << 20) << " MiB\n";
+
+    std::vector<IPv4Address> queries(8000000);
+    for (auto& query : queries) {
+        query = IPv4Address(static_cast<uint32_t>(rng()));
+    }
+    std::vector<uint32_t> values(queries.size());
+
+    auto time = [&](const char* name, auto&& body) {
+        auto begin = std::chrono::high_resolution_clock::now();
+        body();
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+        uint64_t sink = 0;
+        for (uint32_t v : values) sink += v;
+        std::cout << "  " << std::left << std::setw(24) << name << std::right << std::setw(7)
+                  << 1e9 * seconds / queries.size() << " ns/lookup  " << std::setw(6)
+                  << queries.size() / seconds / 1e6 << " Mlookups/s (sink " << (sink & 0xF) << ")\n";
+    };
+    time("single lookup()", [&] {
+        for (size_t i = 0; i < queries.size(); ++i) {
+            values[i] = table.lookup(queries[i]);
+        }
+    });
+    time("batch lookup()", [&] { table.lookup(queries.data(), queries.size(), values.data()); });
+    std::cout << "\n";
+}
+
+int main() {
+    std::cout << "=== Testing Route Tables ===\n\n";
+
+    test_ipv4_table();
+    test_ipv6_table();
+    test_packet_tagging();
+    benchmark_lookup();
+
+    std::cout << "=== Route Table Tests Complete ===\n";
+    return 0;
+}
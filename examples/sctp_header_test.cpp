@@ -0,0 +1,75 @@
+#include "generated_headers.h"
+#include "crc.h"
+#include <iostream>
+#include <cassert>
+
+using namespace cppscapy;
+
+// The RFC 3720 (B.4) iSCSI Read(10) PDU, CRC32c 0xD9963A56, read as an SCTP
+// packet: ports 0x01C0 -> 0, tag 0 and a zero checksum field, followed by
+// 36 bytes of chunks
+const std::vector<uint8_t> known_chunks = {
+    0x00, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00,
+    0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x18, 0x28, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+void test_known_answer() {
+    std::cout << "Test 1: SCTP checksum known answer (RFC 3720 PDU)\n";
+
+    dsl::SCTPHeader sctp;
+    sctp.set_src_port(0x01C0);
+    sctp.update_checksum(known_chunks);
+    assert(sctp.checksum() == crc::sctp_field_value(0xD9963A56));
+    assert(sctp.verify_checksum(known_chunks));
+
+    // Whatever was stored before does not take part
+    sctp.set_checksum(0x12345678);
+    sctp.update_checksum(known_chunks);
+    assert(sctp.checksum() == crc::sctp_field_value(0xD9963A56));
+
+    std::cout << "  Checksum field 0x" << std::hex << sctp.checksum() << std::dec << ": OK\n\n";
+}
+
+void test_chunks() {
+    std::cout << "Test 2: SCTP checksum over a DATA chunk\n";
+
+    dsl::SCTPHeader sctp;
+    sctp.set_src_port(2905);
+    sctp.set_dst_port(2905);
+    sctp.set_verification_tag(0xDEADBEEF);
+    std::vector<uint8_t> chunks = {
+        0x00, 0x03, 0x00, 0x15,  // DATA, length 21
+        0x00, 0x00, 0x00, 0x01,  // TSN
+        0x00, 0x00, 0x00, 0x00,  // stream id / sequence
+        0x00, 0x00, 0x00, 0x03,  // PPID
+        'h', 'e', 'l', 'l', 'o', 0x00, 0x00, 0x00
+    };
+    sctp.update_checksum(chunks);
+
+    // Matches the in-place packet checksum
+    std::vector<uint8_t> packet = sctp.to_bytes();
+    packet.insert(packet.end(), chunks.begin(), chunks.end());
+    assert(sctp.checksum() == crc::sctp_checksum(packet.data(), packet.size()));
+    assert(crc::verify_sctp_checksum(packet.data(), packet.size()));
+
+    // A checksum of the header alone would be wrong, so it is not computed
+    uint32_t stored = sctp.checksum();
+    sctp.update_computed_fields();
+    assert(sctp.checksum() == stored);
+
+    chunks[18] ^= 0x01;
+    assert(!sctp.verify_checksum(chunks));
+
+    std::cout << "  Header and chunks: OK\n\n";
+}
+
+int main() {
+    std::cout << "=== Testing SCTP Header Checksums ===\n\n";
+
+    test_known_answer();
+    test_chunks();
+
+    std::cout << "=== SCTP Header Checksum Tests Complete ===\n";
+    return 0;
+}
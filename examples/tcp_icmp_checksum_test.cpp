@@ -0,0 +1,132 @@
+#include "network_headers.h"
+#include "header_dsl.h"
+#include "pcap_support.h"
+#include "checksum.h"
+#include "utils.h"
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+
+using namespace cppscapy;
+
+// Sum a transport segment together with its IPv4 pseudo-header; a correct
+// checksum makes the folded total 0xFFFF (i.e. the final checksum is zero)
+uint16_t verify_ipv4_l4(const uint8_t* ip) {
+    size_t ihl = (ip[0] & 0x0F) * 4;
+    size_t total = (ip[2] << 8) | ip[3];
+    uint16_t pseudo_sum = checksum::pseudo_header_ipv4(ip + 12, ip + 16, ip[9],
+                                                       static_cast<uint16_t>(total - ihl));
+    return checksum::finish(checksum::partial(ip + ihl, total - ihl, pseudo_sum));
+}
+
+uint16_t verify_ipv6_l4(const IPv6Address& src, const IPv6Address& dst, uint8_t next_header,
+                        const std::vector<uint8_t>& segment) {
+    auto src_bytes = src.to_bytes();
+    auto dst_bytes = dst.to_bytes();
+    uint16_t pseudo_sum = checksum::pseudo_header_ipv6(src_bytes.data(), dst_bytes.data(), next_header,
+                                                       static_cast<uint32_t>(segment.size()));
+    return checksum::finish(checksum::partial(segment, pseudo_sum));
+}
+
+void test_patterns() {
+    std::cout << "Test 1: patterns::tcp_syn and patterns::icmp_ping are valid\n";
+
+    auto syn = patterns::tcp_syn(IPv4Address("192.168.1.10"), IPv4Address("10.0.0.1"), 40000, 80, 12345);
+    assert(utils::verify_ipv4_checksum(syn));
+    assert(verify_ipv4_l4(syn.data()) == 0);
+    assert(((syn[36] << 8) | syn[37]) != 0);
+
+    auto ping = patterns::icmp_ping(IPv4Address("192.168.1.10"), IPv4Address("8.8.8.8"), 0x1234, 7);
+    assert(utils::verify_ipv4_checksum(ping));
+    assert(checksum::compute(ping.data() + 20, ping.size() - 20) == 0);
+
+    std::cout << "  TCP checksum: 0x" << std::hex << ((syn[36] << 8) | syn[37])
+              << ", ICMP checksum: 0x" << ((ping[22] << 8) | ping[23]) << std::dec << "\n\n";
+}
+
+void test_tcp_with_payload() {
+    std::cout << "Test 2: TCP over IPv4 and IPv6 with payload\n";
+
+    IPv4Address src4("172.16.0.1"), dst4("172.16.0.2");
+    auto payload = utils::random::random_bytes_seeded(777, 21);
+
+    TCPHeader tcp(1234, 443);
+    tcp.seq_num(1).ack_num(2).flags(TCPHeader::FLAG_ACK | TCPHeader::FLAG_PSH);
+
+    // Agrees with the utility implementation
+    uint16_t expected = utils::calculate_tcp_checksum(tcp.to_bytes(), src4, dst4, payload);
+    assert(tcp.calculate_checksum(src4, dst4, payload) == expected);
+
+    tcp.update_checksum(src4, dst4, payload);
+    assert(tcp.checksum() == expected);
+    auto tcp_bytes = tcp.to_bytes();
+    assert(((tcp_bytes[16] << 8) | tcp_bytes[17]) == expected);
+
+    IPv6Address src6("2001:db8::1"), dst6("2001:db8::2");
+    auto segment = tcp.to_bytes(src6, dst6, payload);
+    segment.insert(segment.end(), payload.begin(), payload.end());
+    assert(verify_ipv6_l4(src6, dst6, IPv6Header::NEXT_HEADER_TCP, segment) == 0);
+
+    std::cout << "  IPv4 and IPv6 pseudo-headers: OK\n\n";
+}
+
+void test_icmp() {
+    std::cout << "Test 3: ICMP and ICMPv6 echo\n";
+
+    auto payload = utils::random::random_bytes_seeded(57, 5);
+
+    ICMPHeader icmp(ICMPHeader::TYPE_ECHO_REQUEST, 0);
+    icmp.identifier(99).sequence(1).update_checksum(payload);
+    auto message = icmp.to_bytes();
+    message.insert(message.end(), payload.begin(), payload.end());
+    assert(checksum::compute(message) == 0);
+
+    IPv6Address src6("fe80::1"), dst6("fe80::2");
+    ICMPHeader echo6(ICMPHeader::TYPE_ECHO_REQUEST_V6, 0);
+    echo6.identifier(99).sequence(1);
+    auto message6 = echo6.to_bytes(src6, dst6, payload);
+    message6.insert(message6.end(), payload.begin(), payload.end());
+    assert(verify_ipv6_l4(src6, dst6, IPv6Header::NEXT_HEADER_ICMPV6, message6) == 0);
+
+    // The ICMPv6 checksum differs from a plain ICMP one over the same bytes
+    assert(echo6.calculate_checksum(src6, dst6, payload) != echo6.calculate_checksum(payload));
+
+    std::cout << "  ICMP and ICMPv6 checksums: OK\n\n";
+}
+
+void test_dsl_tcp() {
+    std::cout << "Test 4: DSL TCP header and pcap helper\n";
+
+    dsl::EthernetHeader eth;
+    dsl::TCPHeader tcp;
+    tcp.set_src_port(5555);
+    tcp.set_dst_port(80);
+    tcp.set_flag_syn(true);
+    tcp.update_computed_fields();
+    assert(tcp.checksum() == 0);
+
+    std::vector<uint8_t> payload = {'G', 'E', 'T', ' ', '/', '\r', '\n'};
+    auto packet = pcap::utils::create_tcp_packet(eth, tcp, payload);
+    const auto& bytes = packet.data();
+    assert(verify_ipv4_l4(bytes.data() + 14) == 0);
+
+    // The checksum needs the pseudo-header and the payload
+    tcp.update_checksum(0x0A000001, 0x0A000002, payload);
+    TCPHeader reference(5555, 80);
+    reference.data_offset(5).flags(TCPHeader::FLAG_SYN).window_size(0);
+    assert(tcp.checksum() == reference.calculate_checksum(IPv4Address("10.0.0.1"), IPv4Address("10.0.0.2"), payload));
+
+    std::cout << "  DSL checksum: 0x" << std::hex << tcp.checksum() << std::dec << "\n\n";
+}
+
+int main() {
+    std::cout << "=== Testing TCP and ICMP Checksums ===\n\n";
+
+    test_patterns();
+    test_tcp_with_payload();
+    test_icmp();
+    test_dsl_tcp();
+
+    std::cout << "=== TCP and ICMP Checksum Tests Complete ===\n";
+    return 0;
+}
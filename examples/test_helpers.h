@@ -0,0 +1,59 @@
+#pragma once
+// Helpers shared by the example tests
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+// std::array's operator== is only constexpr from C++20
+template <size_t N>
+constexpr bool same_bytes(const std::array<uint8_t, N>& a, const std::array<uint8_t, N>& b) {
+    for (size_t i = 0; i < N; ++i) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whether calling `function` throws an `Exception`
+template <typename Exception, typename Function>
+bool throws(Function function) {
+    try {
+        function();
+    } catch (const Exception&) {
+        return true;
+    }
+    return false;
+}
+
+// Benchmark lines: the time per item since `start`, optionally the heap
+// allocations per item, and the sink that keeps the timed work alive
+//
+//   auto start = BenchmarkClock::now();
+//   for (size_t i = 0; i < FRAMES; ++i) { ... sink += ...; }
+//   report("write_to", start, FRAMES, "frame", sink);
+using BenchmarkClock = std::chrono::high_resolution_clock;
+
+inline double nanoseconds_each(BenchmarkClock::time_point start, size_t count) {
+    return 1e9 * std::chrono::duration<double>(BenchmarkClock::now() - start).count() / static_cast<double>(count);
+}
+
+inline void report(const char* name, BenchmarkClock::time_point start, size_t count, const char* unit,
+                   uint64_t sink) {
+    double ns = nanoseconds_each(start, count);
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(7) << ns << " ns/" << unit << " (sink " << (sink & 0xF) << ")\n";
+}
+
+inline void report(const char* name, BenchmarkClock::time_point start, size_t count, const char* unit,
+                   size_t allocated, uint64_t sink) {
+    double ns = nanoseconds_each(start, count);
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(7) << ns << " ns/" << unit << ", " << std::setprecision(2)
+              << static_cast<double>(allocated) / static_cast<double>(count) << " allocations/" << unit
+              << " (sink " << (sink & 0xF) << ")\n";
+}
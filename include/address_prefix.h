@@ -0,0 +1,285 @@
+#pragma once
+
+#include "network_headers.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cppscapy {
+
+// CIDR prefixes over the address classes. Everything except the text
+// conversions is constexpr integer arithmetic on the address as a host-order
+// integer (one byte swap away from the network-order storage), so contains(),
+// iteration and sampling never build strings. The constructors clear host
+// bits: IPv4Prefix(10.1.2.3, 8) is 10.0.0.0/8.
+
+// IPv6 prefixes and the IPv6 route table do their arithmetic on 128-bit
+// integers, which need GCC or Clang (CMake checks this up front too)
+#if !defined(__SIZEOF_INT128__)
+#error "cppscapy needs a compiler with unsigned __int128 (GCC or Clang)"
+#endif
+
+namespace detail {
+    using uint128 = unsigned __int128;
+
+    constexpr uint32_t host_order(const IPv4Address& address) {
+        return network_order32(address.to_uint32());
+    }
+
+    constexpr uint128 host_order(const IPv6Address& address) {
+        auto bytes = address.to_bytes();
+        uint128 value = 0;
+        for (uint8_t b : bytes) {
+            value = (value << 8) | b;
+        }
+        return value;
+    }
+
+    constexpr IPv6Address ipv6_from_host_order(uint128 value) {
+        std::array<uint8_t, 16> bytes{};
+        for (size_t i = 16; i-- > 0;) {
+            bytes[i] = static_cast<uint8_t>(value);
+            value >>= 8;
+        }
+        return IPv6Address(bytes);
+    }
+
+    // Contiguous addresses [begin, end) of a prefix, as handed out by split()
+    template <typename Iterator>
+    class AddressRange {
+    public:
+        constexpr AddressRange(Iterator first, Iterator last) : first_(first), last_(last) {}
+
+        constexpr Iterator begin() const { return first_; }
+        constexpr Iterator end() const { return last_; }
+        constexpr auto size() const { return last_ - first_; }
+
+    private:
+        Iterator first_;
+        Iterator last_;
+    };
+
+    // Splits `count` consecutive addresses from `first` into at most `parts`
+    // ranges whose sizes differ by at most one
+    template <typename Iterator, typename Count>
+    std::vector<AddressRange<Iterator>> split_range(Iterator first, Count count, size_t parts) {
+        if (parts == 0) {
+            throw std::invalid_argument("Cannot split a prefix into zero parts");
+        }
+        if (static_cast<Count>(parts) > count) {
+            parts = static_cast<size_t>(count);
+        }
+        Count base = count / parts;
+        Count extra = count % parts;
+        std::vector<AddressRange<Iterator>> ranges;
+        ranges.reserve(parts);
+        for (size_t i = 0; i < parts; ++i) {
+            Iterator last = first + (base + (static_cast<Count>(i) < extra ? 1 : 0));
+            ranges.emplace_back(first, last);
+            first = last;
+        }
+        return ranges;
+    }
+}
+
+class IPv4Prefix {
+public:
+    static constexpr uint8_t MAX_LENGTH = 32;
+
+    // Addresses in increasing order; the position is kept in 64 bits so the
+    // end of 0.0.0.0/0 is representable
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = IPv4Address;
+        using difference_type = int64_t;
+        using pointer = const IPv4Address*;
+        using reference = IPv4Address;
+
+        constexpr iterator() = default;
+        constexpr explicit iterator(uint64_t value) : value_(value) {}
+
+        constexpr IPv4Address operator*() const {
+            return IPv4Address(detail::network_order32(static_cast<uint32_t>(value_)));
+        }
+        constexpr iterator& operator++() { ++value_; return *this; }
+        constexpr iterator operator++(int) { iterator old = *this; ++value_; return old; }
+        constexpr iterator operator+(uint64_t n) const { return iterator(value_ + n); }
+        constexpr uint64_t operator-(const iterator& other) const { return value_ - other.value_; }
+        constexpr bool operator==(const iterator& other) const { return value_ == other.value_; }
+        constexpr bool operator!=(const iterator& other) const { return value_ != other.value_; }
+
+    private:
+        uint64_t value_ = 0;
+    };
+
+    using Range = detail::AddressRange<iterator>;
+
+    constexpr IPv4Prefix() = default;
+    constexpr IPv4Prefix(const IPv4Address& address, uint8_t length)
+        : base_(detail::host_order(address) & mask_for(length)), length_(length) {}
+    explicit IPv4Prefix(const std::string& text);  // "10.0.0.0/8", throws std::invalid_argument
+
+    constexpr IPv4Address network() const { return IPv4Address(detail::network_order32(base_)); }
+    constexpr IPv4Address netmask() const { return IPv4Address(detail::network_order32(mask_for(length_))); }
+    constexpr IPv4Address last() const { return (*this)[size() - 1]; }
+    constexpr uint8_t length() const { return length_; }
+    constexpr uint64_t size() const { return uint64_t(1) << (MAX_LENGTH - length_); }
+
+    constexpr bool contains(const IPv4Address& address) const {
+        return (detail::host_order(address) & mask_for(length_)) == base_;
+    }
+    constexpr bool contains(const IPv4Prefix& other) const {
+        return other.length_ >= length_ && contains(other.network());
+    }
+
+    // The index-th address, index < size()
+    constexpr IPv4Address operator[](uint64_t index) const {
+        return IPv4Address(detail::network_order32(base_ + static_cast<uint32_t>(index)));
+    }
+    constexpr iterator begin() const { return iterator(base_); }
+    constexpr iterator end() const { return iterator(uint64_t(base_) + size()); }
+
+    // Uniformly distributed address of the prefix
+    template <typename URBG>
+    IPv4Address sample(URBG& rng) const {
+        std::uniform_int_distribution<uint32_t> bits;
+        return IPv4Address(detail::network_order32(base_ | (bits(rng) & ~mask_for(length_))));
+    }
+
+    // Up to `parts` consecutive ranges covering the prefix, for parallel sweeps
+    std::vector<Range> split(size_t parts) const {
+        return detail::split_range(begin(), size(), parts);
+    }
+
+    std::string to_string() const;
+    static std::errc parse(std::string_view text, IPv4Prefix& value) noexcept;
+
+    constexpr bool operator==(const IPv4Prefix& other) const {
+        return base_ == other.base_ && length_ == other.length_;
+    }
+    constexpr bool operator!=(const IPv4Prefix& other) const { return !(*this == other); }
+
+private:
+    static constexpr uint32_t mask_for(uint8_t length) {
+        if (length > MAX_LENGTH) {
+            throw std::invalid_argument("IPv4 prefix length must be 0-32");
+        }
+        return length ? ~uint32_t(0) << (MAX_LENGTH - length) : 0;
+    }
+
+    uint32_t base_ = 0;  // host order
+    uint8_t length_ = 0;
+};
+
+class IPv6Prefix {
+public:
+    static constexpr uint8_t MAX_LENGTH = 128;
+
+    // Addresses in increasing order. 128-bit counts cannot hold the size of
+    // ::/0, so for that prefix size() and iteration stop one address short.
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = IPv6Address;
+        using difference_type = __int128;
+        using pointer = const IPv6Address*;
+        using reference = IPv6Address;
+
+        constexpr iterator() = default;
+        constexpr explicit iterator(detail::uint128 value) : value_(value) {}
+
+        constexpr IPv6Address operator*() const { return detail::ipv6_from_host_order(value_); }
+        constexpr iterator& operator++() { ++value_; return *this; }
+        constexpr iterator operator++(int) { iterator old = *this; ++value_; return old; }
+        constexpr iterator operator+(detail::uint128 n) const { return iterator(value_ + n); }
+        constexpr detail::uint128 operator-(const iterator& other) const { return value_ - other.value_; }
+        constexpr bool operator==(const iterator& other) const { return value_ == other.value_; }
+        constexpr bool operator!=(const iterator& other) const { return value_ != other.value_; }
+
+    private:
+        detail::uint128 value_ = 0;
+    };
+
+    using Range = detail::AddressRange<iterator>;
+
+    constexpr IPv6Prefix() = default;
+    constexpr IPv6Prefix(const IPv6Address& address, uint8_t length)
+        : base_(detail::host_order(address) & mask_for(length)), length_(length) {}
+    explicit IPv6Prefix(const std::string& text);  // "2001:db8::/32", throws std::invalid_argument
+
+    constexpr IPv6Address network() const { return detail::ipv6_from_host_order(base_); }
+    constexpr IPv6Address last() const { return detail::ipv6_from_host_order(base_ | ~mask_for(length_)); }
+    constexpr uint8_t length() const { return length_; }
+    constexpr detail::uint128 size() const {
+        return length_ ? detail::uint128(1) << (MAX_LENGTH - length_) : ~detail::uint128(0);
+    }
+
+    constexpr bool contains(const IPv6Address& address) const {
+        return (detail::host_order(address) & mask_for(length_)) == base_;
+    }
+    constexpr bool contains(const IPv6Prefix& other) const {
+        return other.length_ >= length_ && contains(other.network());
+    }
+
+    // The index-th address, index < size()
+    constexpr IPv6Address operator[](detail::uint128 index) const {
+        return detail::ipv6_from_host_order(base_ + index);
+    }
+    constexpr iterator begin() const { return iterator(base_); }
+    constexpr iterator end() const { return iterator(base_ + size()); }
+
+    // Uniformly distributed address of the prefix
+    template <typename URBG>
+    IPv6Address sample(URBG& rng) const {
+        // Drawn in order, so a seeded generator gives the same address with
+        // every compiler (operand evaluation order is unspecified)
+        std::uniform_int_distribution<uint64_t> bits;
+        uint64_t high = bits(rng);
+        uint64_t low = bits(rng);
+        detail::uint128 random = (detail::uint128(high) << 64) | low;
+        return detail::ipv6_from_host_order(base_ | (random & ~mask_for(length_)));
+    }
+
+    // Up to `parts` consecutive ranges covering the prefix, for parallel sweeps
+    std::vector<Range> split(size_t parts) const {
+        return detail::split_range(begin(), size(), parts);
+    }
+
+    std::string to_string() const;
+    static std::errc parse(std::string_view text, IPv6Prefix& value) noexcept;
+
+    constexpr bool operator==(const IPv6Prefix& other) const {
+        return base_ == other.base_ && length_ == other.length_;
+    }
+    constexpr bool operator!=(const IPv6Prefix& other) const { return !(*this == other); }
+
+private:
+    static constexpr detail::uint128 mask_for(uint8_t length) {
+        if (length > MAX_LENGTH) {
+            throw std::invalid_argument("IPv6 prefix length must be 0-128");
+        }
+        return length ? ~detail::uint128(0) << (MAX_LENGTH - length) : 0;
+    }
+
+    detail::uint128 base_ = 0;  // host order
+    uint8_t length_ = 0;
+};
+
+// "address/length" text, as for the address types. Host bits in parsed text
+// are cleared; the length is 0-32 or 0-128 without leading zeros.
+constexpr size_t IPV4_PREFIX_TEXT_SIZE = IPV4_TEXT_SIZE + 3;
+constexpr size_t IPV6_PREFIX_TEXT_SIZE = IPV6_TEXT_SIZE + 4;
+
+std::from_chars_result from_chars(const char* first, const char* last, IPv4Prefix& value) noexcept;
+std::from_chars_result from_chars(const char* first, const char* last, IPv6Prefix& value) noexcept;
+std::to_chars_result to_chars(char* first, char* last, const IPv4Prefix& value) noexcept;
+std::to_chars_result to_chars(char* first, char* last, const IPv6Prefix& value) noexcept;
+std::ostream& operator<<(std::ostream& os, const IPv4Prefix& value);
+std::ostream& operator<<(std::ostream& os, const IPv6Prefix& value);
+
+} // namespace cppscapy
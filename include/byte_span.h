@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace cppscapy {
+
+// Non-owning view of contiguous elements (a C++17 stand-in for std::span),
+// used wherever serialized bytes are written to or read from caller storage
+template <typename T>
+class Span {
+public:
+    constexpr Span() = default;
+    constexpr Span(T* data, size_t size) : data_(data), size_(size) {}
+    template <size_t N>
+    constexpr Span(T (&data)[N]) : data_(data), size_(N) {}
+    template <typename U, size_t N,
+              typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(std::array<U, N>& data) : data_(data.data()), size_(N) {}
+    template <typename U, size_t N,
+              typename = std::enable_if_t<std::is_convertible<const U (*)[], T (*)[]>::value>>
+    constexpr Span(const std::array<U, N>& data) : data_(data.data()), size_(N) {}
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    Span(std::vector<U>& data) : data_(data.data()), size_(data.size()) {}
+    template <typename U, typename = std::enable_if_t<std::is_convertible<const U (*)[], T (*)[]>::value>>
+    Span(const std::vector<U>& data) : data_(data.data()), size_(data.size()) {}
+    // Mutable spans convert to const ones
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(Span<U> other) : data_(other.data()), size_(other.size()) {}
+
+    constexpr T* data() const { return data_; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr T* begin() const { return data_; }
+    constexpr T* end() const { return data_ + size_; }
+    constexpr T& operator[](size_t index) const { return data_[index]; }
+
+    // Elements [offset, offset + count), clamped to the span
+    constexpr Span subspan(size_t offset, size_t count = static_cast<size_t>(-1)) const {
+        offset = offset < size_ ? offset : size_;
+        return Span(data_ + offset, count < size_ - offset ? count : size_ - offset);
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+using ByteSpan = Span<const uint8_t>;
+using MutableByteSpan = Span<uint8_t>;
+
+} // namespace cppscapy
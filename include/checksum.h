@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace cppscapy {
+namespace checksum {
+
+// Internet checksum (RFC 1071) kernels. The fastest one supported by the
+// running CPU is selected once via CPUID and used by every checksum path.
+enum class Kernel {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+// Kernel selected for this process
+Kernel active_kernel();
+
+// Whether the running CPU can execute a given kernel
+bool kernel_supported(Kernel kernel);
+
+// Human-readable kernel name ("scalar", "sse2", "avx2", "avx512")
+const char* kernel_name(Kernel kernel);
+
+// Fold a running sum into 16 bits with end-around carry
+constexpr uint16_t fold(uint64_t sum) {
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return static_cast<uint16_t>(sum);
+}
+
+// Fold and take the one's complement
+constexpr uint16_t finish(uint64_t sum) {
+    return static_cast<uint16_t>(~fold(sum));
+}
+
+// One's complement sum of data taken as big-endian 16-bit words (an odd
+// trailing byte is padded with zero). The result is folded to 16 bits but
+// not complemented, so partial sums can be chained through `initial`.
+uint16_t partial(const uint8_t* data, size_t length, uint32_t initial = 0);
+uint16_t partial(const std::vector<uint8_t>& data, uint32_t initial = 0);
+
+// Buffers of at least parallel_threshold() bytes (default 4 MiB, 0 disables)
+// are split into chunks summed on a worker pool; the result is identical to
+// a single-threaded sum. Every entry point built on partial() - segments,
+// UDP/TCP/ICMP checksums - picks this up.
+void set_parallel_threshold(size_t bytes);
+size_t parallel_threshold();
+
+// Threads used by a parallel sum, the caller included (0 = one per core).
+// The pool is started on first use.
+void set_parallel_threads(size_t threads);
+size_t parallel_threads();
+
+// Same as partial() but forces a specific kernel (for testing and benchmarks).
+// Throws std::invalid_argument if the CPU does not support the kernel.
+uint16_t partial_with(Kernel kernel, const uint8_t* data, size_t length, uint32_t initial = 0);
+
+// Fused copy + checksum (like the kernel's csum_partial_copy): copies
+// `length` bytes from `src` to `dst` and returns partial(src, length, initial),
+// reading the source only once. Buffers must not overlap.
+uint16_t partial_copy(uint8_t* dst, const uint8_t* src, size_t length, uint32_t initial = 0);
+uint16_t partial_copy_with(Kernel kernel, uint8_t* dst, const uint8_t* src, size_t length,
+                           uint32_t initial = 0);
+
+// Partial sums of `count` fixed-size (IHL 5, 20-byte) IPv4 headers, several
+// headers per SIMD step using a transposed layout; sums[i] equals
+// partial(headers[i], 20). A valid header sums to 0xFFFF.
+void partial_ipv4_headers(const uint8_t* const* headers, size_t count, uint16_t* sums);
+void partial_ipv4_headers_with(Kernel kernel, const uint8_t* const* headers, size_t count,
+                               uint16_t* sums);
+
+// A partial sum of bytes that start at an odd offset of the checksummed
+// data: the bytes landed in the other half of each 16-bit word
+constexpr uint16_t swap_sum(uint16_t sum) {
+    return static_cast<uint16_t>((sum >> 8) | (sum << 8));
+}
+
+// Complete Internet checksum of a buffer (checksum field must be zero)
+uint16_t compute(const uint8_t* data, size_t length);
+uint16_t compute(const std::vector<uint8_t>& data);
+
+// Scatter-gather checksum over non-contiguous pieces of one logical buffer.
+// Segments may have any length; a segment that starts at an odd offset of
+// the logical buffer has its sum byte-swapped so the result equals the sum
+// over the concatenation, without copying anything.
+struct Segment {
+    const uint8_t* data;
+    size_t length;
+};
+
+uint16_t partial(const Segment* segments, size_t count, uint32_t initial = 0);
+uint16_t partial(std::initializer_list<Segment> segments, uint32_t initial = 0);
+uint16_t compute(std::initializer_list<Segment> segments);
+
+// Compile-time counterparts of partial()/compute() for fixed-size data such
+// as serialized headers. These are a plain scalar loop; at run time use the
+// pointer overloads for anything larger than a few headers.
+template <size_t N>
+constexpr uint16_t partial(const std::array<uint8_t, N>& data, uint32_t initial = 0) {
+    uint64_t sum = initial;
+    for (size_t i = 0; i + 1 < N; i += 2) {
+        sum += (data[i] << 8) | data[i + 1];
+    }
+    if constexpr (N % 2 != 0) {
+        sum += data[N - 1] << 8;
+    }
+    return fold(sum);
+}
+
+template <size_t N>
+constexpr uint16_t compute(const std::array<uint8_t, N>& data) {
+    return finish(partial(data));
+}
+
+// Partial sums of the transport pseudo-headers, computed directly from the
+// address bytes (network order) without building the header
+constexpr uint16_t pseudo_header_ipv4(const uint8_t* src, const uint8_t* dst, uint8_t protocol,
+                                      uint16_t length) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < 4; i += 2) {
+        sum += (src[i] << 8) | src[i + 1];
+        sum += (dst[i] << 8) | dst[i + 1];
+    }
+    sum += protocol;
+    sum += length;
+    return fold(sum);
+}
+
+constexpr uint16_t pseudo_header_ipv6(const uint8_t* src, const uint8_t* dst, uint8_t next_header,
+                                      uint32_t length) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < 16; i += 2) {
+        sum += (src[i] << 8) | src[i + 1];
+        sum += (dst[i] << 8) | dst[i + 1];
+    }
+    sum += length >> 16;
+    sum += length & 0xFFFF;
+    sum += next_header;
+    return fold(sum);
+}
+
+// RFC 1624 incremental updates: given the checksum currently stored in a
+// header, return the checksum after replacing `old_value` with `new_value`
+// (eqn. 3: HC' = ~(~HC + ~m + m')). Values are in host order and must sit
+// at an even offset from the start of the checksummed data.
+constexpr uint16_t adjust(uint16_t checksum, uint16_t old_word, uint16_t new_word) {
+    uint64_t sum = static_cast<uint16_t>(~checksum);
+    sum += static_cast<uint16_t>(~old_word);
+    sum += new_word;
+    return finish(sum);
+}
+
+constexpr uint16_t adjust32(uint16_t checksum, uint32_t old_value, uint32_t new_value) {
+    uint64_t sum = static_cast<uint16_t>(~checksum);
+    sum += static_cast<uint16_t>(~(old_value >> 16));
+    sum += static_cast<uint16_t>(~old_value);
+    sum += new_value >> 16;
+    sum += new_value & 0xFFFF;
+    return finish(sum);
+}
+
+// Replace `length` bytes (even) in network order, e.g. a 128-bit IPv6 address
+uint16_t adjust_bytes(uint16_t checksum, const uint8_t* old_bytes, const uint8_t* new_bytes, size_t length);
+
+inline uint16_t adjust128(uint16_t checksum, const std::array<uint8_t, 16>& old_addr,
+                          const std::array<uint8_t, 16>& new_addr) {
+    return adjust_bytes(checksum, old_addr.data(), new_addr.data(), 16);
+}
+
+} // namespace checksum
+} // namespace cppscapy
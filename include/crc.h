@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cppscapy {
+namespace crc {
+
+// CRC implementations. Each algorithm has a table-driven software kernel and
+// a hardware kernel selected once via CPUID when the CPU supports it.
+enum class Kernel {
+    Software,
+    Hardware
+};
+
+// CRC32c (Castagnoli, reflected polynomial 0x82F63B78), used by SCTP and
+// iSCSI. `crc` is the result of a previous call, so a message can be
+// processed in pieces: crc32c(b, nb, crc32c(a, na)) == crc32c(a + b).
+// Hardware kernel: SSE4.2 crc32 instruction, three streams interleaved on
+// long buffers. Software kernel: slice-by-8.
+uint32_t crc32c(const uint8_t* data, size_t length, uint32_t crc = 0);
+uint32_t crc32c(const std::vector<uint8_t>& data, uint32_t crc = 0);
+
+// Kernel selected for CRC32c in this process
+Kernel crc32c_kernel();
+bool crc32c_supported(Kernel kernel);
+
+// Same as crc32c() with a specific kernel (for testing and benchmarks).
+// Throws std::invalid_argument if the CPU does not support the kernel.
+uint32_t crc32c_with(Kernel kernel, const uint8_t* data, size_t length, uint32_t crc = 0);
+
+// IEEE 802.3 CRC32 (reflected polynomial 0xEDB88320), as used by the
+// Ethernet FCS, zlib and PNG; chaining works like crc32c().
+// Hardware kernel: PCLMULQDQ folding. Software kernel: slice-by-16.
+uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0);
+uint32_t crc32(const std::vector<uint8_t>& data, uint32_t crc = 0);
+
+Kernel crc32_kernel();
+bool crc32_supported(Kernel kernel);
+uint32_t crc32_with(Kernel kernel, const uint8_t* data, size_t length, uint32_t crc = 0);
+
+// Ethernet frame check sequence over a frame without its FCS
+uint32_t ethernet_fcs(const uint8_t* frame, size_t length);
+
+// Append the 4-byte FCS (least significant byte first). With `pad`, frames
+// shorter than the 60-byte minimum are zero padded first.
+void append_fcs(std::vector<uint8_t>& frame, bool pad = true);
+
+// Whether the last 4 bytes of a frame are its correct FCS
+bool verify_fcs(const uint8_t* frame, size_t length);
+bool verify_fcs(const std::vector<uint8_t>& frame);
+
+// SCTP (RFC 4960) transmits the CRC32c least significant byte first. This is
+// the value of the checksum field read as a big-endian 32-bit number, as
+// used by header accessors.
+constexpr uint32_t sctp_field_value(uint32_t crc) {
+    return ((crc & 0xFF) << 24) | ((crc & 0xFF00) << 8) |
+           ((crc >> 8) & 0xFF00) | (crc >> 24);
+}
+
+// Checksum of an SCTP packet (common header + chunks) with the stored
+// checksum field taken as zero, returned as sctp_field_value(). The packet
+// is not copied or modified.
+uint32_t sctp_checksum(const uint8_t* sctp, size_t length);
+
+// Whether the checksum stored in an SCTP packet is correct
+bool verify_sctp_checksum(const uint8_t* sctp, size_t length);
+
+} // namespace crc
+} // namespace cppscapy
@@ -7,6 +7,7 @@
 #include <bitset>
 #include <string>
 #include <type_traits>
+#include "crc.h"
 
 namespace cppscapy::dsl {
 
@@ -1629,8 +1630,23 @@ public:
     bool is_valid() const override { return data_.size() == 12; }
     
     void update_computed_fields() override {
-        // Update checksum field
-        // TODO: Implement checksum calculation
+        // checksum also covers the payload, which this header does not
+        // hold; it is left as is, callers use update_checksum(payload)
+    }
+    
+    // CRC32c over this header and the payload that follows it
+    void update_checksum(const std::vector<uint8_t>& payload) {
+        set_checksum(0);
+        uint32_t crc = crc::crc32c(data_);
+        crc = crc::crc32c(payload, crc);
+        set_checksum(crc::sctp_field_value(crc));
+    }
+    
+    // Whether the stored value matches this header and the payload
+    bool verify_checksum(const std::vector<uint8_t>& payload) const {
+        SCTPHeader copy = *this;
+        copy.update_checksum(payload);
+        return copy.checksum() == checksum();
     }
     
 private:
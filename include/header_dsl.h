@@ -1,7 +1,10 @@
 #pragma once
 
+#include "checksum.h"
+#include "network_headers.h"
 #include <bitset>
 #include <cstdint>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -259,6 +262,12 @@ public:
   void set_dst_ip(const std::string &ip) {
     set_dst_ip(ip_string_to_uint32(ip));
   }
+  void set_src_ip(const IPv4Address &ip) {
+    set_src_ip(detail::network_order32(ip.to_uint32()));
+  }
+  void set_dst_ip(const IPv4Address &ip) {
+    set_dst_ip(detail::network_order32(ip.to_uint32()));
+  }
 
   std::vector<uint8_t> to_bytes() const override { return data_; }
   bool from_bytes(const std::vector<uint8_t> &bytes) override {
@@ -274,22 +283,7 @@ public:
   void update_computed_fields() override {
     // Calculate header checksum
     set_header_checksum(0); // Clear checksum first
-    uint32_t sum = 0;
-
-    // Sum all 16-bit words in the header
-    for (size_t i = 0; i < 20; i += 2) {
-      uint16_t word = (data_[i] << 8) | data_[i + 1];
-      sum += word;
-    }
-
-    // Add carry
-    while (sum >> 16) {
-      sum = (sum & 0xFFFF) + (sum >> 16);
-    }
-
-    // One's complement
-    uint16_t checksum = ~sum;
-    set_header_checksum(checksum);
+    set_header_checksum(checksum::compute(data_.data(), 20));
   }
 
 private:
@@ -297,24 +291,16 @@ private:
 
   // Helper function to convert IP string to uint32_t
   uint32_t ip_string_to_uint32(const std::string &ip) const {
-    uint32_t result = 0;
-    size_t start = 0;
-    int shift = 24;
-
-    for (int i = 0; i < 4; ++i) {
-      size_t end = ip.find('.', start);
-      if (end == std::string::npos)
-        end = ip.length();
-
-      uint32_t octet = std::stoul(ip.substr(start, end - start));
-      result |= (octet << shift);
-
-      start = end + 1;
-      shift -= 8;
+    IPv4Address address;
+    if (IPv4Address::parse(ip, address) != std::errc()) {
+      throw std::invalid_argument("Invalid IPv4 address format");
     }
-
-    return result;
+    auto bytes = address.to_bytes();
+    return (static_cast<uint32_t>(bytes[0]) << 24) |
+           (static_cast<uint32_t>(bytes[1]) << 16) |
+           (static_cast<uint32_t>(bytes[2]) << 8) | bytes[3];
   }
+
 };
 
 // Generated from DSL: header UDPHeader with computed fields
@@ -494,13 +480,34 @@ public:
     return data_.size() >= 20 && data_offset() >= 5;
   }
 
+  // Compute the checksum over the IPv4 pseudo-header, this header and the
+  // payload; the payload is summed in place
+  void update_checksum(uint32_t src_ip, uint32_t dst_ip,
+                       const std::vector<uint8_t> &payload = {}) {
+    const uint8_t src[4] = {
+        static_cast<uint8_t>(src_ip >> 24), static_cast<uint8_t>(src_ip >> 16),
+        static_cast<uint8_t>(src_ip >> 8), static_cast<uint8_t>(src_ip)};
+    const uint8_t dst[4] = {
+        static_cast<uint8_t>(dst_ip >> 24), static_cast<uint8_t>(dst_ip >> 16),
+        static_cast<uint8_t>(dst_ip >> 8), static_cast<uint8_t>(dst_ip)};
+
+    BitField<uint16_t>(data_, 128, 16).set(0);
+    uint16_t pseudo_sum = checksum::pseudo_header_ipv4(
+        src, dst, 6, static_cast<uint16_t>(data_.size() + payload.size()));
+    uint16_t value = checksum::finish(checksum::partial(
+        {{data_.data(), data_.size()}, {payload.data(), payload.size()}},
+        pseudo_sum));
+    BitField<uint16_t>(data_, 128, 16).set(value);
+  }
+
   void update_computed_fields() override {
     // Set default data offset if not set
     if (data_offset() == 0) {
       set_data_offset(5); // 20 bytes = 5 * 4-byte words
     }
-    // TODO: Calculate checksum
-    BitField<uint16_t>(data_, 128, 16).set(0); // Placeholder
+    // The checksum covers the pseudo-header and the payload, neither of
+    // which this header knows; update_checksum(src, dst, payload) fills it
+    BitField<uint16_t>(data_, 128, 16).set(0);
   }
 
 private:
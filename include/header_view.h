@@ -0,0 +1,488 @@
+#pragma once
+
+#include "network_headers.h"
+#include "packet_patch.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace cppscapy {
+
+// Non-owning views of headers in a raw buffer. A view is a pointer to the
+// first byte of the header plus the number of bytes available from there;
+// every accessor decodes its field straight from the buffer when called, so
+// reading a field is a single load and nothing is copied.
+//
+// The constructors do not check anything. parse() validates the buffer the
+// same way the header classes' parse() does and returns a ParseResult.
+//
+// Mutable* views edit fields in place. Setters that the packet_patch.h
+// helpers cover fix every checksum over the field incrementally (RFC 1624),
+// so an IPv4 view of a whole datagram also keeps its TCP/UDP checksum valid
+// after an address change. update_checksum() recomputes from scratch.
+//
+// Transport views should span the IP payload (Ipv4View::payload()) rather
+// than the rest of the frame, so Ethernet padding is not summed.
+
+namespace detail {
+    template <typename View, typename Byte>
+    constexpr ParseResult<View> make_view(Byte* data, size_t length) {
+        ParseError error = View::check(data, length);
+        if (error != ParseError::None) {
+            return error;
+        }
+        return View(data, length);
+    }
+
+    // Bytes [start, end) of a header's buffer, clamped to what is there
+    constexpr ByteSpan clamp_span(const uint8_t* data, size_t length, size_t start, size_t end) {
+        end = end < length ? end : length;
+        return start < end ? ByteSpan(data + start, end - start) : ByteSpan();
+    }
+
+    inline MutableByteSpan as_mutable(ByteSpan span) {
+        return MutableByteSpan(const_cast<uint8_t*>(span.data()), span.size());
+    }
+}
+
+// Ethernet
+class EthernetView {
+public:
+    constexpr EthernetView() = default;
+    constexpr EthernetView(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+    static constexpr ParseError check(const uint8_t*, size_t length) {
+        return length < EthernetHeader::SIZE ? ParseError::Truncated : ParseError::None;
+    }
+    static constexpr ParseResult<EthernetView> parse(const uint8_t* data, size_t length) {
+        return detail::make_view<EthernetView>(data, length);
+    }
+
+    constexpr MacAddress dst() const { return MacAddress(detail::load_bytes<6>(data_)); }
+    constexpr MacAddress src() const { return MacAddress(detail::load_bytes<6>(data_ + 6)); }
+    constexpr uint16_t ethertype() const { return detail::load16(data_ + 12); }
+
+    constexpr const uint8_t* data() const { return data_; }
+    constexpr size_t size() const { return length_; }
+    constexpr ByteSpan payload() const { return detail::clamp_span(data_, length_, EthernetHeader::SIZE, length_); }
+    constexpr EthernetHeader decode() const { return *EthernetHeader::parse(data_, length_); }
+
+protected:
+    const uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+};
+
+class MutableEthernetView : public EthernetView {
+public:
+    MutableEthernetView() = default;
+    MutableEthernetView(uint8_t* data, size_t length) : EthernetView(data, length) {}
+
+    static ParseResult<MutableEthernetView> parse(uint8_t* data, size_t length) {
+        return detail::make_view<MutableEthernetView>(data, length);
+    }
+
+    using EthernetView::dst;
+    using EthernetView::src;
+    using EthernetView::ethertype;
+    MutableEthernetView& dst(const MacAddress& mac) { detail::copy_out(data(), mac.to_bytes()); return *this; }
+    MutableEthernetView& src(const MacAddress& mac) { detail::copy_out(data() + 6, mac.to_bytes()); return *this; }
+    MutableEthernetView& ethertype(uint16_t type) { detail::store16(data() + 12, type); return *this; }
+
+    uint8_t* data() const { return const_cast<uint8_t*>(data_); }
+    MutableByteSpan payload() const { return detail::as_mutable(EthernetView::payload()); }
+};
+
+// IPv4; the payload ends at the total length
+class Ipv4View {
+public:
+    constexpr Ipv4View() = default;
+    constexpr Ipv4View(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+    static constexpr ParseError check(const uint8_t* data, size_t length) {
+        if (length < IPv4Header::MIN_SIZE) {
+            return ParseError::Truncated;
+        }
+        if ((data[0] >> 4) != 4) {
+            return ParseError::BadVersion;
+        }
+        if ((data[0] & 0x0F) < 5) {
+            return ParseError::BadLength;
+        }
+        return (data[0] & 0x0F) * 4u > length ? ParseError::Truncated : ParseError::None;
+    }
+    static constexpr ParseResult<Ipv4View> parse(const uint8_t* data, size_t length) {
+        return detail::make_view<Ipv4View>(data, length);
+    }
+
+    constexpr uint8_t version() const { return data_[0] >> 4; }
+    constexpr uint8_t ihl() const { return data_[0] & 0x0F; }
+    constexpr size_t header_length() const { return ihl() * 4u; }
+    constexpr uint8_t tos() const { return data_[1]; }
+    constexpr uint16_t length() const { return detail::load16(data_ + 2); }
+    constexpr uint16_t id() const { return detail::load16(data_ + 4); }
+    constexpr uint8_t flags() const { return data_[6] >> 5; }
+    constexpr uint16_t fragment_offset() const { return detail::load16(data_ + 6) & 0x1FFF; }
+    constexpr uint8_t ttl() const { return data_[8]; }
+    constexpr uint8_t protocol() const { return data_[9]; }
+    constexpr uint16_t checksum() const { return detail::load16(data_ + 10); }
+    constexpr IPv4Address src() const { return IPv4Address(detail::network_order32(detail::load32(data_ + 12))); }
+    constexpr IPv4Address dst() const { return IPv4Address(detail::network_order32(detail::load32(data_ + 16))); }
+
+    bool checksum_valid() const { return checksum::partial(data_, header_length()) == 0xFFFF; }
+
+    constexpr const uint8_t* data() const { return data_; }
+    constexpr size_t size() const { return length_; }
+    constexpr ByteSpan options() const {
+        return detail::clamp_span(data_, length_, IPv4Header::MIN_SIZE, header_length());
+    }
+    constexpr ByteSpan payload() const { return detail::clamp_span(data_, length_, header_length(), length()); }
+    constexpr IPv4Header decode() const { return *IPv4Header::parse(data_, length_); }
+
+protected:
+    const uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+};
+
+class MutableIpv4View : public Ipv4View {
+public:
+    MutableIpv4View() = default;
+    MutableIpv4View(uint8_t* data, size_t length) : Ipv4View(data, length) {}
+
+    static ParseResult<MutableIpv4View> parse(uint8_t* data, size_t length) {
+        return detail::make_view<MutableIpv4View>(data, length);
+    }
+
+    using Ipv4View::tos;
+    using Ipv4View::length;
+    using Ipv4View::id;
+    using Ipv4View::ttl;
+    using Ipv4View::src;
+    using Ipv4View::dst;
+    MutableIpv4View& tos(uint8_t tos) { patch::set_ipv4_tos(data(), tos); return *this; }
+    MutableIpv4View& length(uint16_t length);
+    MutableIpv4View& id(uint16_t id) { patch::set_ipv4_id(data(), id); return *this; }
+    MutableIpv4View& ttl(uint8_t ttl) { patch::set_ipv4_ttl(data(), ttl); return *this; }
+    // Also adjusts the TCP/UDP checksum when the transport header is in view
+    MutableIpv4View& src(const IPv4Address& addr) { patch::set_ipv4_src(data(), length_, addr); return *this; }
+    MutableIpv4View& dst(const IPv4Address& addr) { patch::set_ipv4_dst(data(), length_, addr); return *this; }
+
+    MutableIpv4View& update_checksum();
+
+    uint8_t* data() const { return const_cast<uint8_t*>(data_); }
+    MutableByteSpan payload() const { return detail::as_mutable(Ipv4View::payload()); }
+};
+
+// IPv6; the payload ends at the payload length
+class Ipv6View {
+public:
+    constexpr Ipv6View() = default;
+    constexpr Ipv6View(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+    static constexpr ParseError check(const uint8_t* data, size_t length) {
+        if (length < IPv6Header::SIZE) {
+            return ParseError::Truncated;
+        }
+        return (data[0] >> 4) != 6 ? ParseError::BadVersion : ParseError::None;
+    }
+    static constexpr ParseResult<Ipv6View> parse(const uint8_t* data, size_t length) {
+        return detail::make_view<Ipv6View>(data, length);
+    }
+
+    constexpr uint8_t version() const { return data_[0] >> 4; }
+    constexpr uint8_t traffic_class() const { return static_cast<uint8_t>(detail::load16(data_) >> 4); }
+    constexpr uint32_t flow_label() const { return detail::load32(data_) & 0xFFFFF; }
+    constexpr uint16_t payload_length() const { return detail::load16(data_ + 4); }
+    constexpr uint8_t next_header() const { return data_[6]; }
+    constexpr uint8_t hop_limit() const { return data_[7]; }
+    constexpr IPv6Address src() const { return IPv6Address(detail::load_bytes<16>(data_ + 8)); }
+    constexpr IPv6Address dst() const { return IPv6Address(detail::load_bytes<16>(data_ + 24)); }
+
+    constexpr const uint8_t* data() const { return data_; }
+    constexpr size_t size() const { return length_; }
+    constexpr ByteSpan payload() const {
+        return detail::clamp_span(data_, length_, IPv6Header::SIZE, IPv6Header::SIZE + payload_length());
+    }
+    constexpr IPv6Header decode() const { return *IPv6Header::parse(data_, length_); }
+
+protected:
+    const uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+};
+
+class MutableIpv6View : public Ipv6View {
+public:
+    MutableIpv6View() = default;
+    MutableIpv6View(uint8_t* data, size_t length) : Ipv6View(data, length) {}
+
+    static ParseResult<MutableIpv6View> parse(uint8_t* data, size_t length) {
+        return detail::make_view<MutableIpv6View>(data, length);
+    }
+
+    using Ipv6View::traffic_class;
+    using Ipv6View::flow_label;
+    using Ipv6View::payload_length;
+    using Ipv6View::hop_limit;
+    using Ipv6View::src;
+    using Ipv6View::dst;
+    // None of these is covered by a checksum
+    MutableIpv6View& traffic_class(uint8_t tc);
+    MutableIpv6View& flow_label(uint32_t label);
+    MutableIpv6View& payload_length(uint16_t length) { detail::store16(data() + 4, length); return *this; }
+    MutableIpv6View& hop_limit(uint8_t hops) { data()[7] = hops; return *this; }
+    // Adjusts the TCP/UDP/ICMPv6 checksum when the transport header is in view
+    MutableIpv6View& src(const IPv6Address& addr) { patch::set_ipv6_src(data(), length_, addr); return *this; }
+    MutableIpv6View& dst(const IPv6Address& addr) { patch::set_ipv6_dst(data(), length_, addr); return *this; }
+
+    uint8_t* data() const { return const_cast<uint8_t*>(data_); }
+    MutableByteSpan payload() const { return detail::as_mutable(Ipv6View::payload()); }
+};
+
+// MPLS label stack entry
+class MplsView {
+public:
+    constexpr MplsView() = default;
+    constexpr MplsView(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+    static constexpr ParseError check(const uint8_t*, size_t length) {
+        return length < MPLSHeader::SIZE ? ParseError::Truncated : ParseError::None;
+    }
+    static constexpr ParseResult<MplsView> parse(const uint8_t* data, size_t length) {
+        return detail::make_view<MplsView>(data, length);
+    }
+
+    constexpr uint32_t label() const { return detail::load32(data_) >> 12; }
+    constexpr uint8_t traffic_class() const { return (data_[2] >> 1) & 0x7; }
+    constexpr bool bottom_of_stack() const { return (data_[2] & 1) != 0; }
+    constexpr uint8_t ttl() const { return data_[3]; }
+
+    constexpr const uint8_t* data() const { return data_; }
+    constexpr size_t size() const { return length_; }
+    // The next label stack entry, or what the bottom entry carries
+    constexpr ByteSpan payload() const { return detail::clamp_span(data_, length_, MPLSHeader::SIZE, length_); }
+    constexpr MPLSHeader decode() const { return *MPLSHeader::parse(data_, length_); }
+
+protected:
+    const uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+};
+
+class MutableMplsView : public MplsView {
+public:
+    MutableMplsView() = default;
+    MutableMplsView(uint8_t* data, size_t length) : MplsView(data, length) {}
+
+    static ParseResult<MutableMplsView> parse(uint8_t* data, size_t length) {
+        return detail::make_view<MutableMplsView>(data, length);
+    }
+
+    using MplsView::label;
+    using MplsView::traffic_class;
+    using MplsView::bottom_of_stack;
+    using MplsView::ttl;
+    MutableMplsView& label(uint32_t label);
+    MutableMplsView& traffic_class(uint8_t tc) {
+        data()[2] = static_cast<uint8_t>((data()[2] & 0xF1) | ((tc & 0x7) << 1));
+        return *this;
+    }
+    MutableMplsView& bottom_of_stack(bool bos) {
+        data()[2] = static_cast<uint8_t>((data()[2] & 0xFE) | (bos ? 1 : 0));
+        return *this;
+    }
+    MutableMplsView& ttl(uint8_t ttl) { data()[3] = ttl; return *this; }
+
+    uint8_t* data() const { return const_cast<uint8_t*>(data_); }
+    MutableByteSpan payload() const { return detail::as_mutable(MplsView::payload()); }
+};
+
+// TCP; the view's extent is the segment the checksum covers
+class TcpView {
+public:
+    constexpr TcpView() = default;
+    constexpr TcpView(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+    static constexpr ParseError check(const uint8_t* data, size_t length) {
+        if (length < TCPHeader::MIN_SIZE) {
+            return ParseError::Truncated;
+        }
+        if ((data[12] >> 4) < 5) {
+            return ParseError::BadLength;
+        }
+        return (data[12] >> 4) * 4u > length ? ParseError::Truncated : ParseError::None;
+    }
+    static constexpr ParseResult<TcpView> parse(const uint8_t* data, size_t length) {
+        return detail::make_view<TcpView>(data, length);
+    }
+
+    constexpr uint16_t src_port() const { return detail::load16(data_); }
+    constexpr uint16_t dst_port() const { return detail::load16(data_ + 2); }
+    constexpr uint32_t seq_num() const { return detail::load32(data_ + 4); }
+    constexpr uint32_t ack_num() const { return detail::load32(data_ + 8); }
+    constexpr uint8_t data_offset() const { return data_[12] >> 4; }
+    constexpr size_t header_length() const { return data_offset() * 4u; }
+    constexpr uint8_t flags() const { return data_[13]; }
+    constexpr uint16_t window_size() const { return detail::load16(data_ + 14); }
+    constexpr uint16_t checksum() const { return detail::load16(data_ + 16); }
+    constexpr uint16_t urgent_ptr() const { return detail::load16(data_ + 18); }
+
+    bool checksum_valid(const IPv4Address& src, const IPv4Address& dst) const;
+    bool checksum_valid(const IPv6Address& src, const IPv6Address& dst) const;
+
+    constexpr const uint8_t* data() const { return data_; }
+    constexpr size_t size() const { return length_; }
+    constexpr ByteSpan options() const {
+        return detail::clamp_span(data_, length_, TCPHeader::MIN_SIZE, header_length());
+    }
+    constexpr ByteSpan payload() const { return detail::clamp_span(data_, length_, header_length(), length_); }
+    constexpr TCPHeader decode() const { return *TCPHeader::parse(data_, length_); }
+
+protected:
+    const uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+};
+
+class MutableTcpView : public TcpView {
+public:
+    MutableTcpView() = default;
+    MutableTcpView(uint8_t* data, size_t length) : TcpView(data, length) {}
+
+    static ParseResult<MutableTcpView> parse(uint8_t* data, size_t length) {
+        return detail::make_view<MutableTcpView>(data, length);
+    }
+
+    using TcpView::src_port;
+    using TcpView::dst_port;
+    using TcpView::seq_num;
+    using TcpView::ack_num;
+    using TcpView::flags;
+    using TcpView::window_size;
+    MutableTcpView& src_port(uint16_t port) { patch::set_tcp_src_port(data(), port); return *this; }
+    MutableTcpView& dst_port(uint16_t port) { patch::set_tcp_dst_port(data(), port); return *this; }
+    MutableTcpView& seq_num(uint32_t seq) { patch::set_tcp_seq_num(data(), seq); return *this; }
+    MutableTcpView& ack_num(uint32_t ack) { patch::set_tcp_ack_num(data(), ack); return *this; }
+    MutableTcpView& flags(uint8_t flags) { patch::set_tcp_flags(data(), flags); return *this; }
+    MutableTcpView& window_size(uint16_t window) { patch::set_tcp_window_size(data(), window); return *this; }
+    // No-op when the segment has no timestamp option
+    MutableTcpView& timestamps(uint32_t value, uint32_t echo_reply) {
+        patch::set_tcp_timestamps(data(), value, echo_reply);
+        return *this;
+    }
+
+    MutableTcpView& update_checksum(const IPv4Address& src, const IPv4Address& dst);
+    MutableTcpView& update_checksum(const IPv6Address& src, const IPv6Address& dst);
+
+    uint8_t* data() const { return const_cast<uint8_t*>(data_); }
+    MutableByteSpan payload() const { return detail::as_mutable(TcpView::payload()); }
+};
+
+// UDP; the datagram ends at the UDP length
+class UdpView {
+public:
+    constexpr UdpView() = default;
+    constexpr UdpView(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+    static constexpr ParseError check(const uint8_t*, size_t length) {
+        return length < UDPHeader::SIZE ? ParseError::Truncated : ParseError::None;
+    }
+    static constexpr ParseResult<UdpView> parse(const uint8_t* data, size_t length) {
+        return detail::make_view<UdpView>(data, length);
+    }
+
+    constexpr uint16_t src_port() const { return detail::load16(data_); }
+    constexpr uint16_t dst_port() const { return detail::load16(data_ + 2); }
+    constexpr uint16_t length() const { return detail::load16(data_ + 4); }
+    constexpr uint16_t checksum() const { return detail::load16(data_ + 6); }
+
+    // Over IPv4 a zero checksum means none was computed and is valid
+    bool checksum_valid(const IPv4Address& src, const IPv4Address& dst) const;
+    bool checksum_valid(const IPv6Address& src, const IPv6Address& dst) const;
+
+    constexpr const uint8_t* data() const { return data_; }
+    constexpr size_t size() const { return length_; }
+    constexpr ByteSpan payload() const { return detail::clamp_span(data_, length_, UDPHeader::SIZE, length()); }
+    constexpr UDPHeader decode() const { return *UDPHeader::parse(data_, length_); }
+
+protected:
+    // UDP length when it is sane, else everything in view
+    constexpr size_t datagram_length() const {
+        return length() >= UDPHeader::SIZE && length() <= length_ ? length() : length_;
+    }
+
+    const uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+};
+
+class MutableUdpView : public UdpView {
+public:
+    MutableUdpView() = default;
+    MutableUdpView(uint8_t* data, size_t length) : UdpView(data, length) {}
+
+    static ParseResult<MutableUdpView> parse(uint8_t* data, size_t length) {
+        return detail::make_view<MutableUdpView>(data, length);
+    }
+
+    using UdpView::src_port;
+    using UdpView::dst_port;
+    MutableUdpView& src_port(uint16_t port) { patch::set_udp_src_port(data(), port); return *this; }
+    MutableUdpView& dst_port(uint16_t port) { patch::set_udp_dst_port(data(), port); return *this; }
+
+    MutableUdpView& update_checksum(const IPv4Address& src, const IPv4Address& dst);
+    MutableUdpView& update_checksum(const IPv6Address& src, const IPv6Address& dst);
+
+    uint8_t* data() const { return const_cast<uint8_t*>(data_); }
+    MutableByteSpan payload() const { return detail::as_mutable(UdpView::payload()); }
+};
+
+// ICMP / ICMPv6; the view's extent is the message the checksum covers
+class IcmpView {
+public:
+    constexpr IcmpView() = default;
+    constexpr IcmpView(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+    static constexpr ParseError check(const uint8_t*, size_t length) {
+        return length < ICMPHeader::MIN_SIZE ? ParseError::Truncated : ParseError::None;
+    }
+    static constexpr ParseResult<IcmpView> parse(const uint8_t* data, size_t length) {
+        return detail::make_view<IcmpView>(data, length);
+    }
+
+    constexpr uint8_t type() const { return data_[0]; }
+    constexpr uint8_t code() const { return data_[1]; }
+    constexpr uint16_t checksum() const { return detail::load16(data_ + 2); }
+    constexpr uint16_t identifier() const { return detail::load16(data_ + 4); }
+    constexpr uint16_t sequence() const { return detail::load16(data_ + 6); }
+
+    bool checksum_valid() const;
+    bool checksum_valid(const IPv6Address& src, const IPv6Address& dst) const;  // ICMPv6
+
+    constexpr const uint8_t* data() const { return data_; }
+    constexpr size_t size() const { return length_; }
+    constexpr ByteSpan payload() const { return detail::clamp_span(data_, length_, ICMPHeader::MIN_SIZE, length_); }
+    constexpr ICMPHeader decode() const { return *ICMPHeader::parse(data_, length_); }
+
+protected:
+    const uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+};
+
+class MutableIcmpView : public IcmpView {
+public:
+    MutableIcmpView() = default;
+    MutableIcmpView(uint8_t* data, size_t length) : IcmpView(data, length) {}
+
+    static ParseResult<MutableIcmpView> parse(uint8_t* data, size_t length) {
+        return detail::make_view<MutableIcmpView>(data, length);
+    }
+
+    using IcmpView::identifier;
+    using IcmpView::sequence;
+    MutableIcmpView& identifier(uint16_t id) { patch::set_icmp_identifier(data(), id); return *this; }
+    MutableIcmpView& sequence(uint16_t seq) { patch::set_icmp_sequence(data(), seq); return *this; }
+
+    MutableIcmpView& update_checksum();
+    MutableIcmpView& update_checksum(const IPv6Address& src, const IPv6Address& dst);  // ICMPv6
+
+    uint8_t* data() const { return const_cast<uint8_t*>(data_); }
+    MutableByteSpan payload() const { return detail::as_mutable(IcmpView::payload()); }
+};
+
+} // namespace cppscapy
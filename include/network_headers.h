@@ -4,7 +4,15 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <initializer_list>
+#include <charconv>
+#include <iosfwd>
 #include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include "byte_span.h"
+#include "checksum.h"
 
 namespace cppscapy {
 
@@ -17,22 +25,196 @@ class TCPHeader;
 class UDPHeader;
 class ICMPHeader;
 
+namespace detail {
+    // Network <-> host order of a 32-bit value, usable in constant expressions
+    constexpr uint32_t network_order32(uint32_t value) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        return ((value & 0xFF) << 24) | ((value & 0xFF00) << 8) |
+               ((value >> 8) & 0xFF00) | (value >> 24);
+#else
+        return value;
+#endif
+    }
+    
+    // Bit scans (the argument must not be zero) and a byte swap: compiler
+    // builtins on GCC and Clang, plain loops and shifts elsewhere, so they
+    // stay usable in constant expressions everywhere
+    constexpr unsigned ctz32(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctz(value));
+#else
+        unsigned count = 0;
+        for (; (value & 1) == 0; value >>= 1) {
+            ++count;
+        }
+        return count;
+#endif
+    }
+    
+    constexpr unsigned ctz64(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(value));
+#else
+        return static_cast<uint32_t>(value) != 0 ? ctz32(static_cast<uint32_t>(value))
+                                                 : 32 + ctz32(static_cast<uint32_t>(value >> 32));
+#endif
+    }
+    
+    constexpr unsigned clz32(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_clz(value));
+#else
+        unsigned count = 0;
+        for (; (value & 0x80000000u) == 0; value <<= 1) {
+            ++count;
+        }
+        return count;
+#endif
+    }
+    
+    constexpr uint64_t bswap64(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_bswap64(value);
+#else
+        uint64_t swapped = 0;
+        for (int i = 0; i < 8; ++i, value >>= 8) {
+            swapped = (swapped << 8) | (value & 0xFF);
+        }
+        return swapped;
+#endif
+    }
+    
+    // Big-endian stores into a fixed-size wire image
+    template <size_t N>
+    constexpr void store16(std::array<uint8_t, N>& bytes, size_t offset, uint16_t value) {
+        bytes[offset] = static_cast<uint8_t>(value >> 8);
+        bytes[offset + 1] = static_cast<uint8_t>(value);
+    }
+    
+    template <size_t N>
+    constexpr void store32(std::array<uint8_t, N>& bytes, size_t offset, uint32_t value) {
+        store16(bytes, offset, static_cast<uint16_t>(value >> 16));
+        store16(bytes, offset + 2, static_cast<uint16_t>(value));
+    }
+    
+    template <size_t N, size_t M>
+    constexpr void store_bytes(std::array<uint8_t, N>& bytes, size_t offset,
+                               const std::array<uint8_t, M>& value) {
+        for (size_t i = 0; i < M; ++i) {
+            bytes[offset + i] = value[i];
+        }
+    }
+    
+    // Copy a wire image into caller storage
+    template <size_t N>
+    constexpr size_t copy_out(uint8_t* out, const std::array<uint8_t, N>& bytes) {
+        for (size_t i = 0; i < N; ++i) {
+            out[i] = bytes[i];
+        }
+        return N;
+    }
+    
+    // Big-endian loads from unaligned wire data (compiled to a load and a
+    // byte swap)
+    constexpr uint16_t load16(const uint8_t* data) {
+        return static_cast<uint16_t>((data[0] << 8) | data[1]);
+    }
+    
+    constexpr uint32_t load32(const uint8_t* data) {
+        return (static_cast<uint32_t>(load16(data)) << 16) | load16(data + 2);
+    }
+    
+    // ... and the matching stores
+    constexpr void store16(uint8_t* out, uint16_t value) {
+        out[0] = static_cast<uint8_t>(value >> 8);
+        out[1] = static_cast<uint8_t>(value);
+    }
+    
+    constexpr void store32(uint8_t* out, uint32_t value) {
+        store16(out, static_cast<uint16_t>(value >> 16));
+        store16(out + 2, static_cast<uint16_t>(value));
+    }
+    
+    template <size_t N>
+    constexpr std::array<uint8_t, N> load_bytes(const uint8_t* data) {
+        std::array<uint8_t, N> bytes{};
+        for (size_t i = 0; i < N; ++i) {
+            bytes[i] = data[i];
+        }
+        return bytes;
+    }
+    
+    // The span overloads of write_to(): check the room, then write
+    template <typename Header, typename... Args>
+    size_t write_checked(Header& header, MutableByteSpan out, const Args&... args) {
+        if (out.size() < header.wire_size()) {
+            throw std::length_error("Buffer too small for header");
+        }
+        return header.write_to(out.data(), args...);
+    }
+}
+
+// Why a header could not be decoded by parse()
+enum class ParseError : uint8_t {
+    None,
+    Truncated,   // fewer bytes than the header (including its options) needs
+    BadVersion,  // IPv4/IPv6 version field does not match
+    BadLength    // IHL or TCP data offset below the minimum header size
+};
+
+// Expected-style result of the header parse() functions: the decoded header,
+// or the reason there is none
+template <typename T>
+class ParseResult {
+public:
+    constexpr ParseResult(const T& value) : value_(value) {}
+    constexpr ParseResult(ParseError error) : error_(error) {}
+    
+    constexpr bool has_value() const { return error_ == ParseError::None; }
+    constexpr explicit operator bool() const { return has_value(); }
+    constexpr ParseError error() const { return error_; }
+    
+    // Throws std::invalid_argument when parsing failed
+    constexpr const T& value() const {
+        if (!has_value()) {
+            throw std::invalid_argument("Header could not be parsed");
+        }
+        return value_;
+    }
+    constexpr T value_or(const T& fallback) const { return has_value() ? value_ : fallback; }
+    constexpr const T& operator*() const { return value_; }
+    constexpr const T* operator->() const { return &value_; }
+    
+private:
+    T value_{};
+    ParseError error_ = ParseError::None;
+};
+
 // MAC Address utility class
 class MacAddress {
 public:
-    MacAddress() = default;
-    MacAddress(const std::string& mac_str);
-    MacAddress(const std::array<uint8_t, 6>& bytes);
-    MacAddress(uint8_t b1, uint8_t b2, uint8_t b3, uint8_t b4, uint8_t b5, uint8_t b6);
+    constexpr MacAddress() = default;
+    MacAddress(const std::string& mac_str);  // throws std::invalid_argument
+    constexpr MacAddress(const std::array<uint8_t, 6>& bytes) : bytes_(bytes) {}
+    constexpr MacAddress(uint8_t b1, uint8_t b2, uint8_t b3, uint8_t b4, uint8_t b5, uint8_t b6)
+        : bytes_{b1, b2, b3, b4, b5, b6} {}
     
     std::string to_string() const;
-    std::array<uint8_t, 6> to_bytes() const;
-    bool is_broadcast() const;
-    bool is_multicast() const;
+    constexpr std::array<uint8_t, 6> to_bytes() const { return bytes_; }
+    constexpr bool is_broadcast() const {
+        for (uint8_t b : bytes_) {
+            if (b != 0xFF) return false;
+        }
+        return true;
+    }
+    constexpr bool is_multicast() const { return (bytes_[0] & 0x01) != 0; }
     
-    static MacAddress broadcast();
-    static MacAddress multicast_ipv4();
-    static MacAddress multicast_ipv6();
+    static constexpr MacAddress broadcast() { return MacAddress(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF); }
+    static constexpr MacAddress multicast_ipv4() { return MacAddress(0x01, 0x00, 0x5E, 0x00, 0x00, 0x00); }
+    static constexpr MacAddress multicast_ipv6() { return MacAddress(0x33, 0x33, 0x00, 0x00, 0x00, 0x00); }
+    
+    // Whole-string parse without allocating or throwing (see from_chars below)
+    static std::errc parse(std::string_view text, MacAddress& value) noexcept;
     
 private:
     std::array<uint8_t, 6> bytes_ = {0};
@@ -41,18 +223,32 @@ private:
 // IPv4 Address utility class
 class IPv4Address {
 public:
-    IPv4Address() = default;
-    IPv4Address(const std::string& ip_str);
-    IPv4Address(uint32_t ip);
-    IPv4Address(uint8_t a, uint8_t b, uint8_t c, uint8_t d);
+    constexpr IPv4Address() = default;
+    IPv4Address(const std::string& ip_str);  // throws std::invalid_argument
+    constexpr IPv4Address(uint32_t ip) : ip_(ip) {}  // network byte order
+    constexpr IPv4Address(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : ip_(detail::network_order32((static_cast<uint32_t>(a) << 24) |
+                                      (static_cast<uint32_t>(b) << 16) |
+                                      (static_cast<uint32_t>(c) << 8) |
+                                      static_cast<uint32_t>(d))) {}
     
     std::string to_string() const;
-    uint32_t to_uint32() const;
-    std::array<uint8_t, 4> to_bytes() const;
+    constexpr uint32_t to_uint32() const { return ip_; }
+    constexpr std::array<uint8_t, 4> to_bytes() const {
+        uint32_t host_order = detail::network_order32(ip_);
+        return {
+            static_cast<uint8_t>((host_order >> 24) & 0xFF),
+            static_cast<uint8_t>((host_order >> 16) & 0xFF),
+            static_cast<uint8_t>((host_order >> 8) & 0xFF),
+            static_cast<uint8_t>(host_order & 0xFF)
+        };
+    }
+    
+    static constexpr IPv4Address localhost() { return IPv4Address(127, 0, 0, 1); }
+    static constexpr IPv4Address broadcast() { return IPv4Address(255, 255, 255, 255); }
+    static constexpr IPv4Address any() { return IPv4Address(0, 0, 0, 0); }
     
-    static IPv4Address localhost();
-    static IPv4Address broadcast();
-    static IPv4Address any();
+    static std::errc parse(std::string_view text, IPv4Address& value) noexcept;
     
 private:
     uint32_t ip_ = 0;
@@ -61,37 +257,293 @@ private:
 // IPv6 Address utility class
 class IPv6Address {
 public:
-    IPv6Address() = default;
-    IPv6Address(const std::string& ip_str);
-    IPv6Address(const std::array<uint8_t, 16>& bytes);
+    constexpr IPv6Address() = default;
+    IPv6Address(const std::string& ip_str);  // throws std::invalid_argument
+    constexpr IPv6Address(const std::array<uint8_t, 16>& bytes) : bytes_(bytes) {}
     
     std::string to_string() const;
-    std::array<uint8_t, 16> to_bytes() const;
+    constexpr std::array<uint8_t, 16> to_bytes() const { return bytes_; }
     
-    static IPv6Address localhost();
-    static IPv6Address any();
+    static constexpr IPv6Address localhost() {
+        return IPv6Address(std::array<uint8_t, 16>{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1});
+    }
+    static constexpr IPv6Address any() { return IPv6Address(std::array<uint8_t, 16>{}); }
+    
+    static std::errc parse(std::string_view text, IPv6Address& value) noexcept;
     
 private:
     std::array<uint8_t, 16> bytes_ = {0};
 };
 
+// Allocation-free, exception-free parsing in the style of std::from_chars:
+// reads an address at the start of [first, last) and returns a pointer past
+// it. On error (errc::invalid_argument, or errc::result_out_of_range for an
+// IPv4 octet above 255) ptr == first and `value` is left unchanged.
+//   MAC:  six groups of 1-2 hex digits separated by ':' or '-'
+//   IPv4: dotted quad, no leading zeros (as inet_pton)
+//   IPv6: RFC 4291 text form, including "::" and a trailing dotted quad
+// Octets and hex groups are scanned 8 bytes at a time (SWAR).
+std::from_chars_result from_chars(const char* first, const char* last, MacAddress& value) noexcept;
+std::from_chars_result from_chars(const char* first, const char* last, IPv4Address& value) noexcept;
+std::from_chars_result from_chars(const char* first, const char* last, IPv6Address& value) noexcept;
+
+// Formatting into caller buffers in the style of std::to_chars: writes the
+// text (without a terminating '\0') to [first, last) and returns a pointer
+// past it, or {last, errc::value_too_large} if it does not fit. Buffers of
+// the *_TEXT_SIZE lengths below always suffice.
+//   MAC:  lowercase "aa:bb:cc:dd:ee:ff"
+//   IPv4: dotted quad
+//   IPv6: RFC 5952 canonical form (lowercase, longest zero run as "::",
+//         IPv4-mapped addresses as "::ffff:a.b.c.d")
+constexpr size_t MAC_TEXT_SIZE = 17;
+constexpr size_t IPV4_TEXT_SIZE = 15;
+constexpr size_t IPV6_TEXT_SIZE = 45;
+
+std::to_chars_result to_chars(char* first, char* last, const MacAddress& value) noexcept;
+std::to_chars_result to_chars(char* first, char* last, const IPv4Address& value) noexcept;
+std::to_chars_result to_chars(char* first, char* last, const IPv6Address& value) noexcept;
+
+// Stream the to_chars text without building a std::string
+std::ostream& operator<<(std::ostream& os, const MacAddress& value);
+std::ostream& operator<<(std::ostream& os, const IPv4Address& value);
+std::ostream& operator<<(std::ostream& os, const IPv6Address& value);
+
+// Scalar constexpr versions of the from_chars parsers for address literals.
+// They accept the same text and throw std::invalid_argument otherwise, which
+// inside a constant expression turns a malformed literal into a build error.
+namespace detail {
+    constexpr int hex_digit(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+    
+    // Reads a dotted quad at `pos` and returns the position after it
+    constexpr size_t scan_dotted_quad(std::string_view text, size_t pos, uint32_t& host_order) {
+        uint32_t result = 0;
+        for (size_t octet = 0; octet < 4; ++octet) {
+            if (octet > 0) {
+                if (pos >= text.size() || text[pos] != '.') {
+                    throw std::invalid_argument("Invalid IPv4 address literal");
+                }
+                ++pos;
+            }
+            size_t start = pos;
+            uint32_t value = 0;
+            while (pos < text.size() && pos - start < 3 && text[pos] >= '0' && text[pos] <= '9') {
+                value = value * 10 + static_cast<uint32_t>(text[pos++] - '0');
+            }
+            size_t length = pos - start;
+            if (length == 0 || (length > 1 && text[start] == '0') || value > 255) {
+                throw std::invalid_argument("Invalid IPv4 address literal");
+            }
+            result = (result << 8) | value;
+        }
+        host_order = result;
+        return pos;
+    }
+    
+    constexpr MacAddress parse_mac_literal(std::string_view text) {
+        std::array<uint8_t, 6> bytes{};
+        size_t pos = 0;
+        char separator = 0;
+        for (size_t i = 0; i < 6; ++i) {
+            size_t start = pos;
+            int value = 0;
+            while (pos < text.size() && pos - start < 3 && hex_digit(text[pos]) >= 0) {
+                value = value * 16 + hex_digit(text[pos++]);
+            }
+            if (pos == start || pos - start > 2) {
+                throw std::invalid_argument("Invalid MAC address literal");
+            }
+            bytes[i] = static_cast<uint8_t>(value);
+            if (i < 5) {
+                if (pos >= text.size() || (text[pos] != ':' && text[pos] != '-') ||
+                    (separator && text[pos] != separator)) {
+                    throw std::invalid_argument("Invalid MAC address literal");
+                }
+                separator = text[pos++];
+            }
+        }
+        if (pos != text.size()) {
+            throw std::invalid_argument("Invalid MAC address literal");
+        }
+        return MacAddress(bytes);
+    }
+    
+    constexpr IPv4Address parse_ipv4_literal(std::string_view text) {
+        uint32_t host_order = 0;
+        if (scan_dotted_quad(text, 0, host_order) != text.size()) {
+            throw std::invalid_argument("Invalid IPv4 address literal");
+        }
+        return IPv4Address(network_order32(host_order));
+    }
+    
+    constexpr IPv6Address parse_ipv6_literal(std::string_view text) {
+        uint16_t groups[8] = {};
+        size_t count = 0;
+        size_t pos = 0;
+        int gap = -1;       // group index where "::" was seen
+        bool need_group = false;
+        
+        if (!text.empty() && text[0] == ':') {
+            if (text.size() < 2 || text[1] != ':') {
+                throw std::invalid_argument("Invalid IPv6 address literal");
+            }
+            gap = 0;
+            pos = 2;
+        }
+        
+        while (count < 8) {
+            size_t start = pos;
+            uint32_t value = 0;
+            while (pos < text.size() && pos - start < 5 && hex_digit(text[pos]) >= 0) {
+                value = value * 16 + static_cast<uint32_t>(hex_digit(text[pos++]));
+            }
+            if (pos == start) {
+                break;
+            }
+            if (pos < text.size() && text[pos] == '.') {
+                uint32_t ipv4 = 0;
+                if (count > 6) {
+                    throw std::invalid_argument("Invalid IPv6 address literal");
+                }
+                pos = scan_dotted_quad(text, start, ipv4);
+                groups[count++] = static_cast<uint16_t>(ipv4 >> 16);
+                groups[count++] = static_cast<uint16_t>(ipv4);
+                need_group = false;
+                break;
+            }
+            if (pos - start > 4) {
+                throw std::invalid_argument("Invalid IPv6 address literal");
+            }
+            groups[count++] = static_cast<uint16_t>(value);
+            need_group = false;
+            if (pos >= text.size() || text[pos] != ':') {
+                break;
+            }
+            if (pos + 1 < text.size() && text[pos + 1] == ':') {
+                if (gap >= 0) {
+                    throw std::invalid_argument("Invalid IPv6 address literal");
+                }
+                gap = static_cast<int>(count);
+                pos += 2;
+            } else {
+                need_group = true;
+                ++pos;
+            }
+        }
+        
+        if (need_group || (gap < 0 && count != 8) || (gap >= 0 && count > 7) || pos != text.size()) {
+            throw std::invalid_argument("Invalid IPv6 address literal");
+        }
+        
+        std::array<uint8_t, 16> bytes{};
+        size_t head = gap < 0 ? count : static_cast<size_t>(gap);
+        for (size_t i = 0; i < count; ++i) {
+            size_t out = i < head ? i : i + (8 - count);
+            bytes[2 * out] = static_cast<uint8_t>(groups[i] >> 8);
+            bytes[2 * out + 1] = static_cast<uint8_t>(groups[i]);
+        }
+        return IPv6Address(bytes);
+    }
+}
+
+// Address literals, validated at compile time when used in a constant
+// expression:
+//   constexpr auto gateway = "10.0.0.1"_ipv4;
+//   constexpr auto router  = "aa:bb:cc:dd:ee:ff"_mac;
+//   constexpr auto server  = "2001:db8::1"_ipv6;
+inline namespace literals {
+    constexpr MacAddress operator""_mac(const char* text, size_t length) {
+        return detail::parse_mac_literal(std::string_view(text, length));
+    }
+    constexpr IPv4Address operator""_ipv4(const char* text, size_t length) {
+        return detail::parse_ipv4_literal(std::string_view(text, length));
+    }
+    constexpr IPv6Address operator""_ipv6(const char* text, size_t length) {
+        return detail::parse_ipv6_literal(std::string_view(text, length));
+    }
+}
+
+namespace detail {
+    constexpr uint16_t pseudo_header_sum(const IPv4Address& src, const IPv4Address& dst,
+                                         uint8_t protocol, size_t length) {
+        auto src_bytes = src.to_bytes();
+        auto dst_bytes = dst.to_bytes();
+        return checksum::pseudo_header_ipv4(src_bytes.data(), dst_bytes.data(), protocol,
+                                            static_cast<uint16_t>(length));
+    }
+    
+    constexpr uint16_t pseudo_header_sum(const IPv6Address& src, const IPv6Address& dst,
+                                         uint8_t next_header, size_t length) {
+        auto src_bytes = src.to_bytes();
+        auto dst_bytes = dst.to_bytes();
+        return checksum::pseudo_header_ipv6(src_bytes.data(), dst_bytes.data(), next_header,
+                                            static_cast<uint32_t>(length));
+    }
+    
+    // Checksum of a serialized transport header (checksum field ignored) and
+    // a fixed payload that follows it, starting from `initial`
+    template <size_t H, size_t P>
+    constexpr uint16_t transport_checksum(std::array<uint8_t, H> header, size_t checksum_offset,
+                                          const std::array<uint8_t, P>& payload, uint16_t initial) {
+        static_assert(H % 2 == 0, "payload must start at an even offset");
+        store16(header, checksum_offset, 0);
+        return checksum::finish(checksum::partial(payload, checksum::partial(header, initial)));
+    }
+}
+
 // Ethernet Header
 class EthernetHeader {
 public:
     static constexpr size_t SIZE = 14;
+    static constexpr size_t FCS_SIZE = 4;
+    static constexpr size_t MIN_FRAME_SIZE = 60;  // without FCS
     
-    EthernetHeader() = default;
-    EthernetHeader(const MacAddress& dst, const MacAddress& src, uint16_t ethertype);
+    constexpr EthernetHeader() = default;
+    constexpr EthernetHeader(const MacAddress& dst, const MacAddress& src, uint16_t ethertype)
+        : dst_(dst), src_(src), ethertype_(ethertype) {}
     
-    EthernetHeader& dst(const MacAddress& mac);
-    EthernetHeader& src(const MacAddress& mac);
-    EthernetHeader& ethertype(uint16_t type);
+    constexpr EthernetHeader& dst(const MacAddress& mac) { dst_ = mac; return *this; }
+    constexpr EthernetHeader& src(const MacAddress& mac) { src_ = mac; return *this; }
+    constexpr EthernetHeader& ethertype(uint16_t type) { ethertype_ = type; return *this; }
     
-    MacAddress dst() const { return dst_; }
-    MacAddress src() const { return src_; }
-    uint16_t ethertype() const { return ethertype_; }
+    constexpr MacAddress dst() const { return dst_; }
+    constexpr MacAddress src() const { return src_; }
+    constexpr uint16_t ethertype() const { return ethertype_; }
     
     std::vector<uint8_t> to_bytes() const;
+    // Same wire image as to_bytes(), usable in constant expressions
+    constexpr std::array<uint8_t, SIZE> to_array() const {
+        std::array<uint8_t, SIZE> bytes{};
+        detail::store_bytes(bytes, 0, dst_.to_bytes());
+        detail::store_bytes(bytes, 6, src_.to_bytes());
+        detail::store16(bytes, 12, ethertype_);
+        return bytes;
+    }
+    
+    // Serialize into caller storage without allocating and return the byte
+    // count, wire_size(); the span form throws std::length_error if it is short
+    constexpr size_t wire_size() const { return SIZE; }
+    constexpr size_t write_to(uint8_t* out) const { return detail::copy_out(out, to_array()); }
+    size_t write_to(MutableByteSpan out) const { return detail::write_checked(*this, out); }
+    
+    // Decode a wire image without allocating; bytes past the header are ignored
+    static constexpr ParseResult<EthernetHeader> parse(const uint8_t* data, size_t length) {
+        if (length < SIZE) {
+            return ParseError::Truncated;
+        }
+        return EthernetHeader(MacAddress(detail::load_bytes<6>(data)), MacAddress(detail::load_bytes<6>(data + 6)),
+                              detail::load16(data + 12));
+    }
+    static constexpr ParseResult<EthernetHeader> parse(ByteSpan data) { return parse(data.data(), data.size()); }
+    
+    // Pad a complete frame to the minimum size and append its CRC32 FCS
+    static void append_fcs(std::vector<uint8_t>& frame);
+    // Check the trailing FCS of a frame captured with it
+    static bool verify_fcs(const std::vector<uint8_t>& frame);
     
     // Common ethertypes
     static constexpr uint16_t ETHERTYPE_IPV4 = 0x0800;
@@ -106,39 +558,296 @@ private:
     uint16_t ethertype_ = 0;
 };
 
+namespace detail {
+    // Option bytes of an IPv4 or TCP header, formatted once and then copied
+    // verbatim behind the fixed header. The unused tail stays zero, so the
+    // padding up to the next 4-byte boundary is end-of-list.
+    class OptionBlock {
+    public:
+        static constexpr size_t MAX_SIZE = 40;
+        
+        // Padded size, as counted by ihl / data_offset
+        constexpr size_t size() const { return (length_ + 3u) & ~size_t(3); }
+        constexpr bool empty() const { return length_ == 0; }
+        constexpr const uint8_t* data() const { return bytes_.data(); }
+        constexpr uint8_t operator[](size_t index) const { return bytes_[index]; }
+        
+        constexpr size_t write_to(uint8_t* out) const {
+            for (size_t i = 0; i < size(); ++i) {
+                out[i] = bytes_[i];
+            }
+            return size();
+        }
+        // Unfolded one's complement sum of the padded options
+        constexpr uint16_t partial_sum() const { return checksum::partial(bytes_); }
+        
+        // Offset of the first option of `kind` in TLV-encoded options, or
+        // NOT_FOUND (also when the options are malformed before it)
+        static constexpr size_t find(const uint8_t* data, size_t length, uint8_t kind) {
+            size_t offset = 0;
+            while (offset < length && data[offset] != 0) {
+                if (data[offset] == kind) {
+                    return offset;
+                }
+                if (data[offset] == 1) {
+                    ++offset;
+                    continue;
+                }
+                if (offset + 1 >= length || data[offset + 1] < 2) {
+                    break;
+                }
+                offset += data[offset + 1];
+            }
+            return NOT_FOUND;
+        }
+        static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+        
+    protected:
+        // Room for `length` more bytes; returns their offset, throws
+        // std::length_error past MAX_SIZE
+        constexpr size_t reserve(size_t length) {
+            if (length_ + length > MAX_SIZE) {
+                throw std::length_error("Header options exceed 40 bytes");
+            }
+            size_t offset = length_;
+            length_ = static_cast<uint8_t>(length_ + length);
+            return offset;
+        }
+        constexpr size_t append_option(uint8_t kind, uint8_t length) {
+            size_t offset = reserve(length);
+            bytes_[offset] = kind;
+            if (length > 1) {
+                bytes_[offset + 1] = length;
+            }
+            return offset;
+        }
+        constexpr void assign(const uint8_t* data, size_t length) {
+            length = length < MAX_SIZE ? length : MAX_SIZE;
+            for (size_t i = 0; i < length; ++i) {
+                bytes_[i] = data[i];
+            }
+            length_ = static_cast<uint8_t>(length);
+        }
+        
+        std::array<uint8_t, MAX_SIZE> bytes_{};
+        uint8_t length_ = 0;
+    };
+}
+
+// IPv4 options for IPv4Header::options()
+class IPv4Options : public detail::OptionBlock {
+public:
+    static constexpr uint8_t OPTION_EOL = 0;
+    static constexpr uint8_t OPTION_NOP = 1;
+    static constexpr uint8_t OPTION_RECORD_ROUTE = 7;
+    
+    constexpr IPv4Options& eol() { append_option(OPTION_EOL, 1); return *this; }
+    constexpr IPv4Options& nop() { append_option(OPTION_NOP, 1); return *this; }
+    // Empty route with room for `slots` addresses (at most 9)
+    constexpr IPv4Options& record_route(uint8_t slots = 9) {
+        size_t offset = append_option(OPTION_RECORD_ROUTE, static_cast<uint8_t>(3 + 4 * slots));
+        bytes_[offset + 2] = 4;  // pointer to the first free slot
+        return *this;
+    }
+    
+    // Raw options as found on the wire (at most MAX_SIZE bytes are kept)
+    static constexpr IPv4Options from_bytes(const uint8_t* data, size_t length) {
+        IPv4Options options;
+        options.assign(data, length);
+        return options;
+    }
+};
+
+struct SackBlock {
+    uint32_t left;
+    uint32_t right;
+};
+
+// TCP options for TCPHeader::options()
+class TCPOptions : public detail::OptionBlock {
+public:
+    static constexpr uint8_t OPTION_EOL = 0;
+    static constexpr uint8_t OPTION_NOP = 1;
+    static constexpr uint8_t OPTION_MSS = 2;
+    static constexpr uint8_t OPTION_WINDOW_SCALE = 3;
+    static constexpr uint8_t OPTION_SACK_PERMITTED = 4;
+    static constexpr uint8_t OPTION_SACK = 5;
+    static constexpr uint8_t OPTION_TIMESTAMPS = 8;
+    
+    constexpr TCPOptions& eol() { append_option(OPTION_EOL, 1); return *this; }
+    constexpr TCPOptions& nop() { append_option(OPTION_NOP, 1); return *this; }
+    constexpr TCPOptions& mss(uint16_t mss) {
+        detail::store16(bytes_, append_option(OPTION_MSS, 4) + 2, mss);
+        return *this;
+    }
+    constexpr TCPOptions& window_scale(uint8_t shift) {
+        bytes_[append_option(OPTION_WINDOW_SCALE, 3) + 2] = shift;
+        return *this;
+    }
+    constexpr TCPOptions& sack_permitted() { append_option(OPTION_SACK_PERMITTED, 2); return *this; }
+    constexpr TCPOptions& sack(std::initializer_list<SackBlock> blocks) {
+        size_t offset = append_option(OPTION_SACK, static_cast<uint8_t>(2 + 8 * blocks.size())) + 2;
+        for (const SackBlock& block : blocks) {
+            detail::store32(bytes_, offset, block.left);
+            detail::store32(bytes_, offset + 4, block.right);
+            offset += 8;
+        }
+        return *this;
+    }
+    // Appends the option the first time; later calls rewrite it in place, so
+    // a preformatted block only has its 8 timestamp bytes touched per packet
+    constexpr TCPOptions& timestamps(uint32_t value, uint32_t echo_reply) {
+        if (timestamp_offset_ == NOT_FOUND) {
+            timestamp_offset_ = append_option(OPTION_TIMESTAMPS, 10);
+        }
+        detail::store32(bytes_, timestamp_offset_ + 2, value);
+        detail::store32(bytes_, timestamp_offset_ + 6, echo_reply);
+        return *this;
+    }
+    
+    // Offset of the timestamp option within the options, or NOT_FOUND
+    constexpr size_t timestamp_offset() const { return timestamp_offset_; }
+    constexpr uint32_t timestamp_value() const {
+        return timestamp_offset_ == NOT_FOUND ? 0 : detail::load32(bytes_.data() + timestamp_offset_ + 2);
+    }
+    constexpr uint32_t timestamp_echo_reply() const {
+        return timestamp_offset_ == NOT_FOUND ? 0 : detail::load32(bytes_.data() + timestamp_offset_ + 6);
+    }
+    
+    // Raw options as found on the wire (at most MAX_SIZE bytes are kept)
+    static constexpr TCPOptions from_bytes(const uint8_t* data, size_t length) {
+        TCPOptions options;
+        options.assign(data, length);
+        size_t offset = find(options.bytes_.data(), options.length_, OPTION_TIMESTAMPS);
+        if (offset != NOT_FOUND && offset + 10 <= options.length_) {
+            options.timestamp_offset_ = offset;
+        }
+        return options;
+    }
+    
+private:
+    size_t timestamp_offset_ = NOT_FOUND;
+};
+
 // IPv4 Header
 class IPv4Header {
 public:
     static constexpr size_t MIN_SIZE = 20;
+    static constexpr size_t MAX_SIZE = 60;
+    
+    constexpr IPv4Header() = default;
+    constexpr IPv4Header(const IPv4Address& src, const IPv4Address& dst, uint8_t protocol)
+        : protocol_(protocol), src_(src), dst_(dst) {}
+    
+    // Setters also mark the 16-bit words they change in the cached wire image
+    constexpr IPv4Header& version(uint8_t ver) { version_ = ver; dirty_ |= word(0); return *this; }
+    constexpr IPv4Header& ihl(uint8_t ihl) { ihl_ = ihl; dirty_ |= word(0); return *this; }
+    constexpr IPv4Header& tos(uint8_t tos) { tos_ = tos; dirty_ |= word(0); return *this; }
+    constexpr IPv4Header& length(uint16_t len) { length_ = len; dirty_ |= word(2); return *this; }
+    constexpr IPv4Header& id(uint16_t id) { id_ = id; dirty_ |= word(4); return *this; }
+    constexpr IPv4Header& flags(uint8_t flags) { flags_ = flags; dirty_ |= word(6); return *this; }
+    constexpr IPv4Header& fragment_offset(uint16_t offset) { fragment_offset_ = offset; dirty_ |= word(6); return *this; }
+    constexpr IPv4Header& ttl(uint8_t ttl) { ttl_ = ttl; dirty_ |= word(8); return *this; }
+    constexpr IPv4Header& protocol(uint8_t proto) { protocol_ = proto; dirty_ |= word(8); return *this; }
+    constexpr IPv4Header& src(const IPv4Address& addr) { src_ = addr; dirty_ |= word(12) | word(14); return *this; }
+    constexpr IPv4Header& dst(const IPv4Address& addr) { dst_ = addr; dirty_ |= word(16) | word(18); return *this; }
+    // Also sets ihl() to cover the padded options
+    constexpr IPv4Header& options(const IPv4Options& options) {
+        options_ = options;
+        ihl_ = static_cast<uint8_t>((MIN_SIZE + options.size()) / 4);
+        dirty_ = ALL_WORDS;
+        return *this;
+    }
     
-    IPv4Header() = default;
-    IPv4Header(const IPv4Address& src, const IPv4Address& dst, uint8_t protocol);
-    
-    IPv4Header& version(uint8_t ver) { version_ = ver; return *this; }
-    IPv4Header& ihl(uint8_t ihl) { ihl_ = ihl; return *this; }
-    IPv4Header& tos(uint8_t tos) { tos_ = tos; return *this; }
-    IPv4Header& length(uint16_t len) { length_ = len; return *this; }
-    IPv4Header& id(uint16_t id) { id_ = id; return *this; }
-    IPv4Header& flags(uint8_t flags) { flags_ = flags; return *this; }
-    IPv4Header& fragment_offset(uint16_t offset) { fragment_offset_ = offset; return *this; }
-    IPv4Header& ttl(uint8_t ttl) { ttl_ = ttl; return *this; }
-    IPv4Header& protocol(uint8_t proto) { protocol_ = proto; return *this; }
-    IPv4Header& src(const IPv4Address& addr) { src_ = addr; return *this; }
-    IPv4Header& dst(const IPv4Address& addr) { dst_ = addr; return *this; }
-    
-    uint8_t version() const { return version_; }
-    uint8_t ihl() const { return ihl_; }
-    uint8_t tos() const { return tos_; }
-    uint16_t length() const { return length_; }
-    uint16_t id() const { return id_; }
-    uint8_t flags() const { return flags_; }
-    uint16_t fragment_offset() const { return fragment_offset_; }
-    uint8_t ttl() const { return ttl_; }
-    uint8_t protocol() const { return protocol_; }
-    IPv4Address src() const { return src_; }
-    IPv4Address dst() const { return dst_; }
+    constexpr uint8_t version() const { return version_; }
+    constexpr uint8_t ihl() const { return ihl_; }
+    constexpr uint8_t tos() const { return tos_; }
+    constexpr uint16_t length() const { return length_; }
+    constexpr uint16_t id() const { return id_; }
+    constexpr uint8_t flags() const { return flags_; }
+    constexpr uint16_t fragment_offset() const { return fragment_offset_; }
+    constexpr uint8_t ttl() const { return ttl_; }
+    constexpr uint8_t protocol() const { return protocol_; }
+    constexpr IPv4Address src() const { return src_; }
+    constexpr IPv4Address dst() const { return dst_; }
+    constexpr const IPv4Options& options() const { return options_; }
     
+    // Serialized with the header checksum filled in. to_array() is the fixed
+    // part only; the checksum still covers the options that follow it.
     std::vector<uint8_t> to_bytes() const;
+    constexpr std::array<uint8_t, MIN_SIZE> to_array() const {
+        std::array<uint8_t, MIN_SIZE> bytes{};
+        bytes[0] = static_cast<uint8_t>((version_ << 4) | ihl_);
+        bytes[1] = tos_;
+        detail::store16(bytes, 2, length_);
+        detail::store16(bytes, 4, id_);
+        detail::store16(bytes, 6, static_cast<uint16_t>((flags_ << 13) | fragment_offset_));
+        bytes[8] = ttl_;
+        bytes[9] = protocol_;
+        detail::store_bytes(bytes, 12, src_.to_bytes());
+        detail::store_bytes(bytes, 16, dst_.to_bytes());
+        detail::store16(bytes, 10, checksum::finish(checksum::partial(bytes, options_.partial_sum())));
+        return bytes;
+    }
+    
+    constexpr size_t wire_size() const { return MIN_SIZE + options_.size(); }
+    // Writes wire_size() bytes, options included, so `out` needs room for
+    // MIN_SIZE + options().size(), not just MIN_SIZE. Unchecked; the span
+    // overloads throw std::length_error when the buffer is shorter.
+    constexpr size_t write_to(uint8_t* out) const {
+        detail::copy_out(out, dirty_ == 0 ? image_ : to_array());
+        return MIN_SIZE + options_.write_to(out + MIN_SIZE);
+    }
+    size_t write_to(MutableByteSpan out) const { return detail::write_checked(*this, out); }
+    
+    // The header keeps its serialized image (the fixed part; options are
+    // copied behind it). Calls on a non-const header
+    // rewrite only the 16-bit words changed since the last call and adjust
+    // the checksum for them (RFC 1624), so re-emitting a header after e.g.
+    // id() costs O(1) rather than a full serialization; const calls reuse the
+    // image when it is up to date.
+    constexpr const std::array<uint8_t, MIN_SIZE>& wire_image() {
+        refresh_image(nullptr);
+        return image_;
+    }
+    std::vector<uint8_t> to_bytes();
+    // Same contract as the const overload: wire_size() bytes
+    constexpr size_t write_to(uint8_t* out) {
+        if (dirty_ == ALL_WORDS) {
+            detail::copy_out(out, wire_image());
+        } else {
+            // Copy the previous image, then patch the changed words in both
+            detail::copy_out(out, image_);
+            refresh_image(out);
+        }
+        return MIN_SIZE + options_.write_to(out + MIN_SIZE);
+    }
+    size_t write_to(MutableByteSpan out) { return detail::write_checked(*this, out); }
+    
+    // Options are kept as raw bytes in options()
+    static constexpr ParseResult<IPv4Header> parse(const uint8_t* data, size_t length) {
+        if (length < MIN_SIZE) {
+            return ParseError::Truncated;
+        }
+        if ((data[0] >> 4) != 4) {
+            return ParseError::BadVersion;
+        }
+        uint8_t ihl = data[0] & 0x0F;
+        if (ihl < 5) {
+            return ParseError::BadLength;
+        }
+        if (ihl * 4u > length) {
+            return ParseError::Truncated;
+        }
+        uint16_t fragment = detail::load16(data + 6);
+        IPv4Header header(IPv4Address(detail::network_order32(detail::load32(data + 12))),
+                          IPv4Address(detail::network_order32(detail::load32(data + 16))), data[9]);
+        header.ihl(ihl).tos(data[1]).length(detail::load16(data + 2)).id(detail::load16(data + 4))
+              .flags(static_cast<uint8_t>(fragment >> 13)).fragment_offset(fragment & 0x1FFF).ttl(data[8])
+              .options(IPv4Options::from_bytes(data + MIN_SIZE, ihl * 4u - MIN_SIZE));
+        return header;
+    }
+    static constexpr ParseResult<IPv4Header> parse(ByteSpan data) { return parse(data.data(), data.size()); }
     
     // Common protocols
     static constexpr uint8_t PROTOCOL_ICMP = 1;
@@ -162,6 +871,57 @@ private:
     uint16_t checksum_ = 0;
     IPv4Address src_;
     IPv4Address dst_;
+    IPv4Options options_;
+    
+    // Bit n covers bytes 2n and 2n + 1 of the wire image; all bits set means
+    // the image was never built
+    static constexpr uint16_t ALL_WORDS = 0x3FF;
+    static constexpr uint16_t word(size_t offset) { return static_cast<uint16_t>(1u << (offset / 2)); }
+    constexpr uint16_t wire_word(size_t index) const {
+        switch (index) {
+            case 0: return static_cast<uint16_t>((version_ << 12) | (ihl_ << 8) | tos_);
+            case 1: return length_;
+            case 2: return id_;
+            case 3: return static_cast<uint16_t>((flags_ << 13) | fragment_offset_);
+            case 4: return static_cast<uint16_t>((ttl_ << 8) | protocol_);
+            case 6: return static_cast<uint16_t>(detail::network_order32(src_.to_uint32()) >> 16);
+            case 7: return static_cast<uint16_t>(detail::network_order32(src_.to_uint32()));
+            case 8: return static_cast<uint16_t>(detail::network_order32(dst_.to_uint32()) >> 16);
+            case 9: return static_cast<uint16_t>(detail::network_order32(dst_.to_uint32()));
+            default: return 0;
+        }
+    }
+    
+    // Bring image_ up to date, also storing the changed words into `copy`
+    // (when not null), which holds the previous image
+    constexpr void refresh_image(uint8_t* copy) {
+        if (dirty_ == ALL_WORDS) {
+            image_ = to_array();
+        } else if (dirty_ != 0) {
+            uint16_t sum = detail::load16(image_.data() + 10);
+            for (unsigned dirty = dirty_; dirty != 0; dirty &= dirty - 1) {
+                size_t offset = 2 * static_cast<size_t>(detail::ctz32(dirty));
+                uint16_t old_word = detail::load16(image_.data() + offset);
+                uint16_t new_word = wire_word(offset / 2);
+                if (old_word != new_word) {
+                    sum = checksum::adjust(sum, old_word, new_word);
+                    store_word(copy, offset, new_word);
+                }
+            }
+            store_word(copy, 10, sum);
+        }
+        dirty_ = 0;
+    }
+    constexpr void store_word(uint8_t* copy, size_t offset, uint16_t value) {
+        detail::store16(image_, offset, value);
+        if (copy != nullptr) {
+            copy[offset] = static_cast<uint8_t>(value >> 8);
+            copy[offset + 1] = static_cast<uint8_t>(value);
+        }
+    }
+    
+    std::array<uint8_t, MIN_SIZE> image_{};
+    uint16_t dirty_ = ALL_WORDS;
 };
 
 // IPv6 Header
@@ -169,28 +929,60 @@ class IPv6Header {
 public:
     static constexpr size_t SIZE = 40;
     
-    IPv6Header() = default;
-    IPv6Header(const IPv6Address& src, const IPv6Address& dst, uint8_t next_header);
-    
-    IPv6Header& version(uint8_t ver) { version_ = ver; return *this; }
-    IPv6Header& traffic_class(uint8_t tc) { traffic_class_ = tc; return *this; }
-    IPv6Header& flow_label(uint32_t fl) { flow_label_ = fl; return *this; }
-    IPv6Header& payload_length(uint16_t len) { payload_length_ = len; return *this; }
-    IPv6Header& next_header(uint8_t nh) { next_header_ = nh; return *this; }
-    IPv6Header& hop_limit(uint8_t hl) { hop_limit_ = hl; return *this; }
-    IPv6Header& src(const IPv6Address& addr) { src_ = addr; return *this; }
-    IPv6Header& dst(const IPv6Address& addr) { dst_ = addr; return *this; }
-    
-    uint8_t version() const { return version_; }
-    uint8_t traffic_class() const { return traffic_class_; }
-    uint32_t flow_label() const { return flow_label_; }
-    uint16_t payload_length() const { return payload_length_; }
-    uint8_t next_header() const { return next_header_; }
-    uint8_t hop_limit() const { return hop_limit_; }
-    IPv6Address src() const { return src_; }
-    IPv6Address dst() const { return dst_; }
+    constexpr IPv6Header() = default;
+    constexpr IPv6Header(const IPv6Address& src, const IPv6Address& dst, uint8_t next_header)
+        : next_header_(next_header), src_(src), dst_(dst) {}
+    
+    constexpr IPv6Header& version(uint8_t ver) { version_ = ver; return *this; }
+    constexpr IPv6Header& traffic_class(uint8_t tc) { traffic_class_ = tc; return *this; }
+    constexpr IPv6Header& flow_label(uint32_t fl) { flow_label_ = fl; return *this; }
+    constexpr IPv6Header& payload_length(uint16_t len) { payload_length_ = len; return *this; }
+    constexpr IPv6Header& next_header(uint8_t nh) { next_header_ = nh; return *this; }
+    constexpr IPv6Header& hop_limit(uint8_t hl) { hop_limit_ = hl; return *this; }
+    constexpr IPv6Header& src(const IPv6Address& addr) { src_ = addr; return *this; }
+    constexpr IPv6Header& dst(const IPv6Address& addr) { dst_ = addr; return *this; }
+    
+    constexpr uint8_t version() const { return version_; }
+    constexpr uint8_t traffic_class() const { return traffic_class_; }
+    constexpr uint32_t flow_label() const { return flow_label_; }
+    constexpr uint16_t payload_length() const { return payload_length_; }
+    constexpr uint8_t next_header() const { return next_header_; }
+    constexpr uint8_t hop_limit() const { return hop_limit_; }
+    constexpr IPv6Address src() const { return src_; }
+    constexpr IPv6Address dst() const { return dst_; }
     
     std::vector<uint8_t> to_bytes() const;
+    constexpr std::array<uint8_t, SIZE> to_array() const {
+        std::array<uint8_t, SIZE> bytes{};
+        detail::store32(bytes, 0, (static_cast<uint32_t>(version_) << 28) |
+                                  (static_cast<uint32_t>(traffic_class_) << 20) | flow_label_);
+        detail::store16(bytes, 4, payload_length_);
+        bytes[6] = next_header_;
+        bytes[7] = hop_limit_;
+        detail::store_bytes(bytes, 8, src_.to_bytes());
+        detail::store_bytes(bytes, 24, dst_.to_bytes());
+        return bytes;
+    }
+    
+    constexpr size_t wire_size() const { return SIZE; }
+    constexpr size_t write_to(uint8_t* out) const { return detail::copy_out(out, to_array()); }
+    size_t write_to(MutableByteSpan out) const { return detail::write_checked(*this, out); }
+    
+    static constexpr ParseResult<IPv6Header> parse(const uint8_t* data, size_t length) {
+        if (length < SIZE) {
+            return ParseError::Truncated;
+        }
+        uint32_t first = detail::load32(data);
+        if ((first >> 28) != 6) {
+            return ParseError::BadVersion;
+        }
+        IPv6Header header(IPv6Address(detail::load_bytes<16>(data + 8)), IPv6Address(detail::load_bytes<16>(data + 24)),
+                          data[6]);
+        header.traffic_class(static_cast<uint8_t>(first >> 20)).flow_label(first & 0xFFFFF)
+              .payload_length(detail::load16(data + 4)).hop_limit(data[7]);
+        return header;
+    }
+    static constexpr ParseResult<IPv6Header> parse(ByteSpan data) { return parse(data.data(), data.size()); }
     
     // Common next headers (same as IPv4 protocols)
     static constexpr uint8_t NEXT_HEADER_TCP = 6;
@@ -213,20 +1005,42 @@ class MPLSHeader {
 public:
     static constexpr size_t SIZE = 4;
     
-    MPLSHeader() = default;
-    MPLSHeader(uint32_t label, uint8_t tc = 0, bool bottom_of_stack = true, uint8_t ttl = 64);
+    constexpr MPLSHeader() = default;
+    constexpr MPLSHeader(uint32_t label, uint8_t tc = 0, bool bottom_of_stack = true, uint8_t ttl = 64)
+        : label_(label & 0xFFFFF), traffic_class_(tc & 0x7), bottom_of_stack_(bottom_of_stack), ttl_(ttl) {}
     
-    MPLSHeader& label(uint32_t label_val) { label_ = label_val & 0xFFFFF; return *this; } // 20 bits
-    MPLSHeader& traffic_class(uint8_t tc) { traffic_class_ = tc & 0x7; return *this; }    // 3 bits
-    MPLSHeader& bottom_of_stack(bool bos) { bottom_of_stack_ = bos; return *this; }       // 1 bit
-    MPLSHeader& ttl(uint8_t ttl_val) { ttl_ = ttl_val; return *this; }                   // 8 bits
+    constexpr MPLSHeader& label(uint32_t label_val) { label_ = label_val & 0xFFFFF; return *this; } // 20 bits
+    constexpr MPLSHeader& traffic_class(uint8_t tc) { traffic_class_ = tc & 0x7; return *this; }    // 3 bits
+    constexpr MPLSHeader& bottom_of_stack(bool bos) { bottom_of_stack_ = bos; return *this; }       // 1 bit
+    constexpr MPLSHeader& ttl(uint8_t ttl_val) { ttl_ = ttl_val; return *this; }                   // 8 bits
     
-    uint32_t label() const { return label_; }
-    uint8_t traffic_class() const { return traffic_class_; }
-    bool bottom_of_stack() const { return bottom_of_stack_; }
-    uint8_t ttl() const { return ttl_; }
+    constexpr uint32_t label() const { return label_; }
+    constexpr uint8_t traffic_class() const { return traffic_class_; }
+    constexpr bool bottom_of_stack() const { return bottom_of_stack_; }
+    constexpr uint8_t ttl() const { return ttl_; }
     
     std::vector<uint8_t> to_bytes() const;
+    constexpr std::array<uint8_t, SIZE> to_array() const {
+        // Label (20 bits) | TC (3) | S (1) | TTL (8)
+        std::array<uint8_t, SIZE> bytes{};
+        detail::store32(bytes, 0, ((label_ & 0xFFFFF) << 12) | ((traffic_class_ & 0x7) << 9) |
+                                  ((bottom_of_stack_ ? 1u : 0u) << 8) | ttl_);
+        return bytes;
+    }
+    
+    constexpr size_t wire_size() const { return SIZE; }
+    constexpr size_t write_to(uint8_t* out) const { return detail::copy_out(out, to_array()); }
+    size_t write_to(MutableByteSpan out) const { return detail::write_checked(*this, out); }
+    
+    static constexpr ParseResult<MPLSHeader> parse(const uint8_t* data, size_t length) {
+        if (length < SIZE) {
+            return ParseError::Truncated;
+        }
+        uint32_t entry = detail::load32(data);
+        return MPLSHeader(entry >> 12, static_cast<uint8_t>((entry >> 9) & 0x7), (entry >> 8) & 1,
+                          static_cast<uint8_t>(entry));
+    }
+    static constexpr ParseResult<MPLSHeader> parse(ByteSpan data) { return parse(data.data(), data.size()); }
     
     // Common MPLS labels
     static constexpr uint32_t LABEL_IPV4_EXPLICIT_NULL = 0;
@@ -248,29 +1062,132 @@ private:
 class TCPHeader {
 public:
     static constexpr size_t MIN_SIZE = 20;
+    static constexpr size_t MAX_SIZE = 60;
+    
+    constexpr TCPHeader() = default;
+    constexpr TCPHeader(uint16_t src_port, uint16_t dst_port)
+        : src_port_(src_port), dst_port_(dst_port) {}
     
-    TCPHeader() = default;
-    TCPHeader(uint16_t src_port, uint16_t dst_port);
-    
-    TCPHeader& src_port(uint16_t port) { src_port_ = port; return *this; }
-    TCPHeader& dst_port(uint16_t port) { dst_port_ = port; return *this; }
-    TCPHeader& seq_num(uint32_t seq) { seq_num_ = seq; return *this; }
-    TCPHeader& ack_num(uint32_t ack) { ack_num_ = ack; return *this; }
-    TCPHeader& data_offset(uint8_t offset) { data_offset_ = offset; return *this; }
-    TCPHeader& flags(uint8_t flags) { flags_ = flags; return *this; }
-    TCPHeader& window_size(uint16_t size) { window_size_ = size; return *this; }
-    TCPHeader& urgent_ptr(uint16_t ptr) { urgent_ptr_ = ptr; return *this; }
-    
-    uint16_t src_port() const { return src_port_; }
-    uint16_t dst_port() const { return dst_port_; }
-    uint32_t seq_num() const { return seq_num_; }
-    uint32_t ack_num() const { return ack_num_; }
-    uint8_t data_offset() const { return data_offset_; }
-    uint8_t flags() const { return flags_; }
-    uint16_t window_size() const { return window_size_; }
-    uint16_t urgent_ptr() const { return urgent_ptr_; }
+    constexpr TCPHeader& src_port(uint16_t port) { src_port_ = port; return *this; }
+    constexpr TCPHeader& dst_port(uint16_t port) { dst_port_ = port; return *this; }
+    constexpr TCPHeader& seq_num(uint32_t seq) { seq_num_ = seq; return *this; }
+    constexpr TCPHeader& ack_num(uint32_t ack) { ack_num_ = ack; return *this; }
+    constexpr TCPHeader& data_offset(uint8_t offset) { data_offset_ = offset; return *this; }
+    constexpr TCPHeader& flags(uint8_t flags) { flags_ = flags; return *this; }
+    constexpr TCPHeader& window_size(uint16_t size) { window_size_ = size; return *this; }
+    constexpr TCPHeader& urgent_ptr(uint16_t ptr) { urgent_ptr_ = ptr; return *this; }
+    // Also sets data_offset() to cover the padded options
+    constexpr TCPHeader& options(const TCPOptions& options) {
+        options_ = options;
+        data_offset_ = static_cast<uint8_t>((MIN_SIZE + options.size()) / 4);
+        return *this;
+    }
+    // Rewrites the timestamp option in place (adding it if missing)
+    constexpr TCPHeader& timestamps(uint32_t value, uint32_t echo_reply) {
+        options_.timestamps(value, echo_reply);
+        data_offset_ = static_cast<uint8_t>((MIN_SIZE + options_.size()) / 4);
+        return *this;
+    }
     
+    constexpr uint16_t src_port() const { return src_port_; }
+    constexpr uint16_t dst_port() const { return dst_port_; }
+    constexpr uint32_t seq_num() const { return seq_num_; }
+    constexpr uint32_t ack_num() const { return ack_num_; }
+    constexpr uint8_t data_offset() const { return data_offset_; }
+    constexpr uint8_t flags() const { return flags_; }
+    constexpr uint16_t window_size() const { return window_size_; }
+    constexpr uint16_t urgent_ptr() const { return urgent_ptr_; }
+    constexpr uint16_t checksum() const { return checksum_; }
+    constexpr const TCPOptions& options() const { return options_; }
+    
+    // to_array() is the fixed part of the header; the options follow it in
+    // to_bytes() and write_to()
     std::vector<uint8_t> to_bytes() const;
+    constexpr std::array<uint8_t, MIN_SIZE> to_array() const {
+        std::array<uint8_t, MIN_SIZE> bytes{};
+        detail::store16(bytes, 0, src_port_);
+        detail::store16(bytes, 2, dst_port_);
+        detail::store32(bytes, 4, seq_num_);
+        detail::store32(bytes, 8, ack_num_);
+        bytes[12] = static_cast<uint8_t>(data_offset_ << 4);
+        bytes[13] = flags_;
+        detail::store16(bytes, 14, window_size_);
+        detail::store16(bytes, 16, checksum_);
+        detail::store16(bytes, 18, urgent_ptr_);
+        return bytes;
+    }
+    
+    constexpr size_t wire_size() const { return MIN_SIZE + options_.size(); }
+    // Writes wire_size() bytes, options included: `out` needs room for
+    // MIN_SIZE + options().size(). The span overload checks the length.
+    constexpr size_t write_to(uint8_t* out) const {
+        detail::copy_out(out, to_array());
+        return MIN_SIZE + options_.write_to(out + MIN_SIZE);
+    }
+    size_t write_to(MutableByteSpan out) const { return detail::write_checked(*this, out); }
+    
+    // Options are kept as raw bytes in options()
+    static constexpr ParseResult<TCPHeader> parse(const uint8_t* data, size_t length) {
+        if (length < MIN_SIZE) {
+            return ParseError::Truncated;
+        }
+        uint8_t offset = data[12] >> 4;
+        if (offset < 5) {
+            return ParseError::BadLength;
+        }
+        if (offset * 4u > length) {
+            return ParseError::Truncated;
+        }
+        TCPHeader header(detail::load16(data), detail::load16(data + 2));
+        header.seq_num(detail::load32(data + 4)).ack_num(detail::load32(data + 8)).data_offset(offset)
+              .flags(data[13]).window_size(detail::load16(data + 14)).urgent_ptr(detail::load16(data + 18))
+              .options(TCPOptions::from_bytes(data + MIN_SIZE, offset * 4u - MIN_SIZE));
+        header.checksum_ = detail::load16(data + CHECKSUM_OFFSET);
+        return header;
+    }
+    static constexpr ParseResult<TCPHeader> parse(ByteSpan data) { return parse(data.data(), data.size()); }
+    
+    // Compile-time counterparts of the to_bytes() overloads below; the options
+    // and the fixed payload are covered by the checksum but not part of the
+    // result
+    template <size_t N = 0>
+    constexpr std::array<uint8_t, MIN_SIZE> to_array(const IPv4Address& src_ip, const IPv4Address& dst_ip,
+                                                     const std::array<uint8_t, N>& payload = {}) const {
+        return with_checksum(payload, detail::pseudo_header_sum(src_ip, dst_ip, IPv4Header::PROTOCOL_TCP, wire_size() + N));
+    }
+    template <size_t N = 0>
+    constexpr std::array<uint8_t, MIN_SIZE> to_array(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                                                     const std::array<uint8_t, N>& payload = {}) const {
+        return with_checksum(payload, detail::pseudo_header_sum(src_ip, dst_ip, IPv4Header::PROTOCOL_TCP, wire_size() + N));
+    }
+    
+    // Serialize with the checksum computed over the pseudo-header, this header
+    // and the payload in a single pass (the payload is not copied)
+    std::vector<uint8_t> to_bytes(const IPv4Address& src_ip, const IPv4Address& dst_ip,
+                                  const std::vector<uint8_t>& payload = {}) const;
+    std::vector<uint8_t> to_bytes(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                                  const std::vector<uint8_t>& payload = {}) const;
+    // Same, written into caller storage
+    size_t write_to(uint8_t* out, const IPv4Address& src_ip, const IPv4Address& dst_ip,
+                    ByteSpan payload = {}) const;
+    size_t write_to(uint8_t* out, const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                    ByteSpan payload = {}) const;
+    template <typename Address>
+    size_t write_to(MutableByteSpan out, const Address& src_ip, const Address& dst_ip,
+                    ByteSpan payload = {}) const {
+        return detail::write_checked(*this, out, src_ip, dst_ip, payload);
+    }
+    
+    // Checksum calculation methods
+    uint16_t calculate_checksum(const IPv4Address& src_ip, const IPv4Address& dst_ip,
+                               const std::vector<uint8_t>& payload = {}) const;
+    uint16_t calculate_checksum(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                               const std::vector<uint8_t>& payload = {}) const;
+    
+    TCPHeader& update_checksum(const IPv4Address& src_ip, const IPv4Address& dst_ip,
+                              const std::vector<uint8_t>& payload = {});
+    TCPHeader& update_checksum(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                              const std::vector<uint8_t>& payload = {});
     
     // TCP flags
     static constexpr uint8_t FLAG_FIN = 0x01;
@@ -283,6 +1200,19 @@ public:
     static constexpr uint8_t FLAG_CWR = 0x80;
     
 private:
+    static constexpr size_t CHECKSUM_OFFSET = 16;
+    
+    template <size_t N>
+    constexpr std::array<uint8_t, MIN_SIZE> with_checksum(const std::array<uint8_t, N>& payload,
+                                                          uint16_t pseudo_sum) const {
+        auto bytes = to_array();
+        detail::store16(bytes, CHECKSUM_OFFSET,
+                        detail::transport_checksum(bytes, CHECKSUM_OFFSET, payload,
+                                                   checksum::fold(static_cast<uint32_t>(pseudo_sum) +
+                                                                  options_.partial_sum())));
+        return bytes;
+    }
+    
     uint16_t src_port_ = 0;
     uint16_t dst_port_ = 0;
     uint32_t seq_num_ = 0;
@@ -292,6 +1222,7 @@ private:
     uint16_t window_size_ = 8192;
     uint16_t checksum_ = 0;
     uint16_t urgent_ptr_ = 0;
+    TCPOptions options_;
 };
 
 // UDP Header
@@ -299,19 +1230,75 @@ class UDPHeader {
 public:
     static constexpr size_t SIZE = 8;
     
-    UDPHeader() = default;
-    UDPHeader(uint16_t src_port, uint16_t dst_port, uint16_t length = 0);
+    constexpr UDPHeader() = default;
+    constexpr UDPHeader(uint16_t src_port, uint16_t dst_port, uint16_t length = 0)
+        : src_port_(src_port), dst_port_(dst_port), length_(length) {}
     
-    UDPHeader& src_port(uint16_t port) { src_port_ = port; return *this; }
-    UDPHeader& dst_port(uint16_t port) { dst_port_ = port; return *this; }
-    UDPHeader& length(uint16_t len) { length_ = len; return *this; }
+    constexpr UDPHeader& src_port(uint16_t port) { src_port_ = port; return *this; }
+    constexpr UDPHeader& dst_port(uint16_t port) { dst_port_ = port; return *this; }
+    constexpr UDPHeader& length(uint16_t len) { length_ = len; return *this; }
     
-    uint16_t src_port() const { return src_port_; }
-    uint16_t dst_port() const { return dst_port_; }
-    uint16_t length() const { return length_; }
-    uint16_t checksum() const { return checksum_; }
+    constexpr uint16_t src_port() const { return src_port_; }
+    constexpr uint16_t dst_port() const { return dst_port_; }
+    constexpr uint16_t length() const { return length_; }
+    constexpr uint16_t checksum() const { return checksum_; }
     
     std::vector<uint8_t> to_bytes() const;
+    constexpr std::array<uint8_t, SIZE> to_array() const {
+        std::array<uint8_t, SIZE> bytes{};
+        detail::store16(bytes, 0, src_port_);
+        detail::store16(bytes, 2, dst_port_);
+        detail::store16(bytes, 4, length_);
+        detail::store16(bytes, 6, checksum_);
+        return bytes;
+    }
+    
+    constexpr size_t wire_size() const { return SIZE; }
+    constexpr size_t write_to(uint8_t* out) const { return detail::copy_out(out, to_array()); }
+    size_t write_to(MutableByteSpan out) const { return detail::write_checked(*this, out); }
+    
+    static constexpr ParseResult<UDPHeader> parse(const uint8_t* data, size_t length) {
+        if (length < SIZE) {
+            return ParseError::Truncated;
+        }
+        UDPHeader header(detail::load16(data), detail::load16(data + 2), detail::load16(data + 4));
+        header.checksum_ = detail::load16(data + CHECKSUM_OFFSET);
+        return header;
+    }
+    static constexpr ParseResult<UDPHeader> parse(ByteSpan data) { return parse(data.data(), data.size()); }
+    
+    // Wire image with the checksum over the pseudo-header, this header and a
+    // fixed payload (not part of the result), usable in constant expressions.
+    // Like calculate_checksum(), these forms take the length from the
+    // payload rather than length(), so the length field and the pseudo-header
+    // always agree.
+    template <size_t N>
+    constexpr std::array<uint8_t, SIZE> to_array(const IPv4Address& src_ip, const IPv4Address& dst_ip,
+                                                 const std::array<uint8_t, N>& payload) const {
+        static_assert(SIZE + N <= 0xFFFF, "UDP datagram too large for IPv4");
+        return with_checksum(payload, SIZE + N,
+                             detail::pseudo_header_sum(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP, SIZE + N));
+    }
+    template <size_t N>
+    constexpr std::array<uint8_t, SIZE> to_array(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                                                 const std::array<uint8_t, N>& payload) const {
+        return with_checksum(payload, SIZE + N,
+                             detail::pseudo_header_sum(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP, SIZE + N));
+    }
+    
+    // Serialize with the checksum over the pseudo-header, this header and the
+    // payload (not copied) into caller storage. The length field is
+    // SIZE + payload.size(), or 0 for an IPv6 jumbogram (RFC 2675); over IPv4
+    // a datagram above 65535 bytes throws std::length_error.
+    size_t write_to(uint8_t* out, const IPv4Address& src_ip, const IPv4Address& dst_ip,
+                    ByteSpan payload = {}) const;
+    size_t write_to(uint8_t* out, const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                    ByteSpan payload = {}) const;
+    template <typename Address>
+    size_t write_to(MutableByteSpan out, const Address& src_ip, const Address& dst_ip,
+                    ByteSpan payload = {}) const {
+        return detail::write_checked(*this, out, src_ip, dst_ip, payload);
+    }
     
     // Checksum calculation methods
     uint16_t calculate_checksum(const IPv4Address& src_ip, const IPv4Address& dst_ip, 
@@ -325,6 +1312,24 @@ public:
                               const std::vector<uint8_t>& payload = {});
     
 private:
+    static constexpr size_t CHECKSUM_OFFSET = 6;
+    
+    // to_array() with the length field of a `udp_length` byte datagram
+    constexpr std::array<uint8_t, SIZE> to_array(size_t udp_length) const {
+        auto bytes = to_array();
+        detail::store16(bytes, 4, udp_length > 0xFFFF ? 0 : static_cast<uint16_t>(udp_length));
+        return bytes;
+    }
+    
+    template <size_t N>
+    constexpr std::array<uint8_t, SIZE> with_checksum(const std::array<uint8_t, N>& payload, size_t udp_length,
+                                                      uint16_t pseudo_sum) const {
+        auto bytes = to_array(udp_length);
+        uint16_t value = detail::transport_checksum(bytes, CHECKSUM_OFFSET, payload, pseudo_sum);
+        detail::store16(bytes, CHECKSUM_OFFSET, value == 0 ? 0xFFFF : value);
+        return bytes;
+    }
+    
     uint16_t src_port_ = 0;
     uint16_t dst_port_ = 0;
     uint16_t length_ = 0;
@@ -336,20 +1341,83 @@ class ICMPHeader {
 public:
     static constexpr size_t MIN_SIZE = 8;
     
-    ICMPHeader() = default;
-    ICMPHeader(uint8_t type, uint8_t code);
+    constexpr ICMPHeader() = default;
+    constexpr ICMPHeader(uint8_t type, uint8_t code) : type_(type), code_(code) {}
     
-    ICMPHeader& type(uint8_t type) { type_ = type; return *this; }
-    ICMPHeader& code(uint8_t code) { code_ = code; return *this; }
-    ICMPHeader& identifier(uint16_t id) { identifier_ = id; return *this; }
-    ICMPHeader& sequence(uint16_t seq) { sequence_ = seq; return *this; }
+    constexpr ICMPHeader& type(uint8_t type) { type_ = type; return *this; }
+    constexpr ICMPHeader& code(uint8_t code) { code_ = code; return *this; }
+    constexpr ICMPHeader& identifier(uint16_t id) { identifier_ = id; return *this; }
+    constexpr ICMPHeader& sequence(uint16_t seq) { sequence_ = seq; return *this; }
     
-    uint8_t type() const { return type_; }
-    uint8_t code() const { return code_; }
-    uint16_t identifier() const { return identifier_; }
-    uint16_t sequence() const { return sequence_; }
+    constexpr uint8_t type() const { return type_; }
+    constexpr uint8_t code() const { return code_; }
+    constexpr uint16_t identifier() const { return identifier_; }
+    constexpr uint16_t sequence() const { return sequence_; }
+    constexpr uint16_t checksum() const { return checksum_; }
     
     std::vector<uint8_t> to_bytes() const;
+    constexpr std::array<uint8_t, MIN_SIZE> to_array() const {
+        std::array<uint8_t, MIN_SIZE> bytes{};
+        bytes[0] = type_;
+        bytes[1] = code_;
+        detail::store16(bytes, 2, checksum_);
+        detail::store16(bytes, 4, identifier_);
+        detail::store16(bytes, 6, sequence_);
+        return bytes;
+    }
+    
+    constexpr size_t wire_size() const { return MIN_SIZE; }
+    constexpr size_t write_to(uint8_t* out) const { return detail::copy_out(out, to_array()); }
+    size_t write_to(MutableByteSpan out) const { return detail::write_checked(*this, out); }
+    
+    static constexpr ParseResult<ICMPHeader> parse(const uint8_t* data, size_t length) {
+        if (length < MIN_SIZE) {
+            return ParseError::Truncated;
+        }
+        ICMPHeader header(data[0], data[1]);
+        header.identifier(detail::load16(data + 4)).sequence(detail::load16(data + 6));
+        header.checksum_ = detail::load16(data + CHECKSUM_OFFSET);
+        return header;
+    }
+    static constexpr ParseResult<ICMPHeader> parse(ByteSpan data) { return parse(data.data(), data.size()); }
+    
+    // Compile-time counterparts of the to_bytes() overloads below; the fixed
+    // payload is covered by the checksum but not part of the result
+    template <size_t N>
+    constexpr std::array<uint8_t, MIN_SIZE> to_array(const std::array<uint8_t, N>& payload) const {
+        return with_checksum(payload, 0);
+    }
+    template <size_t N = 0>
+    constexpr std::array<uint8_t, MIN_SIZE> to_array(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                                                     const std::array<uint8_t, N>& payload = {}) const {
+        return with_checksum(payload, detail::pseudo_header_sum(src_ip, dst_ip, IPv6Header::NEXT_HEADER_ICMPV6, MIN_SIZE + N));
+    }
+    
+    // Serialize with the ICMP checksum computed over this header and the payload
+    std::vector<uint8_t> to_bytes(const std::vector<uint8_t>& payload) const;
+    // ICMPv6: the checksum also covers the IPv6 pseudo-header
+    std::vector<uint8_t> to_bytes(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                                  const std::vector<uint8_t>& payload = {}) const;
+    // Same, written into caller storage
+    size_t write_to(uint8_t* out, ByteSpan payload) const;
+    size_t write_to(uint8_t* out, const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                    ByteSpan payload = {}) const;
+    size_t write_to(MutableByteSpan out, ByteSpan payload) const {
+        return detail::write_checked(*this, out, payload);
+    }
+    size_t write_to(MutableByteSpan out, const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                    ByteSpan payload = {}) const {
+        return detail::write_checked(*this, out, src_ip, dst_ip, payload);
+    }
+    
+    // Checksum calculation methods
+    uint16_t calculate_checksum(const std::vector<uint8_t>& payload = {}) const;
+    uint16_t calculate_checksum(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                               const std::vector<uint8_t>& payload = {}) const;
+    
+    ICMPHeader& update_checksum(const std::vector<uint8_t>& payload = {});
+    ICMPHeader& update_checksum(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                               const std::vector<uint8_t>& payload = {});
     
     // ICMP types
     static constexpr uint8_t TYPE_ECHO_REPLY = 0;
@@ -357,7 +1425,22 @@ public:
     static constexpr uint8_t TYPE_DEST_UNREACHABLE = 3;
     static constexpr uint8_t TYPE_TIME_EXCEEDED = 11;
     
+    // ICMPv6 types
+    static constexpr uint8_t TYPE_ECHO_REQUEST_V6 = 128;
+    static constexpr uint8_t TYPE_ECHO_REPLY_V6 = 129;
+    
 private:
+    static constexpr size_t CHECKSUM_OFFSET = 2;
+    
+    template <size_t N>
+    constexpr std::array<uint8_t, MIN_SIZE> with_checksum(const std::array<uint8_t, N>& payload,
+                                                          uint16_t pseudo_sum) const {
+        auto bytes = to_array();
+        detail::store16(bytes, CHECKSUM_OFFSET,
+                        detail::transport_checksum(bytes, CHECKSUM_OFFSET, payload, pseudo_sum));
+        return bytes;
+    }
+    
     uint8_t type_ = 0;
     uint8_t code_ = 0;
     uint16_t checksum_ = 0;
@@ -379,11 +1462,91 @@ public:
     PacketBuilder& icmp(const ICMPHeader& icmp);
     PacketBuilder& payload(const std::vector<uint8_t>& data);
     PacketBuilder& payload(const std::string& data);
+    PacketBuilder& payload(const uint8_t* data, size_t length);
+    
+    // A TCP/UDP/ICMP header added with a zero checksum leaves its checksum
+    // pending: everything appended after it is summed while being copied in
+    // (fused copy + checksum), and build() completes the checksum with the
+    // pseudo-header of the preceding IPv4/IPv6 header. Only the innermost
+    // transport header is completed.
+    std::vector<uint8_t> build() const &;
+    // Moves the buffer out instead of copying it and leaves the builder reset
+    std::vector<uint8_t> build() &&;
+    // Build into caller storage: the vector keeps its capacity, the span
+    // overload throws std::length_error when shorter than size()
+    void build_into(std::vector<uint8_t>& out) const;
+    size_t build_into(MutableByteSpan out) const;
     
-    std::vector<uint8_t> build() const;
+    // Length of the built packet, including padding and FCS
+    size_t size() const;
+    
+    // Room for `bytes` of headers and payload, so appending does not grow
+    // the buffer step by step
+    PacketBuilder& reserve(size_t bytes);
+    // Start a new packet, keeping the buffer's capacity
+    PacketBuilder& reset();
+    
+    // Have build() pad the frame to the Ethernet minimum and append the FCS
+    PacketBuilder& fcs(bool enable = true);
+    // Have build() fix every layer from where it ends up in the packet, in a
+    // single pass from the innermost layer out: IPv4 total length and header
+    // checksum, IPv6 payload length, UDP length, TCP/UDP/ICMP checksums and
+    // the MPLS bottom-of-stack bits. Lengths given to the headers are ignored,
+    // so headers can be added before the payload size is known. The innermost
+    // transport checksum reuses the sum taken while its payload was copied in.
+    // Throws std::length_error from build() past MAX_LAYERS headers.
+    PacketBuilder& finalize(bool enable = true);
+    
+    static constexpr size_t MAX_LAYERS = 16;
     
 private:
+    friend class PacketTemplate;  // reads the layer record
+    
+    void append(const uint8_t* data, size_t length);
+    // Headers are serialized on the stack, not through a temporary vector
+    template <typename Header>
+    void append_header(const Header& header) {
+        uint8_t bytes[MAX_HEADER_SIZE];
+        append(bytes, header.write_to(bytes));
+    }
+    enum class Layer : uint8_t { ETHERNET, IPV4, IPV6, MPLS, TCP, UDP, ICMP };
+    struct LayerRecord {
+        Layer type;
+        size_t offset;
+    };
+    
+    void add_layer(Layer type);
+    void begin_transport(uint8_t protocol, size_t checksum_offset, bool pending);
+    // Complete the pending checksum (or every layer, with finalize()) and the
+    // FCS over the `length` packet bytes at `frame`, which has room for
+    // size() bytes
+    void finish(uint8_t* frame, size_t length) const;
+    void complete_checksum(uint8_t* frame, size_t length) const;
+    void finalize_layers(uint8_t* frame, size_t length) const;
+    void finalize_transport(uint8_t* frame, size_t length, size_t index) const;
+    
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+    static constexpr size_t MAX_HEADER_SIZE = 60;  // IPv4 or TCP with options
+    
     std::vector<uint8_t> packet_;
+    
+    // Headers in the order they were added; counted past MAX_LAYERS so
+    // finalize can refuse an incomplete record
+    std::array<LayerRecord, MAX_LAYERS> layers_{};
+    size_t layer_count_ = 0;
+    
+    // Innermost transport header, summed as it is copied in; the checksum is
+    // pending when it was added as zero
+    size_t l3_offset_ = NONE;
+    bool l3_ipv6_ = false;
+    size_t l4_offset_ = NONE;
+    size_t l4_checksum_offset_ = 0;
+    uint8_t l4_protocol_ = 0;
+    uint16_t l4_sum_ = 0;
+    bool l4_pending_ = false;
+    
+    bool fcs_ = false;
+    bool finalize_ = false;
 };
 
 // Utility functions for common patterns
@@ -429,6 +1592,57 @@ namespace patterns {
         const MacAddress& src_mac, const MacAddress& dst_mac,
         uint32_t label, uint8_t ttl = 64, uint8_t tc = 0,
         const std::vector<uint8_t>& payload = {});
+    
+    // Fixed-size frames built entirely in constant expressions, so constant
+    // probes cost nothing to construct:
+    //   constexpr auto probe = patterns::icmp_ping_array(IPv4Address(10, 0, 0, 1),
+    //                                                    IPv4Address(10, 0, 0, 2), 1, 1);
+    
+    // Join fixed-size wire images (headers, payloads) into one frame
+    template <size_t... N>
+    constexpr std::array<uint8_t, (N + ... + 0)> concat(const std::array<uint8_t, N>&... parts) {
+        std::array<uint8_t, (N + ... + 0)> result{};
+        size_t offset = 0;
+        ((detail::store_bytes(result, offset, parts), offset += N), ...);
+        return result;
+    }
+    
+    constexpr std::array<uint8_t, IPv4Header::MIN_SIZE + ICMPHeader::MIN_SIZE> icmp_ping_array(
+        const IPv4Address& src_ip, const IPv4Address& dst_ip,
+        uint16_t identifier = 0, uint16_t sequence = 0) {
+        ICMPHeader icmp(ICMPHeader::TYPE_ECHO_REQUEST, 0);
+        icmp.identifier(identifier).sequence(sequence);
+        IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_ICMP);
+        ip.length(IPv4Header::MIN_SIZE + ICMPHeader::MIN_SIZE);
+        return concat(ip.to_array(), icmp.to_array(std::array<uint8_t, 0>{}));
+    }
+    
+    constexpr std::array<uint8_t, IPv4Header::MIN_SIZE + TCPHeader::MIN_SIZE> tcp_syn_array(
+        const IPv4Address& src_ip, const IPv4Address& dst_ip,
+        uint16_t src_port, uint16_t dst_port, uint32_t seq_num = 0) {
+        TCPHeader tcp(src_port, dst_port);
+        tcp.seq_num(seq_num).flags(TCPHeader::FLAG_SYN);
+        IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_TCP);
+        ip.length(IPv4Header::MIN_SIZE + TCPHeader::MIN_SIZE);
+        return concat(ip.to_array(), tcp.to_array(src_ip, dst_ip));
+    }
+    
+    template <size_t N>
+    constexpr std::array<uint8_t, IPv4Header::MIN_SIZE + UDPHeader::SIZE + N> udp_packet_array(
+        const IPv4Address& src_ip, const IPv4Address& dst_ip,
+        uint16_t src_port, uint16_t dst_port, const std::array<uint8_t, N>& payload) {
+        UDPHeader udp(src_port, dst_port, static_cast<uint16_t>(UDPHeader::SIZE + N));
+        IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP);
+        ip.length(static_cast<uint16_t>(IPv4Header::MIN_SIZE + UDPHeader::SIZE + N));
+        return concat(ip.to_array(), udp.to_array(src_ip, dst_ip, payload), payload);
+    }
+    
+    template <size_t N>
+    constexpr std::array<uint8_t, EthernetHeader::SIZE + N> ethernet_frame_array(
+        const MacAddress& src_mac, const MacAddress& dst_mac,
+        uint16_t ethertype, const std::array<uint8_t, N>& payload) {
+        return concat(EthernetHeader(dst_mac, src_mac, ethertype).to_array(), payload);
+    }
 }
 
 } // namespace cppscapy
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "network_headers.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cppscapy {
+
+// A frame held with free space on both sides of its bytes (headroom and
+// tailroom), mbuf style: pushing an outer header writes into the headroom
+// and stripping one moves the start forward, so encapsulation costs the
+// bytes added rather than a copy of the frame. Payloads too large for one
+// buffer continue in chained segments.
+//
+//   PacketBuffer frame(2048, 128);
+//   frame.put(builder);                 // the inner frame, built in place
+//   encap::push_mpls(frame, MPLSHeader(100));
+//   encap::push_vxlan(frame, tunnel);
+//
+// Buffers own their storage and the segments chained to them, and move but
+// do not copy.
+class PacketBuffer {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 2048;
+    static constexpr size_t DEFAULT_HEADROOM = 128;
+
+    // `capacity` bytes with the data starting (empty) `headroom` bytes in;
+    // throws std::invalid_argument when headroom > capacity
+    explicit PacketBuffer(size_t capacity = DEFAULT_CAPACITY, size_t headroom = DEFAULT_HEADROOM);
+    // A copy of `data` with `headroom` bytes before it and `tailroom` after
+    explicit PacketBuffer(ByteSpan data, size_t headroom = DEFAULT_HEADROOM, size_t tailroom = 0);
+    ~PacketBuffer();
+
+    PacketBuffer(PacketBuffer&& other) noexcept;
+    PacketBuffer& operator=(PacketBuffer&& other) noexcept;
+    PacketBuffer(const PacketBuffer&) = delete;
+    PacketBuffer& operator=(const PacketBuffer&) = delete;
+
+    // This segment's bytes
+    uint8_t* data() { return storage_.get() + offset_; }
+    const uint8_t* data() const { return storage_.get() + offset_; }
+    size_t size() const { return length_; }
+    MutableByteSpan bytes() { return MutableByteSpan(data(), length_); }
+    ByteSpan bytes() const { return ByteSpan(data(), length_); }
+
+    size_t capacity() const { return capacity_; }
+    size_t headroom() const { return offset_; }
+    size_t tailroom() const { return capacity_ - offset_ - length_; }
+
+    // Grow the data by `length` bytes at the front (from the headroom) or at
+    // the back of the last segment (from its tailroom) and return where the
+    // new bytes go; throw std::length_error when there is not enough room
+    uint8_t* prepend(size_t length);
+    uint8_t* append(size_t length);
+    // Drop `length` bytes from the front of the first segment or the back of
+    // the last one; throw std::length_error when the segment is shorter
+    void adjust(size_t length);
+    void trim(size_t length);
+
+    // Serialize a header (anything with wire_size() and write_to()) in front
+    // of the data or after it
+    template <typename Header>
+    uint8_t* push(const Header& header) {
+        uint8_t* out = prepend(header.wire_size());
+        header.write_to(out);
+        return out;
+    }
+    template <typename Header>
+    uint8_t* put(const Header& header) {
+        uint8_t* out = append(header.wire_size());
+        header.write_to(out);
+        return out;
+    }
+    // Build a whole packet straight into the tailroom
+    uint8_t* put(const PacketBuilder& builder);
+
+    // Append `data`, filling the last segment's tailroom and then chaining
+    // new segments of `segment_capacity` bytes (no headroom) for the rest
+    void append_data(ByteSpan data, size_t segment_capacity = DEFAULT_CAPACITY);
+    // Attach `segment` (and anything chained to it) after the last segment
+    PacketBuffer& chain(PacketBuffer segment);
+
+    PacketBuffer* next() { return next_.get(); }
+    const PacketBuffer* next() const { return next_.get(); }
+    size_t segment_count() const;
+    // Bytes in every segment, the packet's length
+    size_t total_size() const;
+
+    // The packet's bytes gathered from all segments; copy_to() throws
+    // std::length_error when `out` is shorter than total_size()
+    size_t copy_to(MutableByteSpan out) const;
+    std::vector<uint8_t> to_bytes() const;
+
+    // Empty the buffer for reuse with `headroom` bytes in front, keeping its
+    // storage and freeing chained segments
+    void reset(size_t headroom = DEFAULT_HEADROOM);
+
+private:
+    PacketBuffer& last();
+
+    std::unique_ptr<uint8_t[]> storage_;
+    size_t capacity_ = 0;
+    size_t offset_ = 0;  // start of the data
+    size_t length_ = 0;
+    std::unique_ptr<PacketBuffer> next_;
+};
+
+// Encapsulation in place on a PacketBuffer holding an Ethernet frame (no
+// FCS). Tags and labels go between the MAC addresses and the payload, so
+// only the addresses (and tags already present) move; outer headers go into
+// the headroom. Each throws std::length_error when the headroom is short and
+// std::invalid_argument when the frame does not have the layout it needs.
+namespace encap {
+    constexpr uint16_t ETHERTYPE_VLAN = 0x8100;
+    constexpr uint16_t VXLAN_PORT = 4789;
+    constexpr size_t VXLAN_SIZE = 8;
+
+    // Insert an 802.1Q tag (802.1ad with tpid 0x88A8) outside any present
+    void push_vlan(PacketBuffer& frame, uint16_t tci, uint16_t tpid = ETHERTYPE_VLAN);
+    // Remove the outermost tag and return its TCI
+    uint16_t pop_vlan(PacketBuffer& frame);
+
+    // Push a label on top of the frame's label stack, after any VLAN tags.
+    // The first label switches the EtherType to MPLS and gets the
+    // bottom-of-stack bit; later ones get it cleared.
+    void push_mpls(PacketBuffer& frame, MPLSHeader label);
+    // Remove the top label and return it; popping the bottom one restores
+    // the EtherType to `inner_ethertype`
+    MPLSHeader pop_mpls(PacketBuffer& frame, uint16_t inner_ethertype = EthernetHeader::ETHERTYPE_IPV4);
+
+    // Outer Ethernet/IPv4/UDP/VXLAN headers (RFC 7348) for one tunnel,
+    // serialized once. The EtherType, IP protocol and UDP destination port
+    // are set to match; the UDP checksum is zero, as RFC 7348 allows over
+    // IPv4. Throws std::invalid_argument when vni exceeds 24 bits.
+    class VxlanTunnel {
+    public:
+        VxlanTunnel(const EthernetHeader& outer_eth, const IPv4Header& outer_ip, uint16_t src_port, uint32_t vni);
+
+        // Bytes added in front of the frame
+        size_t size() const { return size_; }
+
+    private:
+        friend void push_vxlan(PacketBuffer& frame, const VxlanTunnel& tunnel);
+
+        std::array<uint8_t, EthernetHeader::SIZE + IPv4Header::MAX_SIZE + UDPHeader::SIZE + VXLAN_SIZE> outer_{};
+        size_t size_ = 0;
+        size_t udp_offset_ = 0;
+    };
+
+    // Wrap the frame (all segments) in the tunnel's headers, filling in the
+    // IP total length and checksum and the UDP length
+    void push_vxlan(PacketBuffer& frame, const VxlanTunnel& tunnel);
+    // Strip the outer headers and return the VNI
+    uint32_t pop_vxlan(PacketBuffer& frame);
+} // namespace encap
+
+} // namespace cppscapy
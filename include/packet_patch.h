@@ -0,0 +1,54 @@
+#pragma once
+
+#include "network_headers.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace cppscapy {
+namespace patch {
+
+// In-place field patches for already serialized frames. Each helper rewrites
+// the field and fixes every checksum that covers it with an RFC 1624
+// incremental update, so the cost is O(1) regardless of packet length.
+//
+// IPv4/IPv6 helpers take a pointer to the IP header and the number of bytes
+// available from there; when the transport header is present (and the packet
+// is not a non-first fragment) the UDP/TCP/ICMPv6 pseudo-header checksum is
+// adjusted too. IPv6 helpers find it behind hop-by-hop, routing, fragment,
+// authentication and destination options headers. A UDP-over-IPv4 checksum of zero ("not computed") is left alone,
+// and a UDP checksum that works out to zero is stored as 0xFFFF.
+
+// IPv4 header fields (header checksum only)
+void set_ipv4_tos(uint8_t* ip, uint8_t tos);
+void set_ipv4_id(uint8_t* ip, uint16_t id);
+void set_ipv4_ttl(uint8_t* ip, uint8_t ttl);
+
+// IPv4 addresses (header checksum + transport checksum)
+void set_ipv4_src(uint8_t* ip, size_t length, const IPv4Address& addr);
+void set_ipv4_dst(uint8_t* ip, size_t length, const IPv4Address& addr);
+
+// IPv6 addresses (transport checksum)
+void set_ipv6_src(uint8_t* ip, size_t length, const IPv6Address& addr);
+void set_ipv6_dst(uint8_t* ip, size_t length, const IPv6Address& addr);
+
+// UDP header fields, `udp` points at the UDP header
+void set_udp_src_port(uint8_t* udp, uint16_t port);
+void set_udp_dst_port(uint8_t* udp, uint16_t port);
+
+// TCP header fields, `tcp` points at the TCP header
+void set_tcp_src_port(uint8_t* tcp, uint16_t port);
+void set_tcp_dst_port(uint8_t* tcp, uint16_t port);
+void set_tcp_seq_num(uint8_t* tcp, uint32_t seq);
+void set_tcp_ack_num(uint8_t* tcp, uint32_t ack);
+void set_tcp_window_size(uint8_t* tcp, uint16_t window);
+void set_tcp_flags(uint8_t* tcp, uint8_t flags);
+// Timestamp option values; returns false when the segment has no timestamp
+// option and throws std::invalid_argument when its length byte is not 10
+bool set_tcp_timestamps(uint8_t* tcp, uint32_t value, uint32_t echo_reply);
+
+// ICMP / ICMPv6 echo fields, `icmp` points at the ICMP header
+void set_icmp_identifier(uint8_t* icmp, uint16_t id);
+void set_icmp_sequence(uint8_t* icmp, uint16_t seq);
+
+} // namespace patch
+} // namespace cppscapy
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "network_headers.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cppscapy {
+
+// Fixed-shape packets as a type: Stack<EthernetHeader, IPv4Header, UDPHeader,
+// Payload<N>> knows the offset and size of every layer at compile time and
+// serializes in one pass, innermost layer first, filling in what follows
+// from the layout the same way PacketBuilder::finalize() does: IPv4 total
+// length (and so its header checksum), IPv6 payload length, UDP length,
+// TCP/UDP/ICMP checksums and the MPLS bottom-of-stack bits.
+//
+//   constexpr auto probe = EthernetHeader(dst_mac, src_mac, EthernetHeader::ETHERTYPE_IPV4)
+//                        / IPv4Header(src, dst, IPv4Header::PROTOCOL_UDP)
+//                        / UDPHeader(4000, 53)
+//                        / Payload<4>({1, 2, 3, 4});
+//   constexpr auto bytes = probe.to_array();     // std::array<uint8_t, 46>
+//
+// Layers have no options, since those would make the size a run-time value;
+// a header carrying options throws std::invalid_argument when serialized.
+// Layering is checked with a static_assert against carries<Lower, Upper>,
+// which can be specialized to allow more combinations.
+
+// A fixed-size block of raw bytes, the innermost layer of a stack
+template <size_t N>
+class Payload {
+public:
+    static constexpr size_t SIZE = N;
+
+    constexpr Payload() = default;
+    constexpr Payload(const std::array<uint8_t, N>& bytes) : bytes_(bytes) {}
+
+    constexpr const std::array<uint8_t, N>& bytes() const { return bytes_; }
+    constexpr uint8_t& operator[](size_t index) { return bytes_[index]; }
+    constexpr uint8_t operator[](size_t index) const { return bytes_[index]; }
+
+    constexpr size_t wire_size() const { return N; }
+    constexpr std::array<uint8_t, N> to_array() const { return bytes_; }
+
+private:
+    std::array<uint8_t, N> bytes_{};
+};
+
+// Whether `Lower` may directly carry `Upper`
+template <typename Lower, typename Upper>
+struct carries : std::false_type {};
+
+template <> struct carries<EthernetHeader, IPv4Header> : std::true_type {};
+template <> struct carries<EthernetHeader, IPv6Header> : std::true_type {};
+template <> struct carries<EthernetHeader, MPLSHeader> : std::true_type {};
+template <> struct carries<MPLSHeader, MPLSHeader> : std::true_type {};
+template <> struct carries<MPLSHeader, IPv4Header> : std::true_type {};
+template <> struct carries<MPLSHeader, IPv6Header> : std::true_type {};
+template <> struct carries<MPLSHeader, EthernetHeader> : std::true_type {};  // pseudowire
+template <> struct carries<IPv4Header, IPv4Header> : std::true_type {};
+template <> struct carries<IPv4Header, IPv6Header> : std::true_type {};
+template <> struct carries<IPv4Header, TCPHeader> : std::true_type {};
+template <> struct carries<IPv4Header, UDPHeader> : std::true_type {};
+template <> struct carries<IPv4Header, ICMPHeader> : std::true_type {};
+template <> struct carries<IPv6Header, IPv4Header> : std::true_type {};
+template <> struct carries<IPv6Header, IPv6Header> : std::true_type {};
+template <> struct carries<IPv6Header, TCPHeader> : std::true_type {};
+template <> struct carries<IPv6Header, UDPHeader> : std::true_type {};
+template <> struct carries<IPv6Header, ICMPHeader> : std::true_type {};
+
+// Any header can carry raw bytes; nothing goes above them
+template <typename Lower, size_t N>
+struct carries<Lower, Payload<N>> : std::true_type {};
+template <size_t N, typename Upper>
+struct carries<Payload<N>, Upper> : std::false_type {};
+template <size_t N, size_t M>
+struct carries<Payload<N>, Payload<M>> : std::false_type {};
+
+namespace detail {
+    // Wire size of each kind of layer in a stack
+    template <typename Layer>
+    struct stack_layer : std::false_type {};
+
+    template <> struct stack_layer<EthernetHeader> : std::true_type { static constexpr size_t SIZE = EthernetHeader::SIZE; };
+    template <> struct stack_layer<IPv4Header> : std::true_type { static constexpr size_t SIZE = IPv4Header::MIN_SIZE; };
+    template <> struct stack_layer<IPv6Header> : std::true_type { static constexpr size_t SIZE = IPv6Header::SIZE; };
+    template <> struct stack_layer<MPLSHeader> : std::true_type { static constexpr size_t SIZE = MPLSHeader::SIZE; };
+    template <> struct stack_layer<TCPHeader> : std::true_type { static constexpr size_t SIZE = TCPHeader::MIN_SIZE; };
+    template <> struct stack_layer<UDPHeader> : std::true_type { static constexpr size_t SIZE = UDPHeader::SIZE; };
+    template <> struct stack_layer<ICMPHeader> : std::true_type { static constexpr size_t SIZE = ICMPHeader::MIN_SIZE; };
+    template <size_t N> struct stack_layer<Payload<N>> : std::true_type { static constexpr size_t SIZE = N; };
+
+    template <typename Layer>
+    constexpr bool is_stack_layer = stack_layer<Layer>::value;
+
+    // Instantiated once per adjacent pair, so the error names both types
+    template <typename Lower, typename Upper>
+    struct check_layering {
+        static_assert(carries<Lower, Upper>::value,
+                      "Invalid layering: Lower cannot carry Upper (specialize cppscapy::carries to allow it)");
+        static constexpr bool value = true;
+    };
+
+    template <typename... Layers, size_t... I>
+    constexpr bool check_stack(std::index_sequence<I...>) {
+        using Tuple = std::tuple<Layers...>;
+        return (check_layering<std::tuple_element_t<I, Tuple>, std::tuple_element_t<I + 1, Tuple>>::value && ...);
+    }
+}
+
+template <typename... Layers>
+class Stack {
+    static_assert(sizeof...(Layers) > 0, "A stack needs at least one layer");
+    static_assert((detail::is_stack_layer<Layers> && ...),
+                  "Stack layers are the fixed-size header classes and Payload<N>");
+    static_assert(detail::check_stack<Layers...>(std::make_index_sequence<sizeof...(Layers) - 1>{}),
+                  "Invalid layering");
+
+public:
+    static constexpr size_t LAYERS = sizeof...(Layers);
+    static constexpr size_t SIZE = (detail::stack_layer<Layers>::SIZE + ...);
+
+    template <size_t I>
+    using Layer = std::tuple_element_t<I, std::tuple<Layers...>>;
+
+    // Where layer `index` starts in the serialized packet
+    static constexpr size_t offset(size_t index) {
+        constexpr size_t sizes[] = {detail::stack_layer<Layers>::SIZE...};
+        size_t result = 0;
+        for (size_t i = 0; i < index; ++i) {
+            result += sizes[i];
+        }
+        return result;
+    }
+
+    constexpr Stack() = default;
+    constexpr explicit Stack(const Layers&... layers) : layers_(layers...) {}
+
+    template <size_t I>
+    constexpr Layer<I>& get() { return std::get<I>(layers_); }
+    template <size_t I>
+    constexpr const Layer<I>& get() const { return std::get<I>(layers_); }
+
+    // A new stack with `upper` on top
+    template <typename Upper>
+    constexpr Stack<Layers..., Upper> push(const Upper& upper) const {
+        return std::apply([&](const Layers&... layers) { return Stack<Layers..., Upper>(layers..., upper); },
+                          layers_);
+    }
+
+    constexpr size_t wire_size() const { return SIZE; }
+    constexpr std::array<uint8_t, SIZE> to_array() const {
+        std::array<uint8_t, SIZE> bytes{};
+        write_to(bytes.data());
+        return bytes;
+    }
+    constexpr size_t write_to(uint8_t* out) const {
+        uint16_t sum = 0;
+        write_layers(out, sum, std::make_index_sequence<LAYERS>{});
+        return SIZE;
+    }
+    size_t write_to(MutableByteSpan out) const { return detail::write_checked(*this, out); }
+    std::vector<uint8_t> to_bytes() const {
+        std::vector<uint8_t> bytes(SIZE);
+        write_to(bytes.data());
+        return bytes;
+    }
+
+private:
+    static constexpr bool is_transport(size_t index) {
+        constexpr bool transport[] = {(std::is_same_v<Layers, TCPHeader> || std::is_same_v<Layers, UDPHeader> ||
+                                       std::is_same_v<Layers, ICMPHeader>)...};
+        return transport[index];
+    }
+
+    // Whether a transport checksum below layer I covers it
+    static constexpr bool covered(size_t index) {
+        for (size_t i = 0; i < index; ++i) {
+            if (is_transport(i)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The nearest IPv4/IPv6 layer below layer `index`, or LAYERS
+    static constexpr size_t enclosing_ip(size_t index) {
+        constexpr bool is_ip[] = {(std::is_same_v<Layers, IPv4Header> || std::is_same_v<Layers, IPv6Header>)...};
+        for (size_t i = index; i-- > 0;) {
+            if (is_ip[i]) {
+                return i;
+            }
+        }
+        return LAYERS;
+    }
+
+    template <size_t... I>
+    constexpr void write_layers(uint8_t* out, uint16_t& sum, std::index_sequence<I...>) const {
+        // Innermost first, with `sum` carrying the sum of the layers written
+        // so far: a transport checksum is then taken from the layer images
+        // already in hand instead of re-reading the output
+        (write_layer<LAYERS - 1 - I>(out, sum), ...);
+    }
+
+    template <size_t I>
+    constexpr void write_layer(uint8_t* out, uint16_t& sum) const {
+        using Header = Layer<I>;
+        constexpr size_t OFFSET = offset(I);
+        constexpr size_t EXTENT = SIZE - OFFSET;
+
+        Header header = std::get<I>(layers_);
+        if (header.wire_size() != detail::stack_layer<Header>::SIZE) {
+            throw std::invalid_argument("Stack layers cannot carry header options");
+        }
+        if constexpr (std::is_same_v<Header, IPv4Header>) {
+            header.length(static_cast<uint16_t>(EXTENT));
+        } else if constexpr (std::is_same_v<Header, IPv6Header>) {
+            header.payload_length(static_cast<uint16_t>(EXTENT - IPv6Header::SIZE));
+        } else if constexpr (std::is_same_v<Header, MPLSHeader>) {
+            if constexpr (I + 1 < LAYERS) {
+                header.bottom_of_stack(!std::is_same_v<Layer<I + 1>, MPLSHeader>);
+            } else {
+                header.bottom_of_stack(true);
+            }
+        } else if constexpr (std::is_same_v<Header, UDPHeader>) {
+            header.length(static_cast<uint16_t>(EXTENT));
+        }
+
+        auto bytes = header.to_array();
+        if constexpr (is_transport(I)) {
+            write_checksum<I>(bytes, sum);
+        }
+        detail::copy_out(out + OFFSET, bytes);
+        if constexpr (covered(I)) {
+            // Every layer starts at an even offset, so the sums chain
+            sum = checksum::partial(bytes, sum);
+        }
+    }
+
+    template <size_t I, size_t N>
+    constexpr void write_checksum(std::array<uint8_t, N>& bytes, uint16_t above) const {
+        using Header = Layer<I>;
+        constexpr size_t IP = enclosing_ip(I);
+        constexpr size_t EXTENT = SIZE - offset(I);
+        constexpr bool ICMP = std::is_same_v<Header, ICMPHeader>;
+        constexpr bool UDP = std::is_same_v<Header, UDPHeader>;
+        constexpr size_t CHECKSUM_OFFSET = ICMP ? 2 : (UDP ? 6 : 16);
+
+        uint32_t initial = above;
+        if constexpr (IP < LAYERS) {
+            const auto& ip = std::get<IP>(layers_);
+            uint8_t protocol = UDP ? IPv4Header::PROTOCOL_UDP : IPv4Header::PROTOCOL_TCP;
+            if constexpr (std::is_same_v<Layer<IP>, IPv6Header>) {
+                protocol = ICMP ? IPv6Header::NEXT_HEADER_ICMPV6 : protocol;
+                initial += detail::pseudo_header_sum(ip.src(), ip.dst(), protocol, EXTENT);
+            } else if constexpr (!ICMP) {
+                initial += detail::pseudo_header_sum(ip.src(), ip.dst(), protocol, EXTENT);
+            }
+        } else if constexpr (!ICMP) {
+            return;  // no addresses for the pseudo-header
+        }
+
+        detail::store16(bytes, CHECKSUM_OFFSET, 0);
+        uint16_t value = checksum::finish(checksum::partial(bytes, initial));
+        if (UDP && value == 0) {
+            value = 0xFFFF;
+        }
+        detail::store16(bytes, CHECKSUM_OFFSET, value);
+    }
+
+    std::tuple<Layers...> layers_;
+};
+
+// Scapy-style composition: eth / ip / udp / payload
+template <typename Lower, typename Upper,
+          typename = std::enable_if_t<detail::is_stack_layer<Lower> && detail::is_stack_layer<Upper>>>
+constexpr Stack<Lower, Upper> operator/(const Lower& lower, const Upper& upper) {
+    return Stack<Lower, Upper>(lower, upper);
+}
+
+template <typename... Layers, typename Upper, typename = std::enable_if_t<detail::is_stack_layer<Upper>>>
+constexpr Stack<Layers..., Upper> operator/(const Stack<Layers...>& stack, const Upper& upper) {
+    return stack.push(upper);
+}
+
+} // namespace cppscapy
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "network_headers.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cppscapy {
+
+// Values for one field of a stamped packet. Values wider than the field are
+// truncated to its low bits.
+class FieldGenerator {
+public:
+    // start, start + step, start + 2 * step, ...
+    static FieldGenerator sequence(uint64_t start, uint64_t step = 1);
+    // The values in turn, then again from the first; throws
+    // std::invalid_argument when empty
+    static FieldGenerator list(std::vector<uint64_t> values);
+    // first, first + 1, ..., last, first, ...; throws std::invalid_argument
+    // when last < first
+    static FieldGenerator range(uint64_t first, uint64_t last);
+    // Uniform in [min, max] from a seeded xorshift generator, so a run can be
+    // repeated; throws std::invalid_argument when max < min
+    static FieldGenerator random(uint64_t min, uint64_t max, uint64_t seed = 0x9E3779B97F4A7C15ull);
+
+    // Inline, as it runs for every field of every packet
+    uint64_t next() {
+        uint64_t value = current_;
+        switch (kind_) {
+        case Kind::SEQUENCE:
+            current_ += step_;
+            break;
+        case Kind::LIST:
+            value = values_[index_];
+            index_ = index_ + 1 == values_.size() ? 0 : index_ + 1;
+            break;
+        case Kind::RANGE:
+            current_ = value == last_ ? first_ : value + 1;
+            break;
+        case Kind::RANDOM:
+            current_ ^= current_ << 13;
+            current_ ^= current_ >> 7;
+            current_ ^= current_ << 17;
+            value = first_ + scale(current_);
+            break;
+        }
+        return value;
+    }
+
+private:
+    enum class Kind : uint8_t { SEQUENCE, LIST, RANGE, RANDOM };
+
+    explicit FieldGenerator(Kind kind) : kind_(kind) {}
+
+    // A random value in [0, span), or any value when the span is 2^64
+    uint64_t scale(uint64_t random) const {
+        if (span_ == 0) {
+            return random;
+        }
+        if (span_ <= (uint64_t(1) << 32)) {
+            return ((random >> 32) * span_) >> 32;
+        }
+        return random % span_;
+    }
+
+    Kind kind_;
+    uint64_t current_ = 0;  // next value, or the random state
+    uint64_t step_ = 0;
+    uint64_t first_ = 0;
+    uint64_t last_ = 0;
+    uint64_t span_ = 0;
+    std::vector<uint64_t> values_;
+    size_t index_ = 0;
+};
+
+// A packet serialized once and stamped out many times with some fields
+// changed. Stamping copies the frame, writes each field from its generator
+// and fixes every checksum covering it (IPv4 header, TCP/UDP/ICMP including
+// the pseudo-header, outer headers of a tunnel) incrementally, RFC 1624
+// style, so the cost per packet is a copy plus a few stores whatever the
+// headers are. The FCS, when the builder adds one, is recomputed.
+//
+//   PacketTemplate flows(PacketBuilder().ethernet(eth).ipv4(ip).udp(udp).payload(data));
+//   flows.set(PacketTemplate::Field::SRC_PORT, FieldGenerator::range(1024, 65535))
+//        .set(PacketTemplate::Field::IPV4_DST, FieldGenerator::random(0x0A000001, 0x0A0000FF));
+//   flows.stamp_batch(MutableByteSpan(ring), 32, 2048);
+//
+// Named fields refer to the innermost IP header and the transport header
+// following it; payload offsets count from the end of the last header.
+class PacketTemplate {
+public:
+    enum class Field : uint8_t {
+        IPV4_SRC,
+        IPV4_DST,
+        IPV6_SRC,   // low 64 bits (the interface identifier)
+        IPV6_DST,
+        SRC_PORT,   // TCP or UDP
+        DST_PORT,
+        IP_ID,      // IPv4 identification
+        TCP_SEQ,
+        VLAN_ID     // 802.1Q/802.1ad tag after the first Ethernet header
+    };
+
+    // Builds the packet with finalize() enabled, so the lengths and
+    // checksums the incremental updates start from are valid
+    explicit PacketTemplate(const PacketBuilder& builder);
+
+    // Throw std::invalid_argument when the packet lacks the field or it
+    // overlaps another one; setting a named field again replaces it
+    PacketTemplate& set(Field field, FieldGenerator generator);
+    // `width` bytes (1-8, big-endian) at `offset` into the payload
+    PacketTemplate& set_payload(size_t offset, size_t width, FieldGenerator generator);
+
+    size_t size() const { return frame_.size(); }
+    const std::vector<uint8_t>& frame() const { return frame_; }
+
+    // The next packet, into size() bytes at `out`
+    void stamp(uint8_t* out);
+    void stamp_into(std::vector<uint8_t>& out);
+    // `count` packets, `stride` bytes apart (size() when 0); throws
+    // std::length_error when `out` is too short
+    size_t stamp_batch(MutableByteSpan out, size_t count, size_t stride = 0);
+
+private:
+    struct Checksum {
+        size_t offset;     // of the checksum field
+        size_t begin;      // bytes summed
+        size_t end;
+        size_t pseudo_begin;  // pseudo-header addresses, if any
+        size_t pseudo_end;
+        uint16_t initial;  // complement of the template's checksum
+        bool udp;
+        uint32_t covered_by;  // outer checksums over this one, by index
+    };
+
+    struct Slot {
+        int key;           // Field, or -1 for payload bytes
+        FieldGenerator generator;
+        size_t offset;
+        size_t width;
+        uint64_t mask;     // bits of the field the generator drives
+        uint64_t original;
+        uint16_t removed;  // complement of the original's sum
+        bool swapped;      // starts at an odd offset relative to its width
+        uint32_t covers;   // checksums over it, by index
+    };
+
+    PacketTemplate& add_slot(int key, size_t offset, size_t width, uint64_t mask, FieldGenerator generator);
+
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+
+    std::vector<uint8_t> frame_;
+    size_t length_ = 0;  // without padding and FCS
+    bool fcs_ = false;
+
+    size_t vlan_offset_ = NONE;
+    size_t ip_offset_ = NONE;
+    bool ipv6_ = false;
+    size_t tcp_offset_ = NONE;
+    size_t ports_offset_ = NONE;
+    size_t payload_offset_ = 0;
+
+    std::vector<Checksum> checksums_;
+    std::vector<Slot> slots_;
+};
+
+} // namespace cppscapy
@@ -1,6 +1,10 @@
 #pragma once
 
+#include "crc.h"
 #include "header_dsl.h"
+#include "header_view.h"
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <fstream>
@@ -19,6 +23,13 @@ constexpr uint32_t PCAP_MAGIC_NUMBER_SWAPPED = 0xd4c3b2a1;
 constexpr uint16_t PCAP_VERSION_MAJOR = 2;
 constexpr uint16_t PCAP_VERSION_MINOR = 4;
 
+// The pcap link-type field also says whether captured frames keep their
+// FCS: bit 26 is set and bits 28-31 give the FCS length in 16-bit units
+constexpr uint32_t PCAP_LINK_TYPE_MASK = 0x0000FFFF;
+constexpr uint32_t PCAP_FCS_PRESENT = 0x04000000;
+constexpr uint32_t PCAP_FCS_LENGTH_SHIFT = 28;
+constexpr uint32_t ETHERNET_FCS_SIZE = 4;
+
 // Link layer types (from pcap-bpf.h)
 enum class LinkType : uint32_t {
   NULL_LINK = 0,            // BSD loopback encapsulation
@@ -84,6 +95,18 @@ public:
     return header.from_bytes(header_data);
   }
 
+  // Zero-copy view of the header at `offset` (see header_view.h), e.g.
+  // packet.view<Ipv4View>(14).ttl(). Views are unchecked; use their
+  // parse() to validate first.
+  template <typename View> View view(size_t offset = 0) const {
+    offset = std::min(offset, data_.size());
+    return View(data_.data() + offset, data_.size() - offset);
+  }
+  template <typename View> View view(size_t offset = 0) {
+    offset = std::min(offset, data_.size());
+    return View(data_.data() + offset, data_.size() - offset);
+  }
+
   // Getters and setters
   const std::vector<uint8_t> &data() const { return data_; }
   void set_data(const std::vector<uint8_t> &data) { data_ = data; }
@@ -135,10 +158,18 @@ public:
     }
   }
 
+  // Append an Ethernet FCS to every frame written and flag it in the file
+  // header. Must be called before open(); frames must not already carry one.
+  void set_append_fcs(bool enable = true) { append_fcs_ = enable; }
+  bool append_fcs() const { return append_fcs_; }
+
   bool write_packet(const Packet &packet) {
     if (!file_.is_open()) {
       return false;
     }
+    if (append_fcs_) {
+      return write_packet_with_fcs(packet);
+    }
 
     auto time_point = packet.timestamp();
     auto time_t = std::chrono::system_clock::to_time_t(time_point);
@@ -179,15 +210,56 @@ private:
     global_header.sigfigs = 0;
     global_header.snaplen = snaplen_;
     global_header.network = static_cast<uint32_t>(link_type_);
+    if (append_fcs_) {
+      global_header.network |=
+          PCAP_FCS_PRESENT |
+          ((ETHERNET_FCS_SIZE / 2) << PCAP_FCS_LENGTH_SHIFT);
+    }
 
     file_.write(reinterpret_cast<const char *>(&global_header),
                 sizeof(global_header));
     return file_.good();
   }
 
+  // Writes the frame, its padding and FCS without copying the frame
+  bool write_packet_with_fcs(const Packet &packet) {
+    const auto &data = packet.data();
+    size_t padding = data.size() < 60 ? 60 - data.size() : 0;
+    std::array<uint8_t, 64> tail{};
+    uint32_t fcs = crc::crc32(data.data(), data.size());
+    fcs = crc::crc32(tail.data(), padding, fcs);
+    for (size_t i = 0; i < ETHERNET_FCS_SIZE; ++i) {
+      tail[padding + i] = static_cast<uint8_t>(fcs >> (8 * i));
+    }
+    size_t tail_size = padding + ETHERNET_FCS_SIZE;
+    size_t total = data.size() + tail_size;
+
+    auto time_point = packet.timestamp();
+    auto time_t = std::chrono::system_clock::to_time_t(time_point);
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                      time_point.time_since_epoch()) %
+                  1000000;
+
+    PcapPacketHeader pkt_header;
+    pkt_header.ts_sec = static_cast<uint32_t>(time_t);
+    pkt_header.ts_usec = static_cast<uint32_t>(micros.count());
+    pkt_header.incl_len = static_cast<uint32_t>(
+        std::min(total, static_cast<size_t>(snaplen_)));
+    pkt_header.orig_len = static_cast<uint32_t>(total);
+    file_.write(reinterpret_cast<const char *>(&pkt_header),
+                sizeof(pkt_header));
+
+    size_t frame_bytes = std::min(data.size(), size_t(pkt_header.incl_len));
+    file_.write(reinterpret_cast<const char *>(data.data()), frame_bytes);
+    file_.write(reinterpret_cast<const char *>(tail.data()),
+                pkt_header.incl_len - frame_bytes);
+    return file_.good();
+  }
+
   std::string filename_;
   LinkType link_type_;
   uint32_t snaplen_;
+  bool append_fcs_ = false;
   std::ofstream file_;
 };
 
@@ -255,6 +327,10 @@ public:
 
   uint32_t get_snaplen() const { return snaplen_; }
 
+  // Whether captured frames end with an FCS, and its length in bytes
+  bool has_fcs() const { return fcs_length_ != 0; }
+  size_t fcs_length() const { return fcs_length_; }
+
 private:
   bool read_global_header() {
     PcapGlobalHeader global_header;
@@ -277,7 +353,12 @@ private:
       return false; // Invalid magic number
     }
 
-    link_type_ = static_cast<LinkType>(global_header.network);
+    link_type_ = static_cast<LinkType>(global_header.network &
+                                       PCAP_LINK_TYPE_MASK);
+    if (global_header.network & PCAP_FCS_PRESENT) {
+      fcs_length_ =
+          2 * (global_header.network >> PCAP_FCS_LENGTH_SHIFT);
+    }
     snaplen_ = global_header.snaplen;
 
     return true;
@@ -299,6 +380,7 @@ private:
   std::string filename_;
   LinkType link_type_;
   uint32_t snaplen_;
+  size_t fcs_length_ = 0;
   bool swapped_ = false;
   std::ifstream file_;
 };
@@ -345,9 +427,11 @@ inline Packet create_udp_packet(const dsl::EthernetHeader &eth_header,
   packet.add_header(eth_header);
 
   // Create IPv4 header
+  constexpr IPv4Address src = "192.168.1.1"_ipv4;
+  constexpr IPv4Address dst = "192.168.1.100"_ipv4;
   dsl::IPv4Header ip;
-  ip.set_src_ip("192.168.1.1");
-  ip.set_dst_ip("192.168.1.100");
+  ip.set_src_ip(src);
+  ip.set_dst_ip(dst);
   ip.set_protocol(17); // UDP protocol
   ip.set_total_length(20 + 8 +
                       payload.size()); // IP header + UDP header + payload
@@ -374,9 +458,11 @@ inline Packet create_tcp_packet(const dsl::EthernetHeader &eth_header,
   packet.add_header(eth_header);
 
   // Create IPv4 header
+  constexpr IPv4Address src = "192.168.1.1"_ipv4;
+  constexpr IPv4Address dst = "192.168.1.100"_ipv4;
   dsl::IPv4Header ip;
-  ip.set_src_ip("192.168.1.1");
-  ip.set_dst_ip("192.168.1.100");
+  ip.set_src_ip(src);
+  ip.set_dst_ip(dst);
   ip.set_protocol(6); // TCP protocol
   ip.set_total_length(20 + 20 +
                       payload.size()); // IP header + TCP header + payload
@@ -384,8 +470,10 @@ inline Packet create_tcp_packet(const dsl::EthernetHeader &eth_header,
   ip.update_computed_fields();
   packet.add_header(ip);
 
-  // Add TCP header
-  packet.add_header(tcp_header);
+  // Add TCP header with its checksum over the pseudo-header and payload
+  dsl::TCPHeader tcp = tcp_header;
+  tcp.update_checksum(ip.src_ip(), ip.dst_ip(), payload);
+  packet.add_header(tcp);
 
   if (!payload.empty()) {
     packet.set_payload(payload);
@@ -400,6 +488,17 @@ struct DecodedPacket {
   bool has_ipv4 = false;
   bool has_udp = false;
   bool has_tcp = false;
+  bool has_sctp = false;
+
+  // SCTP common header (RFC 4960); the checksum is verified while decoding
+  uint16_t sctp_src_port = 0;
+  uint16_t sctp_dst_port = 0;
+  uint32_t sctp_verification_tag = 0;
+  bool sctp_checksum_valid = false;
+
+  // Trailing Ethernet FCS, when decoded from a capture that keeps it
+  bool has_fcs = false;
+  bool fcs_valid = false;
 
   // Parsed headers
   dsl::EthernetHeader ethernet;
@@ -419,12 +518,15 @@ struct DecodedPacket {
   bool is_ipv4_packet() const { return has_ethernet && has_ipv4; }
   bool is_udp_packet() const { return is_ipv4_packet() && has_udp; }
   bool is_tcp_packet() const { return is_ipv4_packet() && has_tcp; }
+  bool is_sctp_packet() const { return is_ipv4_packet() && has_sctp; }
 
   std::string get_protocol_string() const {
     if (is_tcp_packet())
       return "TCP";
     if (is_udp_packet())
       return "UDP";
+    if (is_sctp_packet())
+      return "SCTP";
     if (is_ipv4_packet())
       return "IPv4";
     if (has_ethernet)
@@ -434,21 +536,30 @@ struct DecodedPacket {
 
   // Get source/destination info as strings
   std::string get_src_ip() const {
-    if (!has_ipv4)
-      return "";
-    uint32_t ip = ipv4.src_ip();
-    return std::to_string((ip >> 24) & 0xFF) + "." +
-           std::to_string((ip >> 16) & 0xFF) + "." +
-           std::to_string((ip >> 8) & 0xFF) + "." + std::to_string(ip & 0xFF);
+    return has_ipv4 ? src_address().to_string() : "";
   }
 
   std::string get_dst_ip() const {
-    if (!has_ipv4)
-      return "";
-    uint32_t ip = ipv4.dst_ip();
-    return std::to_string((ip >> 24) & 0xFF) + "." +
-           std::to_string((ip >> 16) & 0xFF) + "." +
-           std::to_string((ip >> 8) & 0xFF) + "." + std::to_string(ip & 0xFF);
+    return has_ipv4 ? dst_address().to_string() : "";
+  }
+
+  // The DSL headers hold addresses as host-order integers
+  IPv4Address src_address() const {
+    return IPv4Address(detail::network_order32(ipv4.src_ip()));
+  }
+  IPv4Address dst_address() const {
+    return IPv4Address(detail::network_order32(ipv4.dst_ip()));
+  }
+  MacAddress src_mac() const { return mac_from_field(ethernet.src_mac()); }
+  MacAddress dst_mac() const { return mac_from_field(ethernet.dst_mac()); }
+
+  static MacAddress mac_from_field(uint64_t field) {
+    return MacAddress(static_cast<uint8_t>(field >> 40),
+                      static_cast<uint8_t>(field >> 32),
+                      static_cast<uint8_t>(field >> 24),
+                      static_cast<uint8_t>(field >> 16),
+                      static_cast<uint8_t>(field >> 8),
+                      static_cast<uint8_t>(field));
   }
 
   uint16_t get_src_port() const {
@@ -456,6 +567,8 @@ struct DecodedPacket {
       return udp.src_port();
     if (is_tcp_packet())
       return tcp.src_port();
+    if (is_sctp_packet())
+      return sctp_src_port;
     return 0;
   }
 
@@ -464,22 +577,33 @@ struct DecodedPacket {
       return udp.dst_port();
     if (is_tcp_packet())
       return tcp.dst_port();
+    if (is_sctp_packet())
+      return sctp_dst_port;
     return 0;
   }
 };
 
-// Decode an Ethernet-based packet
-inline DecodedPacket decode_packet(const Packet &packet) {
+// Decode an Ethernet-based packet. With `has_fcs` (see
+// PcapReader::has_fcs()) the last 4 bytes are checked as the frame's FCS
+// and kept out of the payload.
+inline DecodedPacket decode_packet(const Packet &packet,
+                                   bool has_fcs = false) {
   DecodedPacket decoded;
   const auto &data = packet.data();
   size_t offset = 0;
 
   // Check minimum size for Ethernet header
-  if (data.size() < 14) {
+  size_t fcs_size = has_fcs ? ETHERNET_FCS_SIZE : 0;
+  if (data.size() < 14 + fcs_size) {
     decoded.decode_error = true;
     decoded.error_message = "Packet too small for Ethernet header";
     return decoded;
   }
+  if (has_fcs) {
+    decoded.has_fcs = true;
+    decoded.fcs_valid = crc::verify_fcs(data.data(), data.size());
+  }
+  size_t end = data.size() - fcs_size;
 
   // Parse Ethernet header
   if (!packet.parse_header(decoded.ethernet, offset)) {
@@ -493,7 +617,7 @@ inline DecodedPacket decode_packet(const Packet &packet) {
   // Check if it's IPv4
   if (decoded.ethernet.ethertype() == dsl::EtherType::IPv4) {
     // Check minimum size for IPv4 header
-    if (data.size() < offset + 20) {
+    if (end < offset + 20) {
       decoded.decode_error = true;
       decoded.error_message = "Packet too small for IPv4 header";
       return decoded;
@@ -516,7 +640,7 @@ inline DecodedPacket decode_packet(const Packet &packet) {
 
     if (protocol == 17) { // UDP
       // Check minimum size for UDP header
-      if (data.size() < offset + 8) {
+      if (end < offset + 8) {
         decoded.decode_error = true;
         decoded.error_message = "Packet too small for UDP header";
         return decoded;
@@ -533,7 +657,7 @@ inline DecodedPacket decode_packet(const Packet &packet) {
 
     } else if (protocol == 6) { // TCP
       // Check minimum size for TCP header
-      if (data.size() < offset + 20) {
+      if (end < offset + 20) {
         decoded.decode_error = true;
         decoded.error_message = "Packet too small for TCP header";
         return decoded;
@@ -550,13 +674,38 @@ inline DecodedPacket decode_packet(const Packet &packet) {
       // Get TCP header length (data offset * 4 bytes)
       size_t tcp_header_len = decoded.tcp.data_offset() * 4;
       offset += tcp_header_len;
+
+    } else if (protocol == 132) { // SCTP
+      // Check minimum size for SCTP common header
+      if (end < offset + 12) {
+        decoded.decode_error = true;
+        decoded.error_message = "Packet too small for SCTP header";
+        return decoded;
+      }
+
+      const uint8_t *sctp = data.data() + offset;
+      decoded.sctp_src_port = (sctp[0] << 8) | sctp[1];
+      decoded.sctp_dst_port = (sctp[2] << 8) | sctp[3];
+      decoded.sctp_verification_tag =
+          (static_cast<uint32_t>(sctp[4]) << 24) | (sctp[5] << 16) |
+          (sctp[6] << 8) | sctp[7];
+      decoded.has_sctp = true;
+
+      // The CRC covers the datagram up to the IPv4 total length, which
+      // excludes any Ethernet padding in the capture
+      size_t ip_end = offset - ipv4_header_len + decoded.ipv4.total_length();
+      size_t sctp_length = std::min(ip_end, end) - offset;
+      decoded.sctp_checksum_valid =
+          ip_end <= end && ip_end >= offset + 12 &&
+          crc::verify_sctp_checksum(sctp, sctp_length);
+      offset += 12; // SCTP common header size
     }
   }
 
   // Extract payload
   decoded.payload_offset = offset;
-  if (offset < data.size()) {
-    decoded.payload.assign(data.begin() + offset, data.end());
+  if (offset < end) {
+    decoded.payload.assign(data.begin() + offset, data.begin() + end);
   }
 
   return decoded;
@@ -575,10 +724,8 @@ inline void print_decoded_packet(const DecodedPacket &decoded) {
 
   if (decoded.has_ethernet) {
     std::cout << "┌─ Ethernet Header:" << std::endl;
-    std::cout << "│  Dst MAC: " << std::hex << decoded.ethernet.dst_mac()
-              << std::dec << std::endl;
-    std::cout << "│  Src MAC: " << std::hex << decoded.ethernet.src_mac()
-              << std::dec << std::endl;
+    std::cout << "│  Dst MAC: " << decoded.dst_mac() << std::endl;
+    std::cout << "│  Src MAC: " << decoded.src_mac() << std::endl;
     std::cout << "│  Type: 0x" << std::hex
               << static_cast<uint16_t>(decoded.ethernet.ethertype())
               << std::dec;
@@ -586,6 +733,10 @@ inline void print_decoded_packet(const DecodedPacket &decoded) {
       std::cout << " (IPv4)";
     }
     std::cout << std::endl;
+    if (decoded.has_fcs) {
+      std::cout << "│  FCS: " << (decoded.fcs_valid ? "valid" : "INVALID")
+                << std::endl;
+    }
   }
 
   if (decoded.has_ipv4) {
@@ -605,8 +756,8 @@ inline void print_decoded_packet(const DecodedPacket &decoded) {
     else if (decoded.ipv4.protocol() == 6)
       std::cout << " (TCP)";
     std::cout << std::endl;
-    std::cout << "│  Src IP: " << decoded.get_src_ip() << std::endl;
-    std::cout << "│  Dst IP: " << decoded.get_dst_ip() << std::endl;
+    std::cout << "│  Src IP: " << decoded.src_address() << std::endl;
+    std::cout << "│  Dst IP: " << decoded.dst_address() << std::endl;
     std::cout << "│  Checksum: 0x" << std::hex << decoded.ipv4.header_checksum()
               << std::dec << std::endl;
   }
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "address_prefix.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// A read prefetch hint where the compiler has one, nothing elsewhere
+#if defined(__GNUC__) || defined(__clang__)
+#define CPPSCAPY_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define CPPSCAPY_PREFETCH(address) ((void)(address))
+#endif
+
+namespace cppscapy {
+
+// Longest-prefix-match tables mapping prefixes to 32-bit values (a route,
+// customer or ASN id).
+//
+// Both are multibit tries with leaf pushing: the root is a directly indexed
+// array over the top FirstStride bits of the key, and every deeper level is
+// a 256-entry group indexed by the next 8 bits. A prefix is expanded over all
+// the slots it covers at its level, so a lookup is one load per level and no
+// backtracking:
+//   IPv4RouteTable: DIR-24-8 (2^24 root entries, then one level of groups)
+//   IPv6RouteTable: 2^16 root entries, then up to 14 levels of groups
+// Groups come from a pool with a fixed maximum, so the lookup structure
+// is bounded by the root plus max_groups * 1 KiB; insert() reports false
+// when it runs out. Groups whose slots all become equal again after erase()
+// are recycled. The prefixes themselves (kept per length for erase()) and
+// the distinct values add memory in proportion to the routes stored, which
+// memory_usage() includes.
+
+namespace detail {
+    template <typename Key, unsigned KeyBits, unsigned FirstStride>
+    class MultibitTrie {
+    public:
+        static constexpr uint32_t NO_ROUTE = 0xFFFFFFFF;
+
+        explicit MultibitTrie(size_t max_groups);
+
+        bool insert(Key key, unsigned length, uint32_t value);
+        bool erase(Key key, unsigned length);
+        size_t size() const { return prefix_count_; }
+        size_t group_count() const { return group_count_; }
+        size_t memory_usage() const;
+
+        uint32_t lookup(Key key, uint32_t miss) const {
+            uint32_t entry = root_[static_cast<size_t>(key >> (KeyBits - FirstStride))];
+            unsigned shift = KeyBits - FirstStride;
+            while (entry & EXTENDED) {
+                shift -= 8;
+                entry = groups_[slot(entry & INDEX_MASK, static_cast<unsigned>(key >> shift) & 0xFF)];
+            }
+            return entry ? values_[entry & INDEX_MASK] : miss;
+        }
+
+        // Looks up key_at(0) .. key_at(count - 1), prefetching the root slot
+        // PREFETCH_DISTANCE keys ahead so the cache and TLB misses of
+        // consecutive lookups overlap
+        template <typename KeyAt>
+        void lookup_batch(KeyAt key_at, size_t count, uint32_t* values, uint32_t miss) const {
+            constexpr unsigned ROOT_SHIFT = KeyBits - FirstStride;
+            for (size_t i = 0; i < count && i < PREFETCH_DISTANCE; ++i) {
+                CPPSCAPY_PREFETCH(&root_[static_cast<size_t>(key_at(i) >> ROOT_SHIFT)]);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                if (i + PREFETCH_DISTANCE < count) {
+                    CPPSCAPY_PREFETCH(&root_[static_cast<size_t>(key_at(i + PREFETCH_DISTANCE) >> ROOT_SHIFT)]);
+                }
+                values[i] = lookup(key_at(i), miss);
+            }
+        }
+
+    private:
+        // Slot layout: bit 31 = points to a group, bits 23-30 = prefix length
+        // + 1 (0 = no route), bits 0-22 = group or value index
+        static constexpr uint32_t EXTENDED = 0x80000000;
+        static constexpr unsigned DEPTH_SHIFT = 23;
+        static constexpr uint32_t INDEX_MASK = (1u << DEPTH_SHIFT) - 1;
+        static constexpr size_t GROUP_SIZE = 256;
+        static constexpr size_t PREFETCH_DISTANCE = 16;
+
+        static constexpr size_t slot(uint32_t group, unsigned index) { return group * GROUP_SIZE + index; }
+        static constexpr unsigned depth(uint32_t entry) { return (entry >> DEPTH_SHIFT) & 0xFF; }
+        static Key mask(unsigned length) { return length ? ~Key(0) << (KeyBits - length) : Key(0); }
+
+        struct KeyHash {
+            size_t operator()(Key key) const {
+                uint64_t folded = static_cast<uint64_t>(key);
+                if (KeyBits > 64) {
+                    folded ^= static_cast<uint64_t>(key >> (KeyBits > 64 ? 64 : 0)) * 0xC2B2AE3D27D4EB4Full;
+                }
+                return static_cast<size_t>((folded * 0x9E3779B97F4A7C15ull) >> 16);
+            }
+        };
+
+        uint32_t make_entry(unsigned length, uint32_t value);
+        uint32_t* slot_at(uint32_t parent_group, size_t index);
+        bool allocate_group(uint32_t fill, uint32_t& group);
+        void overwrite(uint32_t* entry, uint32_t replacement, unsigned length);
+        void restore(uint32_t* entry, uint32_t replacement, unsigned length, unsigned level_end);
+        bool fold(uint32_t* entry, unsigned level_end);
+
+        std::vector<uint32_t> root_;
+        std::vector<uint32_t> groups_;
+        std::vector<uint32_t> free_groups_;
+        size_t max_groups_;
+        size_t group_count_ = 0;
+
+        std::vector<uint32_t> values_;  // interned route values
+        std::unordered_map<uint32_t, uint32_t> value_index_;
+        std::vector<std::unordered_map<Key, uint32_t, KeyHash>> rules_;  // per length
+        size_t prefix_count_ = 0;
+    };
+}
+
+// IPv4 DIR-24-8 table. The root array alone takes 64 MiB.
+class IPv4RouteTable {
+public:
+    static constexpr uint32_t NO_ROUTE = 0xFFFFFFFF;
+    static constexpr size_t DEFAULT_MAX_GROUPS = 1 << 14;
+
+    explicit IPv4RouteTable(size_t max_groups = DEFAULT_MAX_GROUPS) : trie_(max_groups) {}
+
+    // Adds or replaces a route; false if the group pool is exhausted
+    bool insert(const IPv4Prefix& prefix, uint32_t value) {
+        return trie_.insert(detail::host_order(prefix.network()), prefix.length(), value);
+    }
+    // Removes a route; false if it was not present
+    bool erase(const IPv4Prefix& prefix) {
+        return trie_.erase(detail::host_order(prefix.network()), prefix.length());
+    }
+
+    uint32_t lookup(const IPv4Address& address, uint32_t miss = NO_ROUTE) const {
+        return trie_.lookup(detail::host_order(address), miss);
+    }
+    void lookup(const IPv4Address* addresses, size_t count, uint32_t* values, uint32_t miss = NO_ROUTE) const {
+        trie_.lookup_batch([addresses](size_t i) { return detail::host_order(addresses[i]); }, count, values, miss);
+    }
+
+    // Batch lookup of the address `key(packet)` of each packet, e.g. tagging
+    // utils::PacketInfo by destination:
+    //   table.lookup_each(infos.data(), infos.size(), tags.data(),
+    //                     [](const utils::PacketInfo& p) { return p.dst_ipv4; });
+    template <typename Packet, typename KeyOf>
+    void lookup_each(const Packet* packets, size_t count, uint32_t* values, KeyOf key,
+                     uint32_t miss = NO_ROUTE) const {
+        trie_.lookup_batch([packets, &key](size_t i) { return detail::host_order(key(packets[i])); },
+                           count, values, miss);
+    }
+
+    size_t size() const { return trie_.size(); }
+    size_t group_count() const { return trie_.group_count(); }
+    size_t memory_usage() const { return trie_.memory_usage(); }
+
+private:
+    detail::MultibitTrie<uint32_t, 32, 24> trie_;
+};
+
+// IPv6 multibit trie (16-bit root, then 8-bit strides)
+class IPv6RouteTable {
+public:
+    static constexpr uint32_t NO_ROUTE = 0xFFFFFFFF;
+    static constexpr size_t DEFAULT_MAX_GROUPS = 1 << 16;
+
+    explicit IPv6RouteTable(size_t max_groups = DEFAULT_MAX_GROUPS) : trie_(max_groups) {}
+
+    // Adds or replaces a route; false if the group pool is exhausted
+    bool insert(const IPv6Prefix& prefix, uint32_t value) {
+        return trie_.insert(detail::host_order(prefix.network()), prefix.length(), value);
+    }
+    // Removes a route; false if it was not present
+    bool erase(const IPv6Prefix& prefix) {
+        return trie_.erase(detail::host_order(prefix.network()), prefix.length());
+    }
+
+    uint32_t lookup(const IPv6Address& address, uint32_t miss = NO_ROUTE) const {
+        return trie_.lookup(detail::host_order(address), miss);
+    }
+    void lookup(const IPv6Address* addresses, size_t count, uint32_t* values, uint32_t miss = NO_ROUTE) const {
+        trie_.lookup_batch([addresses](size_t i) { return detail::host_order(addresses[i]); }, count, values, miss);
+    }
+
+    // Batch lookup of the address `key(packet)` of each packet
+    template <typename Packet, typename KeyOf>
+    void lookup_each(const Packet* packets, size_t count, uint32_t* values, KeyOf key,
+                     uint32_t miss = NO_ROUTE) const {
+        trie_.lookup_batch([packets, &key](size_t i) { return detail::host_order(key(packets[i])); },
+                           count, values, miss);
+    }
+
+    size_t size() const { return trie_.size(); }
+    size_t group_count() const { return trie_.group_count(); }
+    size_t memory_usage() const { return trie_.memory_usage(); }
+
+private:
+    detail::MultibitTrie<detail::uint128, 128, 16> trie_;
+};
+
+} // namespace cppscapy
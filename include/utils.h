@@ -117,16 +117,16 @@ constexpr inline std::array<uint8_t, 16> ipv6_from_hex_string(std::string_view h
     return from_hex_string_array<16>(hex_str);
 }
 
-// Convenience functions using automatic length deduction
-// Note: These create the arrays at compile time, but the address constructors are not constexpr
+// Convenience functions using automatic length deduction from raw hex
+// (for the usual text forms see the _mac/_ipv4/_ipv6 literals)
 template<size_t N>
-auto make_mac_address(const char (&hex_str)[N]) {
+constexpr auto make_mac_address(const char (&hex_str)[N]) {
     static_assert(N == 13, "MAC address hex string must be exactly 12 characters plus null terminator");
     return cppscapy::MacAddress(from_hex_string_auto(hex_str));
 }
 
 template<size_t N>
-auto make_ipv4_address(const char (&hex_str)[N]) {
+constexpr auto make_ipv4_address(const char (&hex_str)[N]) {
     static_assert(N == 9, "IPv4 address hex string must be exactly 8 characters plus null terminator");
     auto bytes = from_hex_string_auto(hex_str);
     return cppscapy::IPv4Address(bytes[0], bytes[1], bytes[2], bytes[3]);
@@ -149,6 +149,23 @@ bool verify_ipv4_checksum(const uint8_t* data, size_t length);
 // Verify IPv4 header checksum - vector version
 bool verify_ipv4_checksum(const std::vector<uint8_t>& header);
 
+// A captured frame with the offsets of its IP (IPv4 or IPv6) and transport
+// headers, for batch verification. An l4_offset of 0 skips the transport check.
+struct PacketRef {
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    size_t l3_offset = 0;
+    size_t l4_offset = 0;
+};
+
+// Verify the IPv4 header checksum and the UDP/TCP/ICMP/ICMPv6 checksum of
+// many packets at once. Fixed 20-byte IPv4 headers are checked 8-16 at a time
+// with SIMD. Returns a failure bitmask: bit (i % 64) of word (i / 64) is set
+// when packet i has a bad checksum or is truncated. Transport checksums of
+// IPv4 fragments and of unknown protocols are not checked.
+std::vector<uint64_t> verify_checksums(const PacketRef* packets, size_t count);
+std::vector<uint64_t> verify_checksums(const std::vector<PacketRef>& packets);
+
 // Packet analysis utilities
 struct PacketInfo {
     bool has_ethernet = false;
@@ -196,13 +213,13 @@ namespace ports {
 
 // Common IP addresses
 namespace common_ips {
-    inline IPv4Address google_dns1() { return IPv4Address("8.8.8.8"); }
-    inline IPv4Address google_dns2() { return IPv4Address("8.8.4.4"); }
-    inline IPv4Address cloudflare_dns1() { return IPv4Address("1.1.1.1"); }
-    inline IPv4Address cloudflare_dns2() { return IPv4Address("1.0.0.1"); }
-    inline IPv4Address private_192() { return IPv4Address("192.168.1.1"); }
-    inline IPv4Address private_10() { return IPv4Address("10.0.0.1"); }
-    inline IPv4Address private_172() { return IPv4Address("172.16.0.1"); }
+    constexpr IPv4Address google_dns1() { return "8.8.8.8"_ipv4; }
+    constexpr IPv4Address google_dns2() { return "8.8.4.4"_ipv4; }
+    constexpr IPv4Address cloudflare_dns1() { return "1.1.1.1"_ipv4; }
+    constexpr IPv4Address cloudflare_dns2() { return "1.0.0.1"_ipv4; }
+    constexpr IPv4Address private_192() { return "192.168.1.1"_ipv4; }
+    constexpr IPv4Address private_10() { return "10.0.0.1"_ipv4; }
+    constexpr IPv4Address private_172() { return "172.16.0.1"_ipv4; }
 }
 
 // Payload generators for testing
@@ -462,9 +462,15 @@ class CPPCodeGenerator:
                 "#include <bitset>",
                 "#include <string>",
                 "#include <type_traits>",
-                "",
             ]
         )
+        if any(
+            "crc32c" in field.attributes
+            for header in self.parser.headers.values()
+            for field in header.fields
+        ):
+            self.output.append('#include "crc.h"')
+        self.output.append("")
 
     def _generate_namespace_open(self):
         """Generate namespace opening"""
@@ -617,14 +623,51 @@ class CPPCodeGenerator:
                 if field.name == "length":
                     self.output.append(f"        // Update {field.name} field")
                     self.output.append(f"        // TODO: Implement length calculation")
+                elif "crc32c" in field.attributes:
+                    # The CRC covers what follows the header too, so it can
+                    # only be filled in by update_{name}(payload) below
+                    self.output.append(f"        // {field.name} also covers the payload, which this header does not")
+                    self.output.append(f"        // hold; it is left as is, callers use update_{field.name}(payload)")
                 elif field.name == "checksum":
                     self.output.append(f"        // Update {field.name} field")
                     self.output.append(
                         f"        // TODO: Implement checksum calculation"
                     )
 
+        self.output.append("    }")
+        for field in header.fields:
+            if "crc32c" in field.attributes:
+                self._generate_crc32c_methods(name, field)
+
+        self.output.extend(
+            ["    ", "private:", "    std::vector<uint8_t> data_;", "};", ""]
+        )
+
+    def _generate_crc32c_methods(self, header_name: str, field: Field):
+        """Generate update/verify for a CRC32c field (SCTP, RFC 9260)
+        covering the header, with the field zeroed, and the payload"""
+        if field.bit_width != 32:
+            raise ValueError(
+                f"{header_name}.{field.name}: crc32c needs a 32-bit field"
+            )
         self.output.extend(
-            ["    }", "    ", "private:", "    std::vector<uint8_t> data_;", "};", ""]
+            [
+                "    ",
+                "    // CRC32c over this header and the payload that follows it",
+                f"    void update_{field.name}(const std::vector<uint8_t>& payload) {{",
+                f"        set_{field.name}(0);",
+                "        uint32_t crc = crc::crc32c(data_);",
+                "        crc = crc::crc32c(payload, crc);",
+                f"        set_{field.name}(crc::sctp_field_value(crc));",
+                "    }",
+                "    ",
+                "    // Whether the stored value matches this header and the payload",
+                f"    bool verify_{field.name}(const std::vector<uint8_t>& payload) const {{",
+                f"        {header_name} copy = *this;",
+                f"        copy.update_{field.name}(payload);",
+                f"        return copy.{field.name}() == {field.name}();",
+                "    }",
+            ]
         )
 
     def _generate_field_accessors(self, field: Field, bit_offset: int):
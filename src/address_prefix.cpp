@@ -0,0 +1,125 @@
+#include "../include/address_prefix.h"
+#include <ostream>
+#include <stdexcept>
+
+namespace cppscapy {
+
+namespace {
+    // Parses "<address>/<length>" with the address from_chars overloads
+    template <typename Prefix, typename Address>
+    std::from_chars_result parse_prefix(const char* first, const char* last, Prefix& value) {
+        Address address;
+        auto result = from_chars(first, last, address);
+        if (result.ec != std::errc()) {
+            return result;
+        }
+        const char* p = result.ptr;
+        if (p == last || *p != '/' || p + 1 == last) {
+            return {first, std::errc::invalid_argument};
+        }
+        bool leading_zero = p[1] == '0' && p + 2 != last && p[2] >= '0' && p[2] <= '9';
+        if (leading_zero) {
+            return {first, std::errc::invalid_argument};
+        }
+        unsigned length = 0;
+        auto digits = std::from_chars(p + 1, last, length);
+        if (digits.ec == std::errc::invalid_argument) {
+            return {first, std::errc::invalid_argument};
+        }
+        if (digits.ec != std::errc() || length > Prefix::MAX_LENGTH) {
+            return {first, std::errc::result_out_of_range};
+        }
+        value = Prefix(address, static_cast<uint8_t>(length));
+        return {digits.ptr, std::errc()};
+    }
+
+    template <typename Prefix>
+    std::errc parse_whole(std::string_view text, Prefix& value) {
+        Prefix parsed;
+        auto result = from_chars(text.data(), text.data() + text.size(), parsed);
+        if (result.ec == std::errc() && result.ptr != text.data() + text.size()) {
+            return std::errc::invalid_argument;
+        }
+        if (result.ec == std::errc()) {
+            value = parsed;
+        }
+        return result.ec;
+    }
+
+    template <typename Prefix>
+    std::to_chars_result format_prefix(char* first, char* last, const Prefix& value) {
+        auto result = to_chars(first, last, value.network());
+        if (result.ec != std::errc() || result.ptr == last) {
+            return {last, std::errc::value_too_large};
+        }
+        *result.ptr = '/';
+        return std::to_chars(result.ptr + 1, last, static_cast<unsigned>(value.length()));
+    }
+
+    template <size_t Size, typename Prefix>
+    std::string text_of(const Prefix& value) {
+        char buffer[Size];
+        auto result = to_chars(buffer, buffer + Size, value);
+        return std::string(buffer, result.ptr);
+    }
+}
+
+std::from_chars_result from_chars(const char* first, const char* last, IPv4Prefix& value) noexcept {
+    return parse_prefix<IPv4Prefix, IPv4Address>(first, last, value);
+}
+
+std::from_chars_result from_chars(const char* first, const char* last, IPv6Prefix& value) noexcept {
+    return parse_prefix<IPv6Prefix, IPv6Address>(first, last, value);
+}
+
+std::to_chars_result to_chars(char* first, char* last, const IPv4Prefix& value) noexcept {
+    return format_prefix(first, last, value);
+}
+
+std::to_chars_result to_chars(char* first, char* last, const IPv6Prefix& value) noexcept {
+    return format_prefix(first, last, value);
+}
+
+std::ostream& operator<<(std::ostream& os, const IPv4Prefix& value) {
+    char buffer[IPV4_PREFIX_TEXT_SIZE];
+    auto result = to_chars(buffer, buffer + sizeof(buffer), value);
+    return os.write(buffer, result.ptr - buffer);
+}
+
+std::ostream& operator<<(std::ostream& os, const IPv6Prefix& value) {
+    char buffer[IPV6_PREFIX_TEXT_SIZE];
+    auto result = to_chars(buffer, buffer + sizeof(buffer), value);
+    return os.write(buffer, result.ptr - buffer);
+}
+
+// IPv4Prefix implementation
+IPv4Prefix::IPv4Prefix(const std::string& text) {
+    if (parse(text, *this) != std::errc()) {
+        throw std::invalid_argument("Invalid IPv4 prefix format");
+    }
+}
+
+std::string IPv4Prefix::to_string() const {
+    return text_of<IPV4_PREFIX_TEXT_SIZE>(*this);
+}
+
+std::errc IPv4Prefix::parse(std::string_view text, IPv4Prefix& value) noexcept {
+    return parse_whole(text, value);
+}
+
+// IPv6Prefix implementation
+IPv6Prefix::IPv6Prefix(const std::string& text) {
+    if (parse(text, *this) != std::errc()) {
+        throw std::invalid_argument("Invalid IPv6 prefix format");
+    }
+}
+
+std::string IPv6Prefix::to_string() const {
+    return text_of<IPV6_PREFIX_TEXT_SIZE>(*this);
+}
+
+std::errc IPv6Prefix::parse(std::string_view text, IPv6Prefix& value) noexcept {
+    return parse_whole(text, value);
+}
+
+} // namespace cppscapy
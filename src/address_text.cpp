@@ -0,0 +1,438 @@
+#include "../include/network_headers.h"
+#include <cstring>
+#include <ostream>
+
+namespace cppscapy {
+
+namespace {
+    // The scanners below load 8 bytes at a time. Input with fewer than
+    // SCRATCH_SIZE readable bytes is first copied into a zero-padded buffer,
+    // so no load runs past the caller's data. No address form reaches
+    // SCRATCH_SIZE - LOOKAHEAD characters (the longest IPv6 text is 45).
+    constexpr size_t LOOKAHEAD = 8;
+    constexpr size_t SCRATCH_SIZE = 64;
+
+    constexpr uint64_t ONES = 0x0101010101010101;
+    constexpr uint64_t HIGH_BITS = 0x8080808080808080;
+
+    // 8 bytes with the first character in the lowest byte
+    inline uint64_t load64(const char* p) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = detail::bswap64(word);
+#endif
+        return word;
+    }
+
+    // Bit 7 of each byte is set for bytes that are not ASCII decimal digits.
+    // Bytes are masked to 7 bits first so the additions never carry across
+    // byte boundaries; non-ASCII bytes are rejected through ~word.
+    inline uint64_t non_digit_mask(uint64_t word) {
+        uint64_t x = word & ~HIGH_BITS;
+        uint64_t digit = (x + 0x50 * ONES) & ~(x + 0x46 * ONES);  // '0' <= x <= '9'
+        return ~(digit & ~word) & HIGH_BITS;
+    }
+
+    inline uint64_t non_hex_mask(uint64_t word) {
+        uint64_t x = word & ~HIGH_BITS;
+        uint64_t digit = (x + 0x50 * ONES) & ~(x + 0x46 * ONES);  // '0' <= x <= '9'
+        uint64_t lower = x | 0x20 * ONES;                          // fold 'A'-'F' to 'a'-'f'
+        uint64_t letter = (lower + 0x1F * ONES) & ~(lower + 0x19 * ONES);
+        return ~((digit | letter) & ~word) & HIGH_BITS;
+    }
+
+    // Length of the leading run described by a mask (8 if it fills the word)
+    inline size_t run_length(uint64_t mask) {
+        return mask ? static_cast<size_t>(detail::ctz64(mask)) / 8 : 8;
+    }
+
+    // Value of 1-3 leading decimal digits
+    inline uint32_t decimal_value(uint64_t word, size_t length) {
+        // Right-align the digits so the last one sits in byte 3
+        uint32_t d = static_cast<uint32_t>(word & 0x0F0F0F0F) << (8 * (4 - length));
+        return ((d >> 8) & 0xFF) * 100 + ((d >> 16) & 0xFF) * 10 + (d >> 24);
+    }
+
+    // Value of 1-4 leading hex digits
+    inline uint32_t hex_value(uint64_t word, size_t length) {
+        uint32_t nibbles = static_cast<uint32_t>((word & 0x0F0F0F0F) + 9 * ((word >> 6) & 0x01010101));
+        nibbles <<= 8 * (4 - length);
+        // Bytes 0 and 2 now hold the high and low digit pairs
+        uint32_t pairs = (nibbles << 4) + (nibbles >> 8);
+        return ((pairs & 0xFF) << 8) | ((pairs >> 16) & 0xFF);
+    }
+
+    // Each parser returns the end of the address, or nullptr with `ec` set
+    const char* parse_mac(const char* p, std::array<uint8_t, 6>& bytes, std::errc& ec) {
+        char separator = 0;
+        for (size_t i = 0; i < 6; ++i) {
+            uint64_t word = load64(p);
+            size_t length = run_length(non_hex_mask(word));
+            if (length == 0 || length > 2) {
+                ec = std::errc::invalid_argument;
+                return nullptr;
+            }
+            bytes[i] = static_cast<uint8_t>(hex_value(word, length));
+            p += length;
+            if (i < 5) {
+                if ((*p != ':' && *p != '-') || (separator && *p != separator)) {
+                    ec = std::errc::invalid_argument;
+                    return nullptr;
+                }
+                separator = *p++;
+            }
+        }
+        return p;
+    }
+
+    // Bit i is set when byte i of the 16 bytes at p is not a decimal digit
+    inline uint32_t non_digit_bitmap(const char* p) {
+        // Moves bit 7 of byte i to bit 56 + i (a portable movemask)
+        constexpr uint64_t GATHER = 0x0102040810204080;
+        uint64_t lo = (non_digit_mask(load64(p)) >> 7) * GATHER >> 56;
+        uint64_t hi = (non_digit_mask(load64(p + 8)) >> 7) * GATHER >> 56;
+        return static_cast<uint32_t>(lo | (hi << 8));
+    }
+
+    // All four octets are located at once from the separator bitmap, so the
+    // unpredictable octet lengths cost no branches
+    const char* parse_ipv4(const char* p, uint32_t& host_order, std::errc& ec) {
+        uint32_t separators = non_digit_bitmap(p) | 0xF0000;  // sentinels
+        size_t end[4];
+        for (size_t i = 0; i < 4; ++i) {
+            end[i] = static_cast<size_t>(detail::ctz32(separators));
+            separators &= separators - 1;
+        }
+
+        // inet_pton rules: 1-3 digits, no leading zeros, '.' between octets
+        size_t start[4] = {0, end[0] + 1, end[1] + 1, end[2] + 1};
+        bool malformed = (p[end[0]] != '.') | (p[end[1]] != '.') | (p[end[2]] != '.');
+        for (size_t i = 0; i < 4; ++i) {
+            size_t length = end[i] - start[i];
+            malformed |= (length - 1 > 2) | ((length > 1) & (p[start[i]] == '0'));
+        }
+        if (malformed) {
+            ec = std::errc::invalid_argument;
+            return nullptr;
+        }
+
+        uint32_t result = 0;
+        uint32_t largest = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            uint32_t octet = decimal_value(load64(p + start[i]), end[i] - start[i]);
+            largest |= octet;
+            result = (result << 8) | (octet & 0xFF);
+        }
+        if (largest > 255) {
+            ec = std::errc::result_out_of_range;
+            return nullptr;
+        }
+        host_order = result;
+        return p + end[3];
+    }
+
+    // RFC 4291 section 2.2: up to 8 groups of 1-4 hex digits, at most one
+    // "::" and optionally a dotted quad in place of the last two groups
+    const char* parse_ipv6(const char* p, std::array<uint8_t, 16>& bytes, std::errc& ec) {
+        uint16_t groups[8] = {};
+        size_t count = 0;
+        int gap = -1;       // group index where "::" was seen
+        bool need_group = false;
+        ec = std::errc::invalid_argument;
+
+        if (p[0] == ':') {
+            if (p[1] != ':') {
+                return nullptr;
+            }
+            gap = 0;
+            p += 2;
+        }
+
+        while (count < 8) {
+            uint64_t word = load64(p);
+            size_t length = run_length(non_hex_mask(word));
+            if (length == 0) {
+                break;
+            }
+            if (p[length] == '.') {
+                uint32_t ipv4 = 0;
+                if (count > 6 || !(p = parse_ipv4(p, ipv4, ec))) {
+                    ec = std::errc::invalid_argument;
+                    return nullptr;
+                }
+                groups[count++] = static_cast<uint16_t>(ipv4 >> 16);
+                groups[count++] = static_cast<uint16_t>(ipv4);
+                need_group = false;
+                break;
+            }
+            if (length > 4) {
+                return nullptr;
+            }
+            groups[count++] = static_cast<uint16_t>(hex_value(word, length));
+            p += length;
+            need_group = false;
+            if (*p != ':') {
+                break;
+            }
+            if (p[1] == ':') {
+                if (gap >= 0) {
+                    return nullptr;
+                }
+                gap = static_cast<int>(count);
+                p += 2;
+            } else {
+                need_group = true;
+                ++p;
+            }
+        }
+
+        // A single ':' must be followed by a group; "::" stands for at least one
+        if (need_group || (gap < 0 && count != 8) || (gap >= 0 && count > 7)) {
+            return nullptr;
+        }
+
+        // Groups after "::" move to the end; the skipped ones stay zero
+        bytes = {};
+        size_t head = gap < 0 ? count : static_cast<size_t>(gap);
+        for (size_t i = 0; i < count; ++i) {
+            size_t out = i < head ? i : i + (8 - count);
+            bytes[2 * out] = static_cast<uint8_t>(groups[i] >> 8);
+            bytes[2 * out + 1] = static_cast<uint8_t>(groups[i]);
+        }
+        ec = std::errc();
+        return p;
+    }
+
+    // Runs a parser with the lookahead guarantee and maps the result back
+    template <typename Parser>
+    std::from_chars_result scan(const char* first, const char* last, Parser parser) {
+        std::errc ec = std::errc();
+        size_t length = static_cast<size_t>(last - first);
+        if (length >= SCRATCH_SIZE) {
+            const char* end = parser(first, ec);
+            return {end ? end : first, end ? std::errc() : ec};
+        }
+        char scratch[SCRATCH_SIZE + LOOKAHEAD] = {};
+        std::memcpy(scratch, first, length);
+        const char* end = parser(scratch, ec);
+        return {end ? first + (end - scratch) : first, end ? std::errc() : ec};
+    }
+
+    // Decimal text of every octet value, padded to 4 bytes so a whole entry
+    // can be copied at once
+    struct OctetText {
+        char digits[3];
+        uint8_t length;
+    };
+
+    constexpr std::array<OctetText, 256> make_octet_text() {
+        std::array<OctetText, 256> table{};
+        for (size_t value = 0; value < 256; ++value) {
+            OctetText& text = table[value];
+            if (value >= 100) {
+                text.digits[0] = static_cast<char>('0' + value / 100);
+                text.digits[1] = static_cast<char>('0' + value / 10 % 10);
+                text.digits[2] = static_cast<char>('0' + value % 10);
+                text.length = 3;
+            } else if (value >= 10) {
+                text.digits[0] = static_cast<char>('0' + value / 10);
+                text.digits[1] = static_cast<char>('0' + value % 10);
+                text.length = 2;
+            } else {
+                text.digits[0] = static_cast<char>('0' + value);
+                text.length = 1;
+            }
+        }
+        return table;
+    }
+
+    constexpr std::array<OctetText, 256> OCTET_TEXT = make_octet_text();
+    constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+    // The formatters write into a FORMAT_SCRATCH_SIZE buffer and may store a
+    // few bytes past the text they return
+    constexpr size_t FORMAT_SCRATCH_SIZE = 64;
+
+    char* format_mac(char* out, const std::array<uint8_t, 6>& bytes) {
+        for (size_t i = 0; i < 6; ++i) {
+            out[0] = HEX_DIGITS[bytes[i] >> 4];
+            out[1] = HEX_DIGITS[bytes[i] & 0x0F];
+            out[2] = ':';
+            out += 3;
+        }
+        return out - 1;
+    }
+
+    // Stores up to 16 bytes
+    char* format_ipv4(char* out, uint32_t host_order) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            const OctetText& octet = OCTET_TEXT[(host_order >> shift) & 0xFF];
+            std::memcpy(out, &octet, sizeof(octet));
+            out[octet.length] = '.';
+            out += octet.length + 1;
+        }
+        return out - 1;
+    }
+
+    // Lowercase hex without leading zeros
+    char* format_group(char* out, uint16_t group) {
+        size_t digits = group ? (35 - static_cast<size_t>(detail::clz32(group))) / 4 : 1;
+        for (size_t i = digits; i-- > 0;) {
+            out[i] = HEX_DIGITS[group & 0x0F];
+            group >>= 4;
+        }
+        return out + digits;
+    }
+
+    // RFC 5952 section 4: the longest run of two or more zero groups (the
+    // first one on a tie) becomes "::"; section 5: IPv4-mapped addresses
+    // end in a dotted quad
+    char* format_ipv6(char* out, const std::array<uint8_t, 16>& bytes) {
+        uint16_t groups[8];
+        for (size_t i = 0; i < 8; ++i) {
+            groups[i] = static_cast<uint16_t>((bytes[2 * i] << 8) | bytes[2 * i + 1]);
+        }
+        bool mapped = (groups[0] | groups[1] | groups[2] | groups[3] | groups[4]) == 0 &&
+                      groups[5] == 0xFFFF;
+        size_t count = mapped ? 6 : 8;
+
+        size_t best = count, best_length = 1;
+        for (size_t i = 0; i < count;) {
+            size_t run = 0;
+            while (i + run < count && groups[i + run] == 0) {
+                ++run;
+            }
+            if (run > best_length) {
+                best = i;
+                best_length = run;
+            }
+            i += run ? run : 1;
+        }
+
+        for (size_t i = 0; i < count;) {
+            if (i == best) {
+                *out++ = ':';
+                *out++ = ':';
+                i += best_length;
+                continue;
+            }
+            if (i > 0 && i != best + best_length) {
+                *out++ = ':';
+            }
+            out = format_group(out, groups[i++]);
+        }
+        if (mapped) {
+            *out++ = ':';
+            out = format_ipv4(out, (static_cast<uint32_t>(groups[6]) << 16) | groups[7]);
+        }
+        return out;
+    }
+
+    // Runs a formatter on scratch space and copies the text out if it fits
+    template <typename Formatter>
+    std::to_chars_result emit(char* first, char* last, Formatter formatter) {
+        char scratch[FORMAT_SCRATCH_SIZE];
+        size_t length = static_cast<size_t>(formatter(scratch) - scratch);
+        if (static_cast<size_t>(last - first) < length) {
+            return {last, std::errc::value_too_large};
+        }
+        std::memcpy(first, scratch, length);
+        return {first + length, std::errc()};
+    }
+
+    // The whole string must be one address
+    template <typename Address>
+    std::errc parse_whole(std::string_view text, Address& value) {
+        Address parsed;
+        auto result = from_chars(text.data(), text.data() + text.size(), parsed);
+        if (result.ec == std::errc() && result.ptr != text.data() + text.size()) {
+            return std::errc::invalid_argument;
+        }
+        if (result.ec == std::errc()) {
+            value = parsed;
+        }
+        return result.ec;
+    }
+}
+
+std::from_chars_result from_chars(const char* first, const char* last, MacAddress& value) noexcept {
+    std::array<uint8_t, 6> bytes{};
+    auto result = scan(first, last, [&bytes](const char* p, std::errc& ec) {
+        return parse_mac(p, bytes, ec);
+    });
+    if (result.ec == std::errc()) {
+        value = MacAddress(bytes);
+    }
+    return result;
+}
+
+std::from_chars_result from_chars(const char* first, const char* last, IPv4Address& value) noexcept {
+    uint32_t host_order = 0;
+    auto result = scan(first, last, [&host_order](const char* p, std::errc& ec) {
+        return parse_ipv4(p, host_order, ec);
+    });
+    if (result.ec == std::errc()) {
+        value = IPv4Address(detail::network_order32(host_order));
+    }
+    return result;
+}
+
+std::from_chars_result from_chars(const char* first, const char* last, IPv6Address& value) noexcept {
+    std::array<uint8_t, 16> bytes{};
+    auto result = scan(first, last, [&bytes](const char* p, std::errc& ec) {
+        return parse_ipv6(p, bytes, ec);
+    });
+    if (result.ec == std::errc()) {
+        value = IPv6Address(bytes);
+    }
+    return result;
+}
+
+std::to_chars_result to_chars(char* first, char* last, const MacAddress& value) noexcept {
+    return emit(first, last, [&value](char* out) { return format_mac(out, value.to_bytes()); });
+}
+
+std::to_chars_result to_chars(char* first, char* last, const IPv4Address& value) noexcept {
+    uint32_t host_order = detail::network_order32(value.to_uint32());
+    return emit(first, last, [host_order](char* out) { return format_ipv4(out, host_order); });
+}
+
+std::to_chars_result to_chars(char* first, char* last, const IPv6Address& value) noexcept {
+    return emit(first, last, [&value](char* out) { return format_ipv6(out, value.to_bytes()); });
+}
+
+namespace {
+    template <typename Address, size_t Size>
+    std::ostream& write_text(std::ostream& os, const Address& value) {
+        char buffer[Size];
+        auto result = to_chars(buffer, buffer + Size, value);
+        return os.write(buffer, result.ptr - buffer);
+    }
+}
+
+std::ostream& operator<<(std::ostream& os, const MacAddress& value) {
+    return write_text<MacAddress, MAC_TEXT_SIZE>(os, value);
+}
+
+std::ostream& operator<<(std::ostream& os, const IPv4Address& value) {
+    return write_text<IPv4Address, IPV4_TEXT_SIZE>(os, value);
+}
+
+std::ostream& operator<<(std::ostream& os, const IPv6Address& value) {
+    return write_text<IPv6Address, IPV6_TEXT_SIZE>(os, value);
+}
+
+std::errc MacAddress::parse(std::string_view text, MacAddress& value) noexcept {
+    return parse_whole(text, value);
+}
+
+std::errc IPv4Address::parse(std::string_view text, IPv4Address& value) noexcept {
+    return parse_whole(text, value);
+}
+
+std::errc IPv6Address::parse(std::string_view text, IPv6Address& value) noexcept {
+    return parse_whole(text, value);
+}
+
+} // namespace cppscapy
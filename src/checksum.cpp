@@ -0,0 +1,818 @@
+#include "../include/checksum.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CPPSCAPY_CHECKSUM_X86 1
+#include <immintrin.h>
+#endif
+
+namespace cppscapy {
+namespace checksum {
+
+namespace {
+    // All kernels sum the buffer as native-order 32-bit words into 64-bit
+    // accumulators. One's complement addition is byte-order independent, so
+    // the folded result only needs a final byte swap on little-endian hosts.
+    using KernelFn = uint64_t (*)(const uint8_t*, size_t);
+
+    // Fused copy + sum kernels return the same native sum as the plain ones
+    // while writing every byte they read to `dst`
+    using CopyKernelFn = uint64_t (*)(uint8_t*, const uint8_t*, size_t);
+
+    // Batch kernels for fixed 20-byte IPv4 headers write one network-order
+    // partial sum per header
+    using HeaderKernelFn = void (*)(const uint8_t* const*, size_t, uint16_t*);
+    constexpr size_t IPV4_HEADER_SIZE = 20;
+
+    inline uint32_t load32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    // 64-bit addition with end-around carry
+    inline uint64_t add64(uint64_t a, uint64_t b) {
+        uint64_t sum = a + b;
+        return sum + (sum < a);
+    }
+
+    // Convert a folded native-order sum into big-endian word semantics
+    inline uint16_t to_network_sum(uint16_t native) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return native;
+#else
+        return static_cast<uint16_t>((native >> 8) | (native << 8));
+#endif
+    }
+
+    uint64_t sum_scalar(const uint8_t* data, size_t length) {
+        uint64_t acc0 = 0;
+        uint64_t acc1 = 0;
+        size_t i = 0;
+
+        for (; i + 16 <= length; i += 16) {
+            acc0 += load32(data + i);
+            acc1 += load32(data + i + 4);
+            acc0 += load32(data + i + 8);
+            acc1 += load32(data + i + 12);
+        }
+        for (; i + 4 <= length; i += 4) {
+            acc0 += load32(data + i);
+        }
+
+        // Trailing 1-3 bytes, zero padded in memory order
+        if (i < length) {
+            uint8_t tail[4] = {0, 0, 0, 0};
+            std::memcpy(tail, data + i, length - i);
+            acc1 += load32(tail);
+        }
+
+        return add64(acc0, acc1);
+    }
+
+    uint64_t copy_sum_scalar(uint8_t* dst, const uint8_t* src, size_t length) {
+        uint64_t acc0 = 0;
+        uint64_t acc1 = 0;
+        size_t i = 0;
+
+        for (; i + 16 <= length; i += 16) {
+            uint32_t w0 = load32(src + i);
+            uint32_t w1 = load32(src + i + 4);
+            uint32_t w2 = load32(src + i + 8);
+            uint32_t w3 = load32(src + i + 12);
+            std::memcpy(dst + i, &w0, 4);
+            std::memcpy(dst + i + 4, &w1, 4);
+            std::memcpy(dst + i + 8, &w2, 4);
+            std::memcpy(dst + i + 12, &w3, 4);
+            acc0 += w0;
+            acc1 += w1;
+            acc0 += w2;
+            acc1 += w3;
+        }
+
+        // Remaining 0-15 bytes are already in cache once copied
+        std::memcpy(dst + i, src + i, length - i);
+        return add64(add64(acc0, acc1), sum_scalar(dst + i, length - i));
+    }
+
+    void headers_scalar(const uint8_t* const* headers, size_t count, uint16_t* sums) {
+        for (size_t i = 0; i < count; ++i) {
+            sums[i] = to_network_sum(fold(sum_scalar(headers[i], IPV4_HEADER_SIZE)));
+        }
+    }
+
+#ifdef CPPSCAPY_CHECKSUM_X86
+    __attribute__((target("sse2")))
+    uint64_t sum_sse2(const uint8_t* data, size_t length) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc0 = zero;
+        __m128i acc1 = zero;
+        size_t i = 0;
+
+        for (; i + 32 <= length; i += 32) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16));
+            acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(a, zero));
+            acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(a, zero));
+            acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(b, zero));
+            acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(b, zero));
+        }
+
+        uint64_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + 2), acc1);
+
+        uint64_t sum = sum_scalar(data + i, length - i);
+        for (uint64_t lane : lanes) {
+            sum = add64(sum, lane);
+        }
+        return sum;
+    }
+
+    __attribute__((target("sse2")))
+    uint64_t copy_sum_sse2(uint8_t* dst, const uint8_t* src, size_t length) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc0 = zero;
+        __m128i acc1 = zero;
+        size_t i = 0;
+
+        for (; i + 32 <= length; i += 32) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), a);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 16), b);
+            acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(a, zero));
+            acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(a, zero));
+            acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(b, zero));
+            acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(b, zero));
+        }
+
+        uint64_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + 2), acc1);
+
+        uint64_t sum = copy_sum_scalar(dst + i, src + i, length - i);
+        for (uint64_t lane : lanes) {
+            sum = add64(sum, lane);
+        }
+        return sum;
+    }
+
+    // The header kernels transpose N headers so that each vector holds the
+    // same 32-bit word of every header (lane k = header k). Adding the 16-bit
+    // halves of ten words per lane cannot overflow 32 bits, and two lane-wise
+    // folds leave each header's sum in its own lane.
+    __attribute__((target("sse2")))
+    void headers_sse2(const uint8_t* const* headers, size_t count, uint16_t* sums) {
+        const __m128i low_mask = _mm_set1_epi32(0xFFFF);
+        size_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            const uint8_t* const* h = headers + i;
+            __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h[0]));
+            __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h[1]));
+            __m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h[2]));
+            __m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h[3]));
+
+            __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+            __m128i t1 = _mm_unpackhi_epi32(r0, r1);
+            __m128i t2 = _mm_unpacklo_epi32(r2, r3);
+            __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+            __m128i words[5] = {
+                _mm_unpacklo_epi64(t0, t2),
+                _mm_unpackhi_epi64(t0, t2),
+                _mm_unpacklo_epi64(t1, t3),
+                _mm_unpackhi_epi64(t1, t3),
+                _mm_setr_epi32(static_cast<int>(load32(h[0] + 16)), static_cast<int>(load32(h[1] + 16)),
+                               static_cast<int>(load32(h[2] + 16)), static_cast<int>(load32(h[3] + 16)))
+            };
+
+            __m128i acc = _mm_setzero_si128();
+            for (const __m128i& w : words) {
+                acc = _mm_add_epi32(acc, _mm_and_si128(w, low_mask));
+                acc = _mm_add_epi32(acc, _mm_srli_epi32(w, 16));
+            }
+            acc = _mm_add_epi32(_mm_and_si128(acc, low_mask), _mm_srli_epi32(acc, 16));
+            acc = _mm_add_epi32(_mm_and_si128(acc, low_mask), _mm_srli_epi32(acc, 16));
+
+            uint32_t lanes[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+            for (size_t k = 0; k < 4; ++k) {
+                sums[i + k] = to_network_sum(static_cast<uint16_t>(lanes[k]));
+            }
+        }
+
+        headers_scalar(headers + i, count - i, sums + i);
+    }
+
+    __attribute__((target("avx2")))
+    uint64_t sum_avx2(const uint8_t* data, size_t length) {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i acc0 = zero;
+        __m256i acc1 = zero;
+        size_t i = 0;
+
+        for (; i + 64 <= length; i += 64) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+            acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(a, zero));
+            acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(a, zero));
+            acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(b, zero));
+            acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(b, zero));
+        }
+
+        uint64_t lanes[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes + 4), acc1);
+
+        uint64_t sum = sum_scalar(data + i, length - i);
+        for (uint64_t lane : lanes) {
+            sum = add64(sum, lane);
+        }
+        return sum;
+    }
+
+    __attribute__((target("avx2")))
+    uint64_t copy_sum_avx2(uint8_t* dst, const uint8_t* src, size_t length) {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i acc0 = zero;
+        __m256i acc1 = zero;
+        size_t i = 0;
+
+        for (; i + 64 <= length; i += 64) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), a);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), b);
+            acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(a, zero));
+            acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(a, zero));
+            acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(b, zero));
+            acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(b, zero));
+        }
+
+        uint64_t lanes[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes + 4), acc1);
+
+        uint64_t sum = copy_sum_scalar(dst + i, src + i, length - i);
+        for (uint64_t lane : lanes) {
+            sum = add64(sum, lane);
+        }
+        return sum;
+    }
+
+    __attribute__((target("avx2")))
+    void headers_avx2(const uint8_t* const* headers, size_t count, uint16_t* sums) {
+        const __m256i low_mask = _mm256_set1_epi32(0xFFFF);
+        size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            const uint8_t* const* h = headers + i;
+            // Row j holds headers j and j + 4 in its two 128-bit lanes
+            __m256i rows[4];
+            for (size_t j = 0; j < 4; ++j) {
+                __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h[j]));
+                __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h[j + 4]));
+                rows[j] = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+            }
+
+            __m256i t0 = _mm256_unpacklo_epi32(rows[0], rows[1]);
+            __m256i t1 = _mm256_unpackhi_epi32(rows[0], rows[1]);
+            __m256i t2 = _mm256_unpacklo_epi32(rows[2], rows[3]);
+            __m256i t3 = _mm256_unpackhi_epi32(rows[2], rows[3]);
+
+            int tail[8];
+            for (size_t k = 0; k < 8; ++k) {
+                tail[k] = static_cast<int>(load32(h[k] + 16));
+            }
+            __m256i words[5] = {
+                _mm256_unpacklo_epi64(t0, t2),
+                _mm256_unpackhi_epi64(t0, t2),
+                _mm256_unpacklo_epi64(t1, t3),
+                _mm256_unpackhi_epi64(t1, t3),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail))
+            };
+
+            __m256i acc = _mm256_setzero_si256();
+            for (const __m256i& w : words) {
+                acc = _mm256_add_epi32(acc, _mm256_and_si256(w, low_mask));
+                acc = _mm256_add_epi32(acc, _mm256_srli_epi32(w, 16));
+            }
+            acc = _mm256_add_epi32(_mm256_and_si256(acc, low_mask), _mm256_srli_epi32(acc, 16));
+            acc = _mm256_add_epi32(_mm256_and_si256(acc, low_mask), _mm256_srli_epi32(acc, 16));
+
+            uint32_t lanes[8];
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+            for (size_t k = 0; k < 8; ++k) {
+                sums[i + k] = to_network_sum(static_cast<uint16_t>(lanes[k]));
+            }
+        }
+
+        headers_sse2(headers + i, count - i, sums + i);
+    }
+
+    // GCC 12 implements the unmasked AVX-512 shifts and unpacks as masked
+    // builtins merging into _mm512_undefined_epi32(), which Release builds
+    // report as -Wmaybe-uninitialized. The zeroing forms with every lane
+    // selected give the same results from a defined source.
+    constexpr __mmask16 ALL_DWORDS = 0xFFFF;
+    constexpr __mmask8 ALL_QWORDS = 0xFF;
+
+    // Add each 64-bit lane's two 32-bit halves into acc0 and acc1, the same
+    // mask-and-shift split the header kernels use for 16-bit words
+    __attribute__((target("avx512f")))
+    inline void add_halves_avx512(__m512i& acc0, __m512i& acc1, __m512i v) {
+        const __m512i low_mask = _mm512_set1_epi64(0xFFFFFFFF);
+        acc0 = _mm512_add_epi64(acc0, _mm512_and_si512(v, low_mask));
+        acc1 = _mm512_add_epi64(acc1, _mm512_maskz_srli_epi64(ALL_QWORDS, v, 32));
+    }
+
+    __attribute__((target("avx512f")))
+    uint64_t sum_avx512(const uint8_t* data, size_t length) {
+        const __m512i zero = _mm512_setzero_si512();
+        __m512i acc0 = zero;
+        __m512i acc1 = zero;
+        size_t i = 0;
+
+        for (; i + 128 <= length; i += 128) {
+            __m512i a = _mm512_loadu_si512(data + i);
+            __m512i b = _mm512_loadu_si512(data + i + 64);
+            add_halves_avx512(acc0, acc1, a);
+            add_halves_avx512(acc0, acc1, b);
+        }
+
+        uint64_t lanes[16];
+        _mm512_storeu_si512(lanes, acc0);
+        _mm512_storeu_si512(lanes + 8, acc1);
+
+        // Finish the remainder with the AVX2 kernel rather than byte by byte
+        uint64_t sum = sum_avx2(data + i, length - i);
+        for (uint64_t lane : lanes) {
+            sum = add64(sum, lane);
+        }
+        return sum;
+    }
+
+    __attribute__((target("avx512f")))
+    uint64_t copy_sum_avx512(uint8_t* dst, const uint8_t* src, size_t length) {
+        const __m512i zero = _mm512_setzero_si512();
+        __m512i acc0 = zero;
+        __m512i acc1 = zero;
+        size_t i = 0;
+
+        for (; i + 128 <= length; i += 128) {
+            __m512i a = _mm512_loadu_si512(src + i);
+            __m512i b = _mm512_loadu_si512(src + i + 64);
+            _mm512_storeu_si512(dst + i, a);
+            _mm512_storeu_si512(dst + i + 64, b);
+            add_halves_avx512(acc0, acc1, a);
+            add_halves_avx512(acc0, acc1, b);
+        }
+
+        uint64_t lanes[16];
+        _mm512_storeu_si512(lanes, acc0);
+        _mm512_storeu_si512(lanes + 8, acc1);
+
+        uint64_t sum = copy_sum_avx2(dst + i, src + i, length - i);
+        for (uint64_t lane : lanes) {
+            sum = add64(sum, lane);
+        }
+        return sum;
+    }
+
+    __attribute__((target("avx512f")))
+    void headers_avx512(const uint8_t* const* headers, size_t count, uint16_t* sums) {
+        const __m512i low_mask = _mm512_set1_epi32(0xFFFF);
+        size_t i = 0;
+
+        for (; i + 16 <= count; i += 16) {
+            const uint8_t* const* h = headers + i;
+            // Row j holds headers j, j + 4, j + 8 and j + 12
+            __m512i rows[4];
+            for (size_t j = 0; j < 4; ++j) {
+                __m512i row = _mm512_castsi128_si512(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(h[j])));
+                row = _mm512_inserti32x4(row, _mm_loadu_si128(reinterpret_cast<const __m128i*>(h[j + 4])), 1);
+                row = _mm512_inserti32x4(row, _mm_loadu_si128(reinterpret_cast<const __m128i*>(h[j + 8])), 2);
+                row = _mm512_inserti32x4(row, _mm_loadu_si128(reinterpret_cast<const __m128i*>(h[j + 12])), 3);
+                rows[j] = row;
+            }
+
+            __m512i t0 = _mm512_maskz_unpacklo_epi32(ALL_DWORDS, rows[0], rows[1]);
+            __m512i t1 = _mm512_maskz_unpackhi_epi32(ALL_DWORDS, rows[0], rows[1]);
+            __m512i t2 = _mm512_maskz_unpacklo_epi32(ALL_DWORDS, rows[2], rows[3]);
+            __m512i t3 = _mm512_maskz_unpackhi_epi32(ALL_DWORDS, rows[2], rows[3]);
+
+            int tail[16];
+            for (size_t k = 0; k < 16; ++k) {
+                tail[k] = static_cast<int>(load32(h[k] + 16));
+            }
+            __m512i words[5] = {
+                _mm512_maskz_unpacklo_epi64(ALL_QWORDS, t0, t2),
+                _mm512_maskz_unpackhi_epi64(ALL_QWORDS, t0, t2),
+                _mm512_maskz_unpacklo_epi64(ALL_QWORDS, t1, t3),
+                _mm512_maskz_unpackhi_epi64(ALL_QWORDS, t1, t3),
+                _mm512_loadu_si512(tail)
+            };
+
+            __m512i acc = _mm512_setzero_si512();
+            for (const __m512i& w : words) {
+                acc = _mm512_add_epi32(acc, _mm512_and_si512(w, low_mask));
+                acc = _mm512_add_epi32(acc, _mm512_maskz_srli_epi32(ALL_DWORDS, w, 16));
+            }
+            acc = _mm512_add_epi32(_mm512_and_si512(acc, low_mask), _mm512_maskz_srli_epi32(ALL_DWORDS, acc, 16));
+            acc = _mm512_add_epi32(_mm512_and_si512(acc, low_mask), _mm512_maskz_srli_epi32(ALL_DWORDS, acc, 16));
+
+            uint32_t lanes[16];
+            _mm512_storeu_si512(lanes, acc);
+            for (size_t k = 0; k < 16; ++k) {
+                sums[i + k] = to_network_sum(static_cast<uint16_t>(lanes[k]));
+            }
+        }
+
+        headers_avx2(headers + i, count - i, sums + i);
+    }
+#endif
+
+    Kernel detect_kernel() {
+#ifdef CPPSCAPY_CHECKSUM_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return Kernel::AVX512;
+        if (__builtin_cpu_supports("avx2")) return Kernel::AVX2;
+        if (__builtin_cpu_supports("sse2")) return Kernel::SSE2;
+#endif
+        return Kernel::Scalar;
+    }
+
+    KernelFn kernel_function(Kernel kernel) {
+        switch (kernel) {
+#ifdef CPPSCAPY_CHECKSUM_X86
+            case Kernel::SSE2: return sum_sse2;
+            case Kernel::AVX2: return sum_avx2;
+            case Kernel::AVX512: return sum_avx512;
+#endif
+            default: return sum_scalar;
+        }
+    }
+
+    CopyKernelFn copy_kernel_function(Kernel kernel) {
+        switch (kernel) {
+#ifdef CPPSCAPY_CHECKSUM_X86
+            case Kernel::SSE2: return copy_sum_sse2;
+            case Kernel::AVX2: return copy_sum_avx2;
+            case Kernel::AVX512: return copy_sum_avx512;
+#endif
+            default: return copy_sum_scalar;
+        }
+    }
+
+    HeaderKernelFn header_kernel_function(Kernel kernel) {
+        switch (kernel) {
+#ifdef CPPSCAPY_CHECKSUM_X86
+            case Kernel::SSE2: return headers_sse2;
+            case Kernel::AVX2: return headers_avx2;
+            case Kernel::AVX512: return headers_avx512;
+#endif
+            default: return headers_scalar;
+        }
+    }
+
+    // Resolved on first use so that static initializers in other translation
+    // units can safely compute checksums
+    const KernelFn& active_function() {
+        static const KernelFn fn = kernel_function(active_kernel());
+        return fn;
+    }
+
+    const CopyKernelFn& active_copy_function() {
+        static const CopyKernelFn fn = copy_kernel_function(active_kernel());
+        return fn;
+    }
+
+    const HeaderKernelFn& active_header_function() {
+        static const HeaderKernelFn fn = header_kernel_function(active_kernel());
+        return fn;
+    }
+
+    inline uint16_t finish_partial(uint64_t native_sum, uint32_t initial) {
+        return fold(static_cast<uint64_t>(initial) + to_network_sum(fold(native_sum)));
+    }
+
+    // Fixed set of threads that run the chunks of one parallel sum at a time.
+    // The calling thread works on the job too, so a pool of N - 1 workers
+    // keeps N cores busy.
+    class SumPool {
+    public:
+        explicit SumPool(size_t workers) {
+            for (size_t i = 0; i < workers; ++i) {
+                threads_.emplace_back([this] { worker(); });
+            }
+        }
+
+        ~SumPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (auto& thread : threads_) {
+                thread.join();
+            }
+        }
+
+        SumPool(const SumPool&) = delete;
+        SumPool& operator=(const SumPool&) = delete;
+
+        size_t workers() const { return threads_.size(); }
+
+        // Run task(0) .. task(count - 1) and return once all have finished
+        void run(size_t count, const std::function<void(size_t)>& task) {
+            std::lock_guard<std::mutex> job_lock(job_mutex_);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                task_ = &task;
+                task_count_ = count;
+                next_.store(0, std::memory_order_relaxed);
+                remaining_ = count;
+                ++generation_;
+            }
+            wake_.notify_all();
+
+            drain(task, count);
+
+            // Workers never touch a job once it is over, so `task` can go
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return remaining_ == 0 && active_ == 0; });
+            task_ = nullptr;
+        }
+
+    private:
+        void drain(const std::function<void(size_t)>& task, size_t count) {
+            size_t index;
+            while ((index = next_.fetch_add(1, std::memory_order_relaxed)) < count) {
+                task(index);
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--remaining_ == 0) {
+                    done_.notify_all();
+                }
+            }
+        }
+
+        void worker() {
+            uint64_t seen = 0;
+            for (;;) {
+                const std::function<void(size_t)>* task;
+                size_t count;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    wake_.wait(lock, [&] { return stopping_ || (generation_ != seen && task_); });
+                    if (stopping_) {
+                        return;
+                    }
+                    seen = generation_;
+                    task = task_;
+                    count = task_count_;
+                    ++active_;
+                }
+
+                drain(*task, count);
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--active_ == 0) {
+                    done_.notify_all();
+                }
+            }
+        }
+
+        std::vector<std::thread> threads_;
+        std::mutex job_mutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        const std::function<void(size_t)>* task_ = nullptr;
+        size_t task_count_ = 0;
+        size_t remaining_ = 0;
+        size_t active_ = 0;
+        uint64_t generation_ = 0;
+        bool stopping_ = false;
+        std::atomic<size_t> next_{0};
+    };
+
+    constexpr size_t DEFAULT_PARALLEL_THRESHOLD = 4 * 1024 * 1024;
+    constexpr size_t PARALLEL_CHUNK_ALIGNMENT = 64;
+    // Chunks per thread, so a slow thread does not hold up the whole sum
+    constexpr size_t CHUNKS_PER_THREAD = 4;
+
+    std::atomic<size_t> parallel_threshold_bytes{DEFAULT_PARALLEL_THRESHOLD};
+
+    std::mutex pool_mutex;
+    size_t pool_threads = 0; // 0 = hardware concurrency
+    std::shared_ptr<SumPool> pool_instance;
+
+    std::shared_ptr<SumPool> sum_pool() {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        if (!pool_instance) {
+            size_t threads = pool_threads ? pool_threads : std::max(1u, std::thread::hardware_concurrency());
+            pool_instance = std::make_shared<SumPool>(threads - 1);
+        }
+        return pool_instance;
+    }
+
+    // Network-order partial sum of a large buffer split across the pool.
+    // Chunk boundaries sit on cache-line addresses, so a chunk may start at
+    // an odd offset of the buffer; its sum is byte-swapped before combining.
+    uint16_t parallel_partial(const uint8_t* data, size_t length) {
+        auto pool = sum_pool();
+        size_t chunks = (pool->workers() + 1) * CHUNKS_PER_THREAD;
+        size_t chunk_size = (length + chunks - 1) / chunks;
+
+        std::vector<size_t> bounds;
+        bounds.reserve(chunks + 1);
+        bounds.push_back(0);
+        uintptr_t base = reinterpret_cast<uintptr_t>(data);
+        for (size_t i = 1; i < chunks; ++i) {
+            uintptr_t target = base + i * chunk_size;
+            uintptr_t aligned = (target + PARALLEL_CHUNK_ALIGNMENT - 1) & ~uintptr_t(PARALLEL_CHUNK_ALIGNMENT - 1);
+            size_t offset = std::min<size_t>(aligned - base, length);
+            if (offset > bounds.back()) {
+                bounds.push_back(offset);
+            }
+        }
+        if (bounds.back() != length) {
+            bounds.push_back(length);
+        }
+
+        KernelFn kernel = active_function();
+        std::vector<uint16_t> sums(bounds.size() - 1);
+        std::function<void(size_t)> task = [&](size_t i) {
+            uint16_t sum = to_network_sum(fold(kernel(data + bounds[i], bounds[i + 1] - bounds[i])));
+            sums[i] = (bounds[i] & 1) ? swap_sum(sum) : sum;
+        };
+        pool->run(sums.size(), task);
+
+        uint64_t total = 0;
+        for (uint16_t sum : sums) {
+            total += sum;
+        }
+        return fold(total);
+    }
+}
+
+void set_parallel_threshold(size_t bytes) {
+    parallel_threshold_bytes.store(bytes, std::memory_order_relaxed);
+}
+
+size_t parallel_threshold() {
+    return parallel_threshold_bytes.load(std::memory_order_relaxed);
+}
+
+void set_parallel_threads(size_t threads) {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    pool_threads = threads;
+    // Running sums keep their own reference to the old pool
+    pool_instance.reset();
+}
+
+size_t parallel_threads() {
+    return sum_pool()->workers() + 1;
+}
+
+Kernel active_kernel() {
+    static const Kernel kernel = detect_kernel();
+    return kernel;
+}
+
+bool kernel_supported(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar:
+            return true;
+#ifdef CPPSCAPY_CHECKSUM_X86
+        case Kernel::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case Kernel::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case Kernel::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* kernel_name(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar: return "scalar";
+        case Kernel::SSE2: return "sse2";
+        case Kernel::AVX2: return "avx2";
+        case Kernel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+uint16_t partial(const uint8_t* data, size_t length, uint32_t initial) {
+    if (length == 0) {
+        return fold(initial);
+    }
+    size_t threshold = parallel_threshold();
+    if (threshold != 0 && length >= threshold) {
+        return fold(static_cast<uint64_t>(initial) + parallel_partial(data, length));
+    }
+    return finish_partial(active_function()(data, length), initial);
+}
+
+uint16_t partial(const std::vector<uint8_t>& data, uint32_t initial) {
+    return partial(data.data(), data.size(), initial);
+}
+
+uint16_t partial_with(Kernel kernel, const uint8_t* data, size_t length, uint32_t initial) {
+    if (!kernel_supported(kernel)) {
+        throw std::invalid_argument("Checksum kernel not supported on this CPU");
+    }
+    if (length == 0) {
+        return fold(initial);
+    }
+    return finish_partial(kernel_function(kernel)(data, length), initial);
+}
+
+uint16_t partial_copy(uint8_t* dst, const uint8_t* src, size_t length, uint32_t initial) {
+    if (length == 0) {
+        return fold(initial);
+    }
+    return finish_partial(active_copy_function()(dst, src, length), initial);
+}
+
+uint16_t partial_copy_with(Kernel kernel, uint8_t* dst, const uint8_t* src, size_t length,
+                           uint32_t initial) {
+    if (!kernel_supported(kernel)) {
+        throw std::invalid_argument("Checksum kernel not supported on this CPU");
+    }
+    if (length == 0) {
+        return fold(initial);
+    }
+    return finish_partial(copy_kernel_function(kernel)(dst, src, length), initial);
+}
+
+void partial_ipv4_headers(const uint8_t* const* headers, size_t count, uint16_t* sums) {
+    active_header_function()(headers, count, sums);
+}
+
+void partial_ipv4_headers_with(Kernel kernel, const uint8_t* const* headers, size_t count,
+                               uint16_t* sums) {
+    if (!kernel_supported(kernel)) {
+        throw std::invalid_argument("Checksum kernel not supported on this CPU");
+    }
+    header_kernel_function(kernel)(headers, count, sums);
+}
+
+uint16_t compute(const uint8_t* data, size_t length) {
+    return static_cast<uint16_t>(~partial(data, length));
+}
+
+uint16_t compute(const std::vector<uint8_t>& data) {
+    return compute(data.data(), data.size());
+}
+
+uint16_t partial(const Segment* segments, size_t count, uint32_t initial) {
+    uint64_t sum = initial;
+    bool odd = false;
+    for (size_t i = 0; i < count; ++i) {
+        if (segments[i].length == 0) {
+            continue;
+        }
+        uint16_t segment_sum = partial(segments[i].data, segments[i].length);
+        if (odd) {
+            segment_sum = swap_sum(segment_sum);
+        }
+        sum += segment_sum;
+        odd ^= (segments[i].length & 1) != 0;
+    }
+    return fold(sum);
+}
+
+uint16_t partial(std::initializer_list<Segment> segments, uint32_t initial) {
+    return partial(segments.begin(), segments.size(), initial);
+}
+
+uint16_t compute(std::initializer_list<Segment> segments) {
+    return static_cast<uint16_t>(~partial(segments));
+}
+
+uint16_t adjust_bytes(uint16_t checksum, const uint8_t* old_bytes, const uint8_t* new_bytes, size_t length) {
+    uint64_t sum = static_cast<uint16_t>(~checksum);
+    for (size_t i = 0; i + 1 < length; i += 2) {
+        sum += static_cast<uint16_t>(~((old_bytes[i] << 8) | old_bytes[i + 1]));
+        sum += static_cast<uint16_t>((new_bytes[i] << 8) | new_bytes[i + 1]);
+    }
+    return finish(sum);
+}
+
+} // namespace checksum
+} // namespace cppscapy
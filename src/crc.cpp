@@ -0,0 +1,463 @@
+#include "../include/crc.h"
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CPPSCAPY_CRC_X86 1
+#include <immintrin.h>
+#endif
+
+namespace cppscapy {
+namespace crc {
+
+namespace {
+    constexpr uint32_t CRC32C_POLY = 0x82F63B78;
+    constexpr uint32_t CRC32_POLY = 0xEDB88320;
+
+    template<size_t Slices>
+    using SliceTables = std::array<std::array<uint32_t, 256>, Slices>;
+
+    // Slicing tables for a reflected CRC: table[k][n] is the CRC of byte n
+    // followed by k zero bytes
+    template<size_t Slices>
+    constexpr SliceTables<Slices> make_slice_tables(uint32_t poly) {
+        SliceTables<Slices> tables{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t crc = n;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+            }
+            tables[0][n] = crc;
+        }
+        for (size_t k = 1; k < Slices; ++k) {
+            for (uint32_t n = 0; n < 256; ++n) {
+                uint32_t prev = tables[k - 1][n];
+                tables[k][n] = (prev >> 8) ^ tables[0][prev & 0xFF];
+            }
+        }
+        return tables;
+    }
+
+    constexpr SliceTables<8> CRC32C_TABLES = make_slice_tables<8>(CRC32C_POLY);
+    constexpr SliceTables<16> CRC32_TABLES = make_slice_tables<16>(CRC32_POLY);
+
+    inline uint32_t load32le(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    // Slice-by-8 on the internal (pre-inverted) CRC state
+    uint32_t crc32c_software(uint32_t crc, const uint8_t* data, size_t length) {
+        const auto& t = CRC32C_TABLES;
+        while (length >= 8) {
+            uint32_t lo = crc ^ load32le(data);
+            uint32_t hi = load32le(data + 4);
+            crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+                  t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+            data += 8;
+            length -= 8;
+        }
+        while (length--) {
+            crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+        }
+        return crc;
+    }
+
+    // Slice-by-16 for IEEE CRC32
+    uint32_t crc32_software(uint32_t crc, const uint8_t* data, size_t length) {
+        const auto& t = CRC32_TABLES;
+        while (length >= 16) {
+            uint32_t w0 = crc ^ load32le(data);
+            uint32_t w1 = load32le(data + 4);
+            uint32_t w2 = load32le(data + 8);
+            uint32_t w3 = load32le(data + 12);
+            crc = t[15][w0 & 0xFF] ^ t[14][(w0 >> 8) & 0xFF] ^ t[13][(w0 >> 16) & 0xFF] ^ t[12][w0 >> 24] ^
+                  t[11][w1 & 0xFF] ^ t[10][(w1 >> 8) & 0xFF] ^ t[9][(w1 >> 16) & 0xFF] ^ t[8][w1 >> 24] ^
+                  t[7][w2 & 0xFF] ^ t[6][(w2 >> 8) & 0xFF] ^ t[5][(w2 >> 16) & 0xFF] ^ t[4][w2 >> 24] ^
+                  t[3][w3 & 0xFF] ^ t[2][(w3 >> 8) & 0xFF] ^ t[1][(w3 >> 16) & 0xFF] ^ t[0][w3 >> 24];
+            data += 16;
+            length -= 16;
+        }
+        while (length--) {
+            crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+        }
+        return crc;
+    }
+
+#ifdef CPPSCAPY_CRC_X86
+    // Block sizes for the interleaved hardware kernel. Three streams hide the
+    // 3-cycle latency of crc32; the partial CRCs are merged by "appending"
+    // zero bytes to the earlier streams with a precomputed GF(2) operator.
+    constexpr size_t LONG_BLOCK = 8192;
+    constexpr size_t SHORT_BLOCK = 256;
+
+    using ShiftTables = std::array<std::array<uint32_t, 256>, 4>;
+
+    uint32_t gf2_matrix_times(const uint32_t* mat, uint32_t vec) {
+        uint32_t sum = 0;
+        while (vec) {
+            if (vec & 1) {
+                sum ^= *mat;
+            }
+            vec >>= 1;
+            ++mat;
+        }
+        return sum;
+    }
+
+    void gf2_matrix_square(uint32_t* square, const uint32_t* mat) {
+        for (int n = 0; n < 32; ++n) {
+            square[n] = gf2_matrix_times(mat, mat[n]);
+        }
+    }
+
+    // Operator that advances a CRC over `length` zero bytes (power of two)
+    void zeros_operator(uint32_t* even, size_t length) {
+        uint32_t odd[32];
+        odd[0] = CRC32C_POLY; // One zero bit
+        uint32_t row = 1;
+        for (int n = 1; n < 32; ++n) {
+            odd[n] = row;
+            row <<= 1;
+        }
+
+        gf2_matrix_square(even, odd); // Two zero bits
+        gf2_matrix_square(odd, even); // Four zero bits
+
+        // Each square doubles the span: one zero byte first, then two, ...
+        do {
+            gf2_matrix_square(even, odd);
+            length >>= 1;
+            if (length == 0) {
+                return;
+            }
+            gf2_matrix_square(odd, even);
+            length >>= 1;
+        } while (length);
+
+        for (int n = 0; n < 32; ++n) {
+            even[n] = odd[n];
+        }
+    }
+
+    ShiftTables make_shift_tables(size_t length) {
+        uint32_t op[32];
+        zeros_operator(op, length);
+        ShiftTables tables{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            tables[0][n] = gf2_matrix_times(op, n);
+            tables[1][n] = gf2_matrix_times(op, n << 8);
+            tables[2][n] = gf2_matrix_times(op, n << 16);
+            tables[3][n] = gf2_matrix_times(op, n << 24);
+        }
+        return tables;
+    }
+
+    inline uint32_t shift(const ShiftTables& tables, uint32_t crc) {
+        return tables[0][crc & 0xFF] ^ tables[1][(crc >> 8) & 0xFF] ^
+               tables[2][(crc >> 16) & 0xFF] ^ tables[3][crc >> 24];
+    }
+
+    const ShiftTables& long_shift() {
+        static const ShiftTables tables = make_shift_tables(LONG_BLOCK);
+        return tables;
+    }
+
+    const ShiftTables& short_shift() {
+        static const ShiftTables tables = make_shift_tables(SHORT_BLOCK);
+        return tables;
+    }
+
+    inline uint64_t load64(const uint8_t* p) {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    template<size_t Block>
+    __attribute__((target("sse4.2")))
+    uint32_t crc32c_interleaved(uint32_t crc0, const uint8_t*& data, size_t& length,
+                                const ShiftTables& tables) {
+        while (length >= 3 * Block) {
+            uint64_t crc1 = 0;
+            uint64_t crc2 = 0;
+            uint64_t c0 = crc0;
+            const uint8_t* end = data + Block;
+            do {
+                c0 = _mm_crc32_u64(c0, load64(data));
+                crc1 = _mm_crc32_u64(crc1, load64(data + Block));
+                crc2 = _mm_crc32_u64(crc2, load64(data + 2 * Block));
+                data += 8;
+            } while (data < end);
+            crc0 = shift(tables, static_cast<uint32_t>(c0)) ^ static_cast<uint32_t>(crc1);
+            crc0 = shift(tables, crc0) ^ static_cast<uint32_t>(crc2);
+            data += 2 * Block;
+            length -= 3 * Block;
+        }
+        return crc0;
+    }
+
+    __attribute__((target("sse4.2")))
+    uint32_t crc32c_hardware(uint32_t crc, const uint8_t* data, size_t length) {
+        // Align to 8 bytes for the 64-bit steps
+        while (length && (reinterpret_cast<uintptr_t>(data) & 7)) {
+            crc = _mm_crc32_u8(crc, *data++);
+            --length;
+        }
+
+        crc = crc32c_interleaved<LONG_BLOCK>(crc, data, length, long_shift());
+        crc = crc32c_interleaved<SHORT_BLOCK>(crc, data, length, short_shift());
+
+        uint64_t c = crc;
+        while (length >= 8) {
+            c = _mm_crc32_u64(c, load64(data));
+            data += 8;
+            length -= 8;
+        }
+        crc = static_cast<uint32_t>(c);
+        while (length--) {
+            crc = _mm_crc32_u8(crc, *data++);
+        }
+        return crc;
+    }
+
+    // Carry-less multiply folding for the bit-reflected IEEE polynomial
+    // ("Fast CRC Computation for Generic Polynomials Using PCLMULQDQ",
+    // Intel, 2009). Four 128-bit lanes are folded 64 bytes at a time, then
+    // reduced to 128, 64 and finally 32 bits with a Barrett reduction.
+    // Requires length >= 64 and a multiple of 16.
+    alignas(16) constexpr uint64_t FOLD_BY_4[2] = {0x0154442BD4, 0x01C6E41596};
+    alignas(16) constexpr uint64_t FOLD_BY_1[2] = {0x01751997D0, 0x00CCAA009E};
+    alignas(16) constexpr uint64_t FOLD_64[2] = {0x0163CD6124, 0x0000000000};
+    alignas(16) constexpr uint64_t BARRETT[2] = {0x01DB710641, 0x01F7011641};
+
+    __attribute__((target("pclmul,sse4.1")))
+    inline __m128i fold_16(__m128i acc, __m128i next, __m128i k) {
+        __m128i lo = _mm_clmulepi64_si128(acc, k, 0x00);
+        __m128i hi = _mm_clmulepi64_si128(acc, k, 0x11);
+        return _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+    }
+
+    __attribute__((target("pclmul,sse4.1")))
+    uint32_t crc32_fold(uint32_t crc, const uint8_t* data, size_t length) {
+        __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16));
+        __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32));
+        __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48));
+        x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+        data += 64;
+        length -= 64;
+
+        __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(FOLD_BY_4));
+        while (length >= 64) {
+            __m128i lo1 = _mm_clmulepi64_si128(x1, k, 0x00);
+            __m128i lo2 = _mm_clmulepi64_si128(x2, k, 0x00);
+            __m128i lo3 = _mm_clmulepi64_si128(x3, k, 0x00);
+            __m128i lo4 = _mm_clmulepi64_si128(x4, k, 0x00);
+            x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+            x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+            x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+            x4 = _mm_clmulepi64_si128(x4, k, 0x11);
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, lo1), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+            x2 = _mm_xor_si128(_mm_xor_si128(x2, lo2), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)));
+            x3 = _mm_xor_si128(_mm_xor_si128(x3, lo3), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)));
+            x4 = _mm_xor_si128(_mm_xor_si128(x4, lo4), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)));
+            data += 64;
+            length -= 64;
+        }
+
+        // Fold the four lanes into one, then any remaining 16-byte blocks
+        k = _mm_load_si128(reinterpret_cast<const __m128i*>(FOLD_BY_1));
+        x1 = fold_16(x1, x2, k);
+        x1 = fold_16(x1, x3, k);
+        x1 = fold_16(x1, x4, k);
+        while (length >= 16) {
+            x1 = fold_16(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), k);
+            data += 16;
+            length -= 16;
+        }
+
+        // 128 -> 64 bits
+        const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+        x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+        x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+        k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(FOLD_64));
+        x2 = _mm_srli_si128(x1, 4);
+        x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00);
+        x1 = _mm_xor_si128(x1, x2);
+
+        // Barrett reduction to 32 bits
+        k = _mm_load_si128(reinterpret_cast<const __m128i*>(BARRETT));
+        x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+        x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), k, 0x00);
+        x1 = _mm_xor_si128(x1, x2);
+        return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+    }
+
+    uint32_t crc32_hardware(uint32_t crc, const uint8_t* data, size_t length) {
+        if (length >= 64) {
+            size_t folded = length & ~size_t(15);
+            crc = crc32_fold(crc, data, folded);
+            data += folded;
+            length -= folded;
+        }
+        return crc32_software(crc, data, length);
+    }
+#endif
+
+    using CrcFn = uint32_t (*)(uint32_t, const uint8_t*, size_t);
+
+    CrcFn crc32c_function(Kernel kernel) {
+#ifdef CPPSCAPY_CRC_X86
+        if (kernel == Kernel::Hardware) {
+            return crc32c_hardware;
+        }
+#endif
+        (void)kernel;
+        return crc32c_software;
+    }
+
+    CrcFn crc32_function(Kernel kernel) {
+#ifdef CPPSCAPY_CRC_X86
+        if (kernel == Kernel::Hardware) {
+            return crc32_hardware;
+        }
+#endif
+        (void)kernel;
+        return crc32_software;
+    }
+
+    // Resolved on first use, like the checksum kernels
+    const CrcFn& active_crc32c() {
+        static const CrcFn fn = crc32c_function(crc32c_kernel());
+        return fn;
+    }
+
+    const CrcFn& active_crc32() {
+        static const CrcFn fn = crc32_function(crc32_kernel());
+        return fn;
+    }
+
+    constexpr size_t FCS_SIZE = 4;
+    // Minimum Ethernet frame without FCS (64 bytes on the wire)
+    constexpr size_t MIN_FRAME_SIZE = 60;
+
+    constexpr size_t SCTP_CHECKSUM_OFFSET = 8;
+    constexpr size_t SCTP_COMMON_HEADER_SIZE = 12;
+}
+
+Kernel crc32c_kernel() {
+    static const Kernel kernel = crc32c_supported(Kernel::Hardware) ? Kernel::Hardware : Kernel::Software;
+    return kernel;
+}
+
+bool crc32c_supported(Kernel kernel) {
+    if (kernel == Kernel::Software) {
+        return true;
+    }
+#ifdef CPPSCAPY_CRC_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#else
+    return false;
+#endif
+}
+
+uint32_t crc32c(const uint8_t* data, size_t length, uint32_t crc) {
+    return ~active_crc32c()(~crc, data, length);
+}
+
+uint32_t crc32c(const std::vector<uint8_t>& data, uint32_t crc) {
+    return crc32c(data.data(), data.size(), crc);
+}
+
+uint32_t crc32c_with(Kernel kernel, const uint8_t* data, size_t length, uint32_t crc) {
+    if (!crc32c_supported(kernel)) {
+        throw std::invalid_argument("CRC kernel not supported on this CPU");
+    }
+    return ~crc32c_function(kernel)(~crc, data, length);
+}
+
+Kernel crc32_kernel() {
+    static const Kernel kernel = crc32_supported(Kernel::Hardware) ? Kernel::Hardware : Kernel::Software;
+    return kernel;
+}
+
+bool crc32_supported(Kernel kernel) {
+    if (kernel == Kernel::Software) {
+        return true;
+    }
+#ifdef CPPSCAPY_CRC_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#else
+    return false;
+#endif
+}
+
+uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc) {
+    return ~active_crc32()(~crc, data, length);
+}
+
+uint32_t crc32(const std::vector<uint8_t>& data, uint32_t crc) {
+    return crc32(data.data(), data.size(), crc);
+}
+
+uint32_t crc32_with(Kernel kernel, const uint8_t* data, size_t length, uint32_t crc) {
+    if (!crc32_supported(kernel)) {
+        throw std::invalid_argument("CRC kernel not supported on this CPU");
+    }
+    return ~crc32_function(kernel)(~crc, data, length);
+}
+
+uint32_t ethernet_fcs(const uint8_t* frame, size_t length) {
+    return crc32(frame, length);
+}
+
+void append_fcs(std::vector<uint8_t>& frame, bool pad) {
+    if (pad && frame.size() < MIN_FRAME_SIZE) {
+        frame.resize(MIN_FRAME_SIZE, 0);
+    }
+    uint32_t fcs = ethernet_fcs(frame.data(), frame.size());
+    // Transmitted least significant byte first
+    frame.push_back(fcs & 0xFF);
+    frame.push_back((fcs >> 8) & 0xFF);
+    frame.push_back((fcs >> 16) & 0xFF);
+    frame.push_back((fcs >> 24) & 0xFF);
+}
+
+bool verify_fcs(const uint8_t* frame, size_t length) {
+    if (length < FCS_SIZE) {
+        return false;
+    }
+    return ethernet_fcs(frame, length - FCS_SIZE) == load32le(frame + length - FCS_SIZE);
+}
+
+bool verify_fcs(const std::vector<uint8_t>& frame) {
+    return verify_fcs(frame.data(), frame.size());
+}
+
+uint32_t sctp_checksum(const uint8_t* sctp, size_t length) {
+    if (length < SCTP_COMMON_HEADER_SIZE) {
+        throw std::invalid_argument("SCTP packet shorter than the common header");
+    }
+    // Sum around the checksum field instead of copying the packet
+    static const uint8_t zero_field[4] = {0, 0, 0, 0};
+    uint32_t crc = crc32c(sctp, SCTP_CHECKSUM_OFFSET);
+    crc = crc32c(zero_field, sizeof(zero_field), crc);
+    crc = crc32c(sctp + SCTP_COMMON_HEADER_SIZE, length - SCTP_COMMON_HEADER_SIZE, crc);
+    return sctp_field_value(crc);
+}
+
+bool verify_sctp_checksum(const uint8_t* sctp, size_t length) {
+    if (length < SCTP_COMMON_HEADER_SIZE) {
+        return false;
+    }
+    const uint8_t* field = sctp + SCTP_CHECKSUM_OFFSET;
+    uint32_t stored = (static_cast<uint32_t>(field[0]) << 24) | (field[1] << 16) | (field[2] << 8) | field[3];
+    return sctp_checksum(sctp, length) == stored;
+}
+
+} // namespace crc
+} // namespace cppscapy
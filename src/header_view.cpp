@@ -0,0 +1,136 @@
+#include "../include/header_view.h"
+#include "../include/checksum.h"
+
+namespace cppscapy {
+
+namespace {
+    constexpr size_t IPV4_CHECKSUM_OFFSET = 10;
+    constexpr size_t TCP_CHECKSUM_OFFSET = 16;
+    constexpr size_t UDP_CHECKSUM_OFFSET = 6;
+    constexpr size_t ICMP_CHECKSUM_OFFSET = 2;
+
+    // A stored checksum is valid when the covered data, checksum included,
+    // sums to 0xFFFF
+    bool sums_to_ones(const uint8_t* data, size_t length, uint16_t pseudo_sum) {
+        return checksum::partial(data, length, pseudo_sum) == 0xFFFF;
+    }
+
+    void recompute(uint8_t* data, size_t length, size_t checksum_offset, uint16_t pseudo_sum,
+                   bool zero_is_ones = false) {
+        detail::store16(data + checksum_offset, 0);
+        uint16_t value = checksum::finish(checksum::partial(data, length, pseudo_sum));
+        if (zero_is_ones && value == 0) {
+            value = 0xFFFF;
+        }
+        detail::store16(data + checksum_offset, value);
+    }
+
+    // Rewrite a 16-bit word covered by a checksum and adjust it (RFC 1624)
+    void replace_word(uint8_t* field, uint16_t value, uint8_t* checksum_field) {
+        uint16_t adjusted = checksum::adjust(detail::load16(checksum_field), detail::load16(field), value);
+        detail::store16(field, value);
+        detail::store16(checksum_field, adjusted);
+    }
+}
+
+// IPv4
+MutableIpv4View& MutableIpv4View::length(uint16_t length) {
+    replace_word(data() + 2, length, data() + IPV4_CHECKSUM_OFFSET);
+    return *this;
+}
+
+MutableIpv4View& MutableIpv4View::update_checksum() {
+    recompute(data(), header_length(), IPV4_CHECKSUM_OFFSET, 0);
+    return *this;
+}
+
+// IPv6
+MutableIpv6View& MutableIpv6View::traffic_class(uint8_t tc) {
+    uint16_t word = detail::load16(data());
+    detail::store16(data(), static_cast<uint16_t>((word & 0xF00F) | (tc << 4)));
+    return *this;
+}
+
+MutableIpv6View& MutableIpv6View::flow_label(uint32_t label) {
+    data()[1] = static_cast<uint8_t>((data()[1] & 0xF0) | ((label >> 16) & 0x0F));
+    detail::store16(data() + 2, static_cast<uint16_t>(label));
+    return *this;
+}
+
+// MPLS
+MutableMplsView& MutableMplsView::label(uint32_t label) {
+    label &= 0xFFFFF;
+    data()[0] = static_cast<uint8_t>(label >> 12);
+    data()[1] = static_cast<uint8_t>(label >> 4);
+    data()[2] = static_cast<uint8_t>((data()[2] & 0x0F) | ((label & 0xF) << 4));
+    return *this;
+}
+
+// TCP
+bool TcpView::checksum_valid(const IPv4Address& src, const IPv4Address& dst) const {
+    return sums_to_ones(data_, length_, detail::pseudo_header_sum(src, dst, IPv4Header::PROTOCOL_TCP, length_));
+}
+
+bool TcpView::checksum_valid(const IPv6Address& src, const IPv6Address& dst) const {
+    return sums_to_ones(data_, length_, detail::pseudo_header_sum(src, dst, IPv6Header::NEXT_HEADER_TCP, length_));
+}
+
+MutableTcpView& MutableTcpView::update_checksum(const IPv4Address& src, const IPv4Address& dst) {
+    recompute(data(), length_, TCP_CHECKSUM_OFFSET,
+              detail::pseudo_header_sum(src, dst, IPv4Header::PROTOCOL_TCP, length_));
+    return *this;
+}
+
+MutableTcpView& MutableTcpView::update_checksum(const IPv6Address& src, const IPv6Address& dst) {
+    recompute(data(), length_, TCP_CHECKSUM_OFFSET,
+              detail::pseudo_header_sum(src, dst, IPv6Header::NEXT_HEADER_TCP, length_));
+    return *this;
+}
+
+// UDP
+bool UdpView::checksum_valid(const IPv4Address& src, const IPv4Address& dst) const {
+    size_t length = datagram_length();
+    return checksum() == 0 ||
+           sums_to_ones(data_, length, detail::pseudo_header_sum(src, dst, IPv4Header::PROTOCOL_UDP, length));
+}
+
+bool UdpView::checksum_valid(const IPv6Address& src, const IPv6Address& dst) const {
+    size_t length = datagram_length();
+    return sums_to_ones(data_, length, detail::pseudo_header_sum(src, dst, IPv6Header::NEXT_HEADER_UDP, length));
+}
+
+MutableUdpView& MutableUdpView::update_checksum(const IPv4Address& src, const IPv4Address& dst) {
+    size_t length = datagram_length();
+    recompute(data(), length, UDP_CHECKSUM_OFFSET,
+              detail::pseudo_header_sum(src, dst, IPv4Header::PROTOCOL_UDP, length), true);
+    return *this;
+}
+
+MutableUdpView& MutableUdpView::update_checksum(const IPv6Address& src, const IPv6Address& dst) {
+    size_t length = datagram_length();
+    recompute(data(), length, UDP_CHECKSUM_OFFSET,
+              detail::pseudo_header_sum(src, dst, IPv6Header::NEXT_HEADER_UDP, length), true);
+    return *this;
+}
+
+// ICMP
+bool IcmpView::checksum_valid() const {
+    return sums_to_ones(data_, length_, 0);
+}
+
+bool IcmpView::checksum_valid(const IPv6Address& src, const IPv6Address& dst) const {
+    return sums_to_ones(data_, length_, detail::pseudo_header_sum(src, dst, IPv6Header::NEXT_HEADER_ICMPV6, length_));
+}
+
+MutableIcmpView& MutableIcmpView::update_checksum() {
+    recompute(data(), length_, ICMP_CHECKSUM_OFFSET, 0);
+    return *this;
+}
+
+MutableIcmpView& MutableIcmpView::update_checksum(const IPv6Address& src, const IPv6Address& dst) {
+    recompute(data(), length_, ICMP_CHECKSUM_OFFSET,
+              detail::pseudo_header_sum(src, dst, IPv6Header::NEXT_HEADER_ICMPV6, length_));
+    return *this;
+}
+
+} // namespace cppscapy
@@ -0,0 +1,315 @@
+#include "../include/packet_buffer.h"
+#include "../include/checksum.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace cppscapy {
+
+PacketBuffer::PacketBuffer(size_t capacity, size_t headroom)
+    : storage_(new uint8_t[capacity]), capacity_(capacity), offset_(headroom) {
+    if (headroom > capacity) {
+        throw std::invalid_argument("Headroom larger than buffer capacity");
+    }
+}
+
+PacketBuffer::PacketBuffer(ByteSpan data, size_t headroom, size_t tailroom)
+    : PacketBuffer(headroom + data.size() + tailroom, headroom) {
+    std::memcpy(append(data.size()), data.data(), data.size());
+}
+
+PacketBuffer::~PacketBuffer() {
+    // Free the chain a segment at a time rather than recursively, so long
+    // chains cannot exhaust the stack
+    std::unique_ptr<PacketBuffer> segment = std::move(next_);
+    while (segment) {
+        segment = std::move(segment->next_);
+    }
+}
+
+PacketBuffer::PacketBuffer(PacketBuffer&& other) noexcept
+    : storage_(std::move(other.storage_)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      offset_(std::exchange(other.offset_, 0)),
+      length_(std::exchange(other.length_, 0)),
+      next_(std::move(other.next_)) {}
+
+PacketBuffer& PacketBuffer::operator=(PacketBuffer&& other) noexcept {
+    if (this != &other) {
+        storage_ = std::move(other.storage_);
+        capacity_ = std::exchange(other.capacity_, 0);
+        offset_ = std::exchange(other.offset_, 0);
+        length_ = std::exchange(other.length_, 0);
+        next_ = std::move(other.next_);
+    }
+    return *this;
+}
+
+uint8_t* PacketBuffer::prepend(size_t length) {
+    if (length > offset_) {
+        throw std::length_error("Not enough headroom in packet buffer");
+    }
+    offset_ -= length;
+    length_ += length;
+    return data();
+}
+
+uint8_t* PacketBuffer::append(size_t length) {
+    PacketBuffer& segment = last();
+    if (length > segment.tailroom()) {
+        throw std::length_error("Not enough tailroom in packet buffer");
+    }
+    uint8_t* out = segment.data() + segment.length_;
+    segment.length_ += length;
+    return out;
+}
+
+void PacketBuffer::adjust(size_t length) {
+    if (length > length_) {
+        throw std::length_error("Adjusting past the end of the segment");
+    }
+    offset_ += length;
+    length_ -= length;
+}
+
+void PacketBuffer::trim(size_t length) {
+    PacketBuffer& segment = last();
+    if (length > segment.length_) {
+        throw std::length_error("Trimming past the start of the segment");
+    }
+    segment.length_ -= length;
+}
+
+uint8_t* PacketBuffer::put(const PacketBuilder& builder) {
+    size_t length = builder.size();
+    uint8_t* out = append(length);
+    try {
+        builder.build_into(MutableByteSpan(out, length));
+    } catch (...) {
+        trim(length);
+        throw;
+    }
+    return out;
+}
+
+void PacketBuffer::append_data(ByteSpan data, size_t segment_capacity) {
+    if (segment_capacity == 0 && !data.empty()) {
+        throw std::invalid_argument("Segment capacity must be positive");
+    }
+    PacketBuffer* segment = &last();
+    size_t copied = 0;
+    while (copied < data.size()) {
+        if (segment->tailroom() == 0) {
+            segment->next_.reset(new PacketBuffer(segment_capacity, 0));
+            segment = segment->next_.get();
+        }
+        size_t count = std::min(segment->tailroom(), data.size() - copied);
+        std::memcpy(segment->data() + segment->length_, data.data() + copied, count);
+        segment->length_ += count;
+        copied += count;
+    }
+}
+
+PacketBuffer& PacketBuffer::chain(PacketBuffer segment) {
+    last().next_.reset(new PacketBuffer(std::move(segment)));
+    return *this;
+}
+
+size_t PacketBuffer::segment_count() const {
+    size_t count = 0;
+    for (const PacketBuffer* segment = this; segment; segment = segment->next()) {
+        ++count;
+    }
+    return count;
+}
+
+size_t PacketBuffer::total_size() const {
+    size_t total = 0;
+    for (const PacketBuffer* segment = this; segment; segment = segment->next()) {
+        total += segment->length_;
+    }
+    return total;
+}
+
+size_t PacketBuffer::copy_to(MutableByteSpan out) const {
+    if (out.size() < total_size()) {
+        throw std::length_error("Buffer too small for packet");
+    }
+    size_t offset = 0;
+    for (const PacketBuffer* segment = this; segment; segment = segment->next()) {
+        if (segment->length_ != 0) {
+            std::memcpy(out.data() + offset, segment->data(), segment->length_);
+        }
+        offset += segment->length_;
+    }
+    return offset;
+}
+
+std::vector<uint8_t> PacketBuffer::to_bytes() const {
+    std::vector<uint8_t> bytes(total_size());
+    copy_to(MutableByteSpan(bytes));
+    return bytes;
+}
+
+void PacketBuffer::reset(size_t headroom) {
+    if (headroom > capacity_) {
+        throw std::invalid_argument("Headroom larger than buffer capacity");
+    }
+    next_.reset();
+    offset_ = headroom;
+    length_ = 0;
+}
+
+PacketBuffer& PacketBuffer::last() {
+    PacketBuffer* segment = this;
+    while (segment->next_) {
+        segment = segment->next_.get();
+    }
+    return *segment;
+}
+
+namespace encap {
+
+namespace {
+    constexpr uint16_t ETHERTYPE_QINQ = 0x88A8;
+    constexpr size_t MAC_ADDRESSES = 12;
+    constexpr size_t TAG_SIZE = 4;
+
+    bool is_vlan(uint16_t ethertype) {
+        return ethertype == ETHERTYPE_VLAN || ethertype == ETHERTYPE_QINQ;
+    }
+
+    bool is_mpls(uint16_t ethertype) {
+        return ethertype == EthernetHeader::ETHERTYPE_MPLS || ethertype == EthernetHeader::ETHERTYPE_MPLS_MCAST;
+    }
+
+    // Offset of the EtherType after the MAC addresses and any VLAN tags
+    size_t ethertype_offset(const PacketBuffer& frame) {
+        size_t offset = MAC_ADDRESSES;
+        while (true) {
+            if (frame.size() < offset + 2) {
+                throw std::invalid_argument("Frame too short for its Ethernet header");
+            }
+            if (!is_vlan(detail::load16(frame.data() + offset))) {
+                return offset;
+            }
+            offset += TAG_SIZE;
+        }
+    }
+
+    // Open a gap of `length` bytes after the first `keep` bytes by moving
+    // them into the headroom
+    uint8_t* open_gap(PacketBuffer& frame, size_t keep, size_t length) {
+        uint8_t* data = frame.prepend(length);
+        std::memmove(data, data + length, keep);
+        return data + keep;
+    }
+
+    // The reverse: drop `length` bytes after the first `keep`
+    void close_gap(PacketBuffer& frame, size_t keep, size_t length) {
+        std::memmove(frame.data() + length, frame.data(), keep);
+        frame.adjust(length);
+    }
+}
+
+void push_vlan(PacketBuffer& frame, uint16_t tci, uint16_t tpid) {
+    if (frame.size() < EthernetHeader::SIZE) {
+        throw std::invalid_argument("Frame too short for its Ethernet header");
+    }
+    uint8_t* tag = open_gap(frame, MAC_ADDRESSES, TAG_SIZE);
+    detail::store16(tag, tpid);
+    detail::store16(tag + 2, tci);
+}
+
+uint16_t pop_vlan(PacketBuffer& frame) {
+    if (frame.size() < EthernetHeader::SIZE + TAG_SIZE || !is_vlan(detail::load16(frame.data() + MAC_ADDRESSES))) {
+        throw std::invalid_argument("Frame has no VLAN tag");
+    }
+    uint16_t tci = detail::load16(frame.data() + MAC_ADDRESSES + 2);
+    close_gap(frame, MAC_ADDRESSES, TAG_SIZE);
+    return tci;
+}
+
+void push_mpls(PacketBuffer& frame, MPLSHeader label) {
+    size_t type_offset = ethertype_offset(frame);
+    bool labeled = is_mpls(detail::load16(frame.data() + type_offset));
+    label.bottom_of_stack(!labeled);
+    uint8_t* out = open_gap(frame, type_offset + 2, MPLSHeader::SIZE);
+    if (!labeled) {
+        detail::store16(out - 2, EthernetHeader::ETHERTYPE_MPLS);
+    }
+    label.write_to(out);
+}
+
+MPLSHeader pop_mpls(PacketBuffer& frame, uint16_t inner_ethertype) {
+    size_t type_offset = ethertype_offset(frame);
+    size_t label_offset = type_offset + 2;
+    if (!is_mpls(detail::load16(frame.data() + type_offset)) || frame.size() < label_offset + MPLSHeader::SIZE) {
+        throw std::invalid_argument("Frame has no MPLS label");
+    }
+    MPLSHeader label = *MPLSHeader::parse(frame.data() + label_offset, MPLSHeader::SIZE);
+    if (label.bottom_of_stack()) {
+        detail::store16(frame.data() + type_offset, inner_ethertype);
+    }
+    close_gap(frame, label_offset, MPLSHeader::SIZE);
+    return label;
+}
+
+VxlanTunnel::VxlanTunnel(const EthernetHeader& outer_eth, const IPv4Header& outer_ip, uint16_t src_port,
+                         uint32_t vni) {
+    if (vni > 0xFFFFFF) {
+        throw std::invalid_argument("VXLAN network identifier exceeds 24 bits");
+    }
+    // The IP and UDP lengths are left zero for push_vxlan() to fill in
+    uint8_t* out = outer_.data();
+    out += EthernetHeader(outer_eth).ethertype(EthernetHeader::ETHERTYPE_IPV4).write_to(out);
+    out += IPv4Header(outer_ip).protocol(IPv4Header::PROTOCOL_UDP).length(0).write_to(out);
+    udp_offset_ = static_cast<size_t>(out - outer_.data());
+    out += UDPHeader(src_port, VXLAN_PORT, 0).write_to(out);
+    out[0] = 0x08;  // I flag: the VNI is valid
+    detail::store16(out + 4, static_cast<uint16_t>(vni >> 8));
+    out[6] = static_cast<uint8_t>(vni);
+    size_ = udp_offset_ + UDPHeader::SIZE + VXLAN_SIZE;
+}
+
+void push_vxlan(PacketBuffer& frame, const VxlanTunnel& tunnel) {
+    size_t udp_length = UDPHeader::SIZE + VXLAN_SIZE + frame.total_size();
+    size_t ip_length = tunnel.udp_offset_ - EthernetHeader::SIZE + udp_length;
+    if (ip_length > 0xFFFF) {
+        throw std::length_error("Frame too large for VXLAN over IPv4");
+    }
+
+    // Copy the headers serialized up front and patch the lengths, adjusting
+    // the IP checksum for the one word changed (RFC 1624)
+    uint8_t* out = frame.prepend(tunnel.size_);
+    std::memcpy(out, tunnel.outer_.data(), tunnel.size_);
+    uint8_t* ip = out + EthernetHeader::SIZE;
+    detail::store16(ip + 2, static_cast<uint16_t>(ip_length));
+    detail::store16(ip + 10, checksum::adjust(detail::load16(tunnel.outer_.data() + EthernetHeader::SIZE + 10), 0,
+                                      static_cast<uint16_t>(ip_length)));
+    detail::store16(out + tunnel.udp_offset_ + 4, static_cast<uint16_t>(udp_length));
+}
+
+uint32_t pop_vxlan(PacketBuffer& frame) {
+    size_t ip_offset = ethertype_offset(frame) + 2;
+    const uint8_t* data = frame.data();
+    if (detail::load16(data + ip_offset - 2) != EthernetHeader::ETHERTYPE_IPV4 ||
+        frame.size() < ip_offset + IPv4Header::MIN_SIZE || (data[ip_offset] >> 4) != 4 ||
+        (data[ip_offset] & 0x0F) < 5 || data[ip_offset + 9] != IPv4Header::PROTOCOL_UDP) {
+        throw std::invalid_argument("Frame is not VXLAN over IPv4");
+    }
+    size_t udp_offset = ip_offset + (data[ip_offset] & 0x0F) * 4u;
+    size_t end = udp_offset + UDPHeader::SIZE + VXLAN_SIZE;
+    if (frame.size() < end || detail::load16(data + udp_offset + 2) != VXLAN_PORT ||
+        !(data[udp_offset + UDPHeader::SIZE] & 0x08)) {
+        throw std::invalid_argument("Frame is not VXLAN over IPv4");
+    }
+    uint32_t vni = detail::load32(data + end - 4) >> 8;
+    frame.adjust(end);
+    return vni;
+}
+
+} // namespace encap
+
+} // namespace cppscapy
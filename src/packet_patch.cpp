@@ -0,0 +1,275 @@
+#include "../include/packet_patch.h"
+#include "../include/checksum.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace cppscapy {
+namespace patch {
+
+namespace {
+    constexpr uint8_t PROTO_TCP = 6;
+    constexpr uint8_t PROTO_UDP = 17;
+    constexpr uint8_t PROTO_ICMPV6 = 58;
+
+    // IPv6 extension headers walked to reach the transport header
+    constexpr uint8_t IPV6_HOP_BY_HOP = 0;
+    constexpr uint8_t IPV6_ROUTING = 43;
+    constexpr uint8_t IPV6_FRAGMENT = 44;
+    constexpr uint8_t IPV6_AUTH = 51;
+    constexpr uint8_t IPV6_DEST_OPTIONS = 60;
+
+    constexpr size_t IPV4_CHECKSUM_OFFSET = 10;
+    constexpr size_t UDP_CHECKSUM_OFFSET = 6;
+    constexpr size_t TCP_CHECKSUM_OFFSET = 16;
+    constexpr size_t ICMP_CHECKSUM_OFFSET = 2;
+    constexpr size_t IPV6_SRC_OFFSET = 8;
+    constexpr size_t IPV6_DST_OFFSET = 24;
+
+    // A transport checksum field located from the IP header
+    struct L4Checksum {
+        uint8_t* field = nullptr;
+        bool zero_means_none = false;  // UDP over IPv4: 0 is "not computed"
+        bool zero_is_ones = false;     // UDP: a result of 0 is sent as 0xFFFF
+        bool routed = false;           // IPv6: the pseudo-header destination is
+                                       // the routing header's final one
+    };
+
+    // Replace bytes covered by a checksum and adjust the stored value
+    void replace_bytes(uint8_t* field, const uint8_t* value, size_t length, uint8_t* csum, bool udp) {
+        uint16_t old_csum = detail::load16(csum);
+        if (udp && old_csum == 0) {
+            // UDP over IPv4 without a checksum
+            std::memcpy(field, value, length);
+            return;
+        }
+        uint16_t new_csum = checksum::adjust_bytes(old_csum, field, value, length);
+        if (udp && new_csum == 0) {
+            new_csum = 0xFFFF;
+        }
+        std::memcpy(field, value, length);
+        detail::store16(csum, new_csum);
+    }
+
+    void replace16(uint8_t* field, uint16_t value, uint8_t* csum, bool udp = false) {
+        uint8_t bytes[2];
+        detail::store16(bytes, value);
+        replace_bytes(field, bytes, 2, csum, udp);
+    }
+
+    void replace32(uint8_t* field, uint32_t value, uint8_t* csum, bool udp = false) {
+        uint8_t bytes[4];
+        detail::store32(bytes, value);
+        replace_bytes(field, bytes, 4, csum, udp);
+    }
+
+    // Adjust only the checksum for a change in bytes that live elsewhere
+    // (pseudo-header fields)
+    void adjust_for(const uint8_t* old_bytes, const uint8_t* new_bytes, size_t length, const L4Checksum& l4) {
+        if (!l4.field) {
+            return;
+        }
+        uint16_t old_csum = detail::load16(l4.field);
+        if (l4.zero_means_none && old_csum == 0) {
+            return;
+        }
+        uint16_t new_csum = checksum::adjust_bytes(old_csum, old_bytes, new_bytes, length);
+        if (l4.zero_is_ones && new_csum == 0) {
+            new_csum = 0xFFFF;
+        }
+        detail::store16(l4.field, new_csum);
+    }
+
+    L4Checksum ipv4_l4_checksum(uint8_t* ip, size_t length) {
+        L4Checksum l4;
+        size_t ihl = (ip[0] & 0x0F) * 4;
+        uint16_t fragment_offset = detail::load16(ip + 6) & 0x1FFF;
+        if (ihl < 20 || length < ihl || fragment_offset != 0) {
+            return l4;
+        }
+
+        uint8_t* transport = ip + ihl;
+        size_t available = length - ihl;
+        if (ip[9] == PROTO_UDP && available >= 8) {
+            l4.field = transport + UDP_CHECKSUM_OFFSET;
+            l4.zero_means_none = true;
+            l4.zero_is_ones = true;
+        } else if (ip[9] == PROTO_TCP && available >= 20) {
+            l4.field = transport + TCP_CHECKSUM_OFFSET;
+        }
+        return l4;
+    }
+
+    // Walks the extension headers to the transport header. A non-first
+    // fragment, ESP or a chain cut short by `length` leaves no checksum to fix.
+    L4Checksum ipv6_l4_checksum(uint8_t* ip, size_t length) {
+        L4Checksum l4;
+        if (length < IPv6Header::SIZE) {
+            return l4;
+        }
+
+        uint8_t next_header = ip[6];
+        size_t offset = IPv6Header::SIZE;
+        for (;;) {
+            if (next_header == IPV6_HOP_BY_HOP || next_header == IPV6_ROUTING ||
+                next_header == IPV6_DEST_OPTIONS || next_header == IPV6_FRAGMENT ||
+                next_header == IPV6_AUTH) {
+                if (length - offset < 8) {
+                    return l4;
+                }
+                const uint8_t* extension = ip + offset;
+                size_t extension_length = 8;
+                if (next_header == IPV6_FRAGMENT) {
+                    if (detail::load16(extension + 2) & 0xFFF8) {
+                        return l4;
+                    }
+                } else if (next_header == IPV6_AUTH) {
+                    extension_length = (extension[1] + 2) * 4u;
+                } else {
+                    extension_length = (extension[1] + 1) * 8u;
+                }
+                if (next_header == IPV6_ROUTING && extension[3] != 0) {
+                    l4.routed = true;
+                }
+                if (length - offset < extension_length) {
+                    return l4;
+                }
+                next_header = extension[0];
+                offset += extension_length;
+            } else {
+                break;
+            }
+        }
+
+        uint8_t* transport = ip + offset;
+        size_t available = length - offset;
+        if (next_header == PROTO_UDP && available >= 8) {
+            // UDP checksum is mandatory over IPv6: zero never means "none"
+            // and may not be sent (RFC 8200 section 8.1)
+            l4.field = transport + UDP_CHECKSUM_OFFSET;
+            l4.zero_is_ones = true;
+        } else if (next_header == PROTO_TCP && available >= 20) {
+            l4.field = transport + TCP_CHECKSUM_OFFSET;
+        } else if (next_header == PROTO_ICMPV6 && available >= 4) {
+            l4.field = transport + ICMP_CHECKSUM_OFFSET;
+        }
+        return l4;
+    }
+
+    void set_ipv4_address(uint8_t* ip, size_t length, size_t offset, const IPv4Address& addr) {
+        auto bytes = addr.to_bytes();
+        uint8_t old_bytes[4];
+        std::memcpy(old_bytes, ip + offset, 4);
+
+        adjust_for(old_bytes, bytes.data(), 4, ipv4_l4_checksum(ip, length));
+        replace_bytes(ip + offset, bytes.data(), 4, ip + IPV4_CHECKSUM_OFFSET, false);
+    }
+
+    void set_ipv6_address(uint8_t* ip, size_t length, size_t offset, const IPv6Address& addr) {
+        auto bytes = addr.to_bytes();
+        L4Checksum l4 = ipv6_l4_checksum(ip, length);
+        // With segments left, the checksum covers the final destination in
+        // the routing header rather than this field (RFC 8200 section 8.1)
+        if (!(offset == IPV6_DST_OFFSET && l4.routed)) {
+            adjust_for(ip + offset, bytes.data(), 16, l4);
+        }
+        std::memcpy(ip + offset, bytes.data(), 16);
+    }
+}
+
+void set_ipv4_tos(uint8_t* ip, uint8_t tos) {
+    replace16(ip, static_cast<uint16_t>((ip[0] << 8) | tos), ip + IPV4_CHECKSUM_OFFSET);
+}
+
+void set_ipv4_id(uint8_t* ip, uint16_t id) {
+    replace16(ip + 4, id, ip + IPV4_CHECKSUM_OFFSET);
+}
+
+void set_ipv4_ttl(uint8_t* ip, uint8_t ttl) {
+    replace16(ip + 8, static_cast<uint16_t>((ttl << 8) | ip[9]), ip + IPV4_CHECKSUM_OFFSET);
+}
+
+void set_ipv4_src(uint8_t* ip, size_t length, const IPv4Address& addr) {
+    set_ipv4_address(ip, length, 12, addr);
+}
+
+void set_ipv4_dst(uint8_t* ip, size_t length, const IPv4Address& addr) {
+    set_ipv4_address(ip, length, 16, addr);
+}
+
+void set_ipv6_src(uint8_t* ip, size_t length, const IPv6Address& addr) {
+    set_ipv6_address(ip, length, IPV6_SRC_OFFSET, addr);
+}
+
+void set_ipv6_dst(uint8_t* ip, size_t length, const IPv6Address& addr) {
+    set_ipv6_address(ip, length, IPV6_DST_OFFSET, addr);
+}
+
+void set_udp_src_port(uint8_t* udp, uint16_t port) {
+    replace16(udp, port, udp + UDP_CHECKSUM_OFFSET, true);
+}
+
+void set_udp_dst_port(uint8_t* udp, uint16_t port) {
+    replace16(udp + 2, port, udp + UDP_CHECKSUM_OFFSET, true);
+}
+
+void set_tcp_src_port(uint8_t* tcp, uint16_t port) {
+    replace16(tcp, port, tcp + TCP_CHECKSUM_OFFSET);
+}
+
+void set_tcp_dst_port(uint8_t* tcp, uint16_t port) {
+    replace16(tcp + 2, port, tcp + TCP_CHECKSUM_OFFSET);
+}
+
+void set_tcp_seq_num(uint8_t* tcp, uint32_t seq) {
+    replace32(tcp + 4, seq, tcp + TCP_CHECKSUM_OFFSET);
+}
+
+void set_tcp_ack_num(uint8_t* tcp, uint32_t ack) {
+    replace32(tcp + 8, ack, tcp + TCP_CHECKSUM_OFFSET);
+}
+
+void set_tcp_window_size(uint8_t* tcp, uint16_t window) {
+    replace16(tcp + 14, window, tcp + TCP_CHECKSUM_OFFSET);
+}
+
+void set_tcp_flags(uint8_t* tcp, uint8_t flags) {
+    replace16(tcp + 12, static_cast<uint16_t>((tcp[12] << 8) | flags), tcp + TCP_CHECKSUM_OFFSET);
+}
+
+bool set_tcp_timestamps(uint8_t* tcp, uint32_t value, uint32_t echo_reply) {
+    size_t header_length = (tcp[12] >> 4) * 4u;
+    if (header_length <= TCPHeader::MIN_SIZE) {
+        return false;
+    }
+    uint8_t* options = tcp + TCPHeader::MIN_SIZE;
+    size_t length = header_length - TCPHeader::MIN_SIZE;
+    size_t offset = TCPOptions::find(options, length, TCPOptions::OPTION_TIMESTAMPS);
+    if (offset == TCPOptions::NOT_FOUND || offset + 10 > length) {
+        return false;
+    }
+    if (options[offset + 1] != 10) {
+        throw std::invalid_argument("TCP timestamp option length must be 10");
+    }
+    
+    // The option may sit at an odd offset; the checksum update needs whole
+    // 16-bit words, so replace the word-aligned bytes around the two values
+    size_t start = (offset + 2) & ~size_t(1);
+    size_t end = (offset + 11) & ~size_t(1);
+    uint8_t bytes[10];
+    std::memcpy(bytes, options + start, end - start);
+    detail::store32(bytes + (offset + 2 - start), value);
+    detail::store32(bytes + (offset + 6 - start), echo_reply);
+    replace_bytes(options + start, bytes, end - start, tcp + TCP_CHECKSUM_OFFSET, false);
+    return true;
+}
+
+void set_icmp_identifier(uint8_t* icmp, uint16_t id) {
+    replace16(icmp + 4, id, icmp + ICMP_CHECKSUM_OFFSET);
+}
+
+void set_icmp_sequence(uint8_t* icmp, uint16_t seq) {
+    replace16(icmp + 6, seq, icmp + ICMP_CHECKSUM_OFFSET);
+}
+
+} // namespace patch
+} // namespace cppscapy
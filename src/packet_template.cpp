@@ -0,0 +1,322 @@
+#include "../include/packet_template.h"
+#include "../include/checksum.h"
+#include "../include/crc.h"
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace cppscapy {
+
+namespace {
+    constexpr uint16_t ETHERTYPE_VLAN = 0x8100;
+    constexpr uint16_t ETHERTYPE_QINQ = 0x88A8;
+
+    uint64_t load_value(const uint8_t* data, size_t width) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < width; ++i) {
+            value = (value << 8) | data[i];
+        }
+        return value;
+    }
+
+    // Big-endian store; the common widths are spelled out so they compile to
+    // a byte swap and a single store
+    void store_value(uint8_t* out, uint64_t value, size_t width) {
+        switch (width) {
+        case 2:
+            detail::store16(out, static_cast<uint16_t>(value));
+            break;
+        case 4:
+            detail::store32(out, static_cast<uint32_t>(value));
+            break;
+        default:
+            for (size_t i = width; i-- > 0;) {
+                out[i] = static_cast<uint8_t>(value);
+                value >>= 8;
+            }
+            break;
+        }
+    }
+
+    // One's complement sum of a big-endian field. As 2^16 = 1 modulo 0xFFFF,
+    // folding the value sums its 16-bit digits; when the field and the
+    // checksummed data disagree on which bytes are high, the sum is swapped.
+    uint16_t value_sum(uint64_t value, bool swapped) {
+        uint16_t sum = checksum::fold(value);
+        return swapped ? checksum::swap_sum(sum) : sum;
+    }
+
+    void require(bool present, const char* message) {
+        if (!present) {
+            throw std::invalid_argument(message);
+        }
+    }
+}
+
+// FieldGenerator implementation
+
+FieldGenerator FieldGenerator::sequence(uint64_t start, uint64_t step) {
+    FieldGenerator generator(Kind::SEQUENCE);
+    generator.current_ = start;
+    generator.step_ = step;
+    return generator;
+}
+
+FieldGenerator FieldGenerator::list(std::vector<uint64_t> values) {
+    if (values.empty()) {
+        throw std::invalid_argument("Field value list is empty");
+    }
+    FieldGenerator generator(Kind::LIST);
+    generator.values_ = std::move(values);
+    return generator;
+}
+
+FieldGenerator FieldGenerator::range(uint64_t first, uint64_t last) {
+    if (last < first) {
+        throw std::invalid_argument("Field range ends before it starts");
+    }
+    FieldGenerator generator(Kind::RANGE);
+    generator.current_ = first;
+    generator.first_ = first;
+    generator.last_ = last;
+    return generator;
+}
+
+FieldGenerator FieldGenerator::random(uint64_t min, uint64_t max, uint64_t seed) {
+    if (max < min) {
+        throw std::invalid_argument("Field range ends before it starts");
+    }
+    FieldGenerator generator(Kind::RANDOM);
+    generator.current_ = seed != 0 ? seed : 0x9E3779B97F4A7C15ull;  // xorshift sticks at zero
+    generator.first_ = min;
+    generator.span_ = max - min + 1;
+    return generator;
+}
+
+// PacketTemplate implementation
+
+PacketTemplate::PacketTemplate(const PacketBuilder& builder)
+    : length_(builder.packet_.size()), fcs_(builder.fcs_) {
+    PacketBuilder finalized = builder;
+    frame_ = std::move(finalized.finalize()).build();
+
+    using Layer = PacketBuilder::Layer;
+    auto header_length = [](Layer type, const uint8_t* header) -> size_t {
+        switch (type) {
+        case Layer::ETHERNET: return EthernetHeader::SIZE;
+        case Layer::IPV4: return (header[0] & 0x0F) * 4u;
+        case Layer::IPV6: return IPv6Header::SIZE;
+        case Layer::MPLS: return MPLSHeader::SIZE;
+        case Layer::TCP: return (header[12] >> 4) * 4u;
+        case Layer::UDP: return UDPHeader::SIZE;
+        case Layer::ICMP: return ICMPHeader::MIN_SIZE;
+        }
+        return 0;
+    };
+    
+    bool seen_ethernet = false;
+    for (size_t i = 0; i < builder.layer_count_; ++i) {
+        Layer type = builder.layers_[i].type;
+        size_t offset = builder.layers_[i].offset;
+        const uint8_t* header = frame_.data() + offset;
+        payload_offset_ = offset + header_length(type, header);
+
+        switch (type) {
+        case Layer::ETHERNET: {
+            uint16_t ethertype = detail::load16(header + 12);
+            if (!seen_ethernet && (ethertype == ETHERTYPE_VLAN || ethertype == ETHERTYPE_QINQ) &&
+                offset + EthernetHeader::SIZE + 2 <= length_) {
+                vlan_offset_ = offset + EthernetHeader::SIZE;
+            }
+            seen_ethernet = true;
+            break;
+        }
+        case Layer::IPV4:
+        case Layer::IPV6:
+            ip_offset_ = offset;
+            ipv6_ = type == Layer::IPV6;
+            tcp_offset_ = NONE;
+            ports_offset_ = NONE;
+            if (!ipv6_) {
+                checksums_.push_back({offset + 10, offset, payload_offset_, 0, 0,
+                                      static_cast<uint16_t>(~detail::load16(header + 10)), false, 0});
+            }
+            break;
+        case Layer::TCP:
+        case Layer::UDP:
+        case Layer::ICMP: {
+            bool icmp = type == Layer::ICMP;
+            if (!icmp) {
+                ports_offset_ = offset;
+                tcp_offset_ = type == Layer::TCP ? offset : NONE;
+            }
+            // The same cases PacketBuilder::finalize() completes
+            if (!icmp && ip_offset_ == NONE) {
+                break;
+            }
+            size_t checksum_offset = offset + (icmp ? 2 : (type == Layer::UDP ? 6 : 16));
+            size_t pseudo_begin = 0;
+            size_t pseudo_end = 0;
+            if (ip_offset_ != NONE && ipv6_) {
+                pseudo_begin = ip_offset_ + 8;
+                pseudo_end = ip_offset_ + 40;
+            } else if (!icmp) {
+                pseudo_begin = ip_offset_ + 12;
+                pseudo_end = ip_offset_ + 20;
+            }
+            checksums_.push_back({checksum_offset, offset, length_, pseudo_begin, pseudo_end,
+                                  static_cast<uint16_t>(~detail::load16(frame_.data() + checksum_offset)),
+                                  type == Layer::UDP, 0});
+            break;
+        }
+        case Layer::MPLS:
+            break;
+        }
+    }
+    
+    // In a tunnel the inner checksum fields are data to the outer checksums
+    for (Checksum& inner : checksums_) {
+        for (size_t i = 0; i < checksums_.size(); ++i) {
+            if (&checksums_[i] != &inner && checksums_[i].begin <= inner.offset && inner.offset < checksums_[i].end) {
+                inner.covered_by |= 1u << i;
+            }
+        }
+    }
+}
+
+PacketTemplate& PacketTemplate::set(Field field, FieldGenerator generator) {
+    int key = static_cast<int>(field);
+    bool ipv4 = ip_offset_ != NONE && !ipv6_;
+    bool ipv6 = ip_offset_ != NONE && ipv6_;
+    switch (field) {
+    case Field::IPV4_SRC:
+        require(ipv4, "Template has no IPv4 header");
+        return add_slot(key, ip_offset_ + 12, 4, 0xFFFFFFFF, std::move(generator));
+    case Field::IPV4_DST:
+        require(ipv4, "Template has no IPv4 header");
+        return add_slot(key, ip_offset_ + 16, 4, 0xFFFFFFFF, std::move(generator));
+    case Field::IPV6_SRC:
+        require(ipv6, "Template has no IPv6 header");
+        return add_slot(key, ip_offset_ + 16, 8, ~uint64_t(0), std::move(generator));
+    case Field::IPV6_DST:
+        require(ipv6, "Template has no IPv6 header");
+        return add_slot(key, ip_offset_ + 32, 8, ~uint64_t(0), std::move(generator));
+    case Field::SRC_PORT:
+        require(ports_offset_ != NONE, "Template has no TCP or UDP header");
+        return add_slot(key, ports_offset_, 2, 0xFFFF, std::move(generator));
+    case Field::DST_PORT:
+        require(ports_offset_ != NONE, "Template has no TCP or UDP header");
+        return add_slot(key, ports_offset_ + 2, 2, 0xFFFF, std::move(generator));
+    case Field::IP_ID:
+        require(ipv4, "Template has no IPv4 header");
+        return add_slot(key, ip_offset_ + 4, 2, 0xFFFF, std::move(generator));
+    case Field::TCP_SEQ:
+        require(tcp_offset_ != NONE, "Template has no TCP header");
+        return add_slot(key, tcp_offset_ + 4, 4, 0xFFFFFFFF, std::move(generator));
+    case Field::VLAN_ID:
+        require(vlan_offset_ != NONE, "Template has no VLAN tag");
+        return add_slot(key, vlan_offset_, 2, 0x0FFF, std::move(generator));
+    }
+    throw std::invalid_argument("Unknown template field");
+}
+
+PacketTemplate& PacketTemplate::set_payload(size_t offset, size_t width, FieldGenerator generator) {
+    require(width >= 1 && width <= 8, "Payload field width must be 1 to 8 bytes");
+    require(payload_offset_ + offset + width <= length_, "Payload field beyond the payload");
+    return add_slot(-1, payload_offset_ + offset, width, width == 8 ? ~uint64_t(0) : (uint64_t(1) << (8 * width)) - 1,
+                    std::move(generator));
+}
+
+PacketTemplate& PacketTemplate::add_slot(int key, size_t offset, size_t width, uint64_t mask,
+                                         FieldGenerator generator) {
+    if (key >= 0) {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].key == key) {
+                slots_.erase(slots_.begin() + static_cast<std::ptrdiff_t>(i));
+                break;
+            }
+        }
+    }
+    for (const Slot& slot : slots_) {
+        require(offset + width <= slot.offset || slot.offset + slot.width <= offset, "Template fields overlap");
+    }
+
+    // Checksums covering any 16-bit word the field touches
+    size_t first_word = offset & ~size_t(1);
+    size_t last_word = (offset + width + 1) & ~size_t(1);
+    uint32_t covers = 0;
+    for (size_t i = 0; i < checksums_.size(); ++i) {
+        const Checksum& sum = checksums_[i];
+        bool in_data = first_word < sum.end && sum.begin < last_word;
+        bool in_pseudo = first_word < sum.pseudo_end && sum.pseudo_begin < last_word;
+        if (in_data || in_pseudo) {
+            covers |= 1u << i;
+        }
+    }
+
+    uint64_t original = load_value(frame_.data() + offset, width);
+    bool swapped = ((offset + width) & 1) != 0;
+    slots_.push_back({key, std::move(generator), offset, width, mask, original,
+                      static_cast<uint16_t>(~value_sum(original, swapped)), swapped, covers});
+    return *this;
+}
+
+void PacketTemplate::stamp(uint8_t* out) {
+    std::memcpy(out, frame_.data(), frame_.size());
+
+    // Running RFC 1624 sums, one per checksum (at most one per layer)
+    uint32_t sums[PacketBuilder::MAX_LAYERS];
+    for (size_t i = 0; i < checksums_.size(); ++i) {
+        sums[i] = checksums_[i].initial;
+    }
+    for (Slot& slot : slots_) {
+        uint64_t value = (slot.original & ~slot.mask) | (slot.generator.next() & slot.mask);
+        store_value(out + slot.offset, value, slot.width);
+        uint32_t delta = static_cast<uint32_t>(value_sum(value, slot.swapped)) + slot.removed;
+        for (uint32_t bits = slot.covers; bits != 0; bits &= bits - 1) {
+            sums[detail::ctz32(bits)] += delta;
+        }
+    }
+    // Innermost first, so a changed inner checksum feeds the outer ones
+    for (size_t i = checksums_.size(); i-- > 0;) {
+        const Checksum& sum = checksums_[i];
+        uint16_t value = checksum::finish(sums[i]);
+        if (sum.udp && value == 0) {
+            value = 0xFFFF;
+        }
+        store_value(out + sum.offset, value, 2);
+        uint32_t delta = static_cast<uint32_t>(value) + sum.initial;
+        for (uint32_t bits = sum.covered_by; bits != 0; bits &= bits - 1) {
+            sums[detail::ctz32(bits)] += delta;
+        }
+    }
+
+    if (fcs_) {
+        size_t padded = frame_.size() - EthernetHeader::FCS_SIZE;
+        uint32_t fcs = crc::ethernet_fcs(out, padded);
+        for (size_t i = 0; i < EthernetHeader::FCS_SIZE; ++i) {
+            out[padded + i] = static_cast<uint8_t>(fcs >> (8 * i));
+        }
+    }
+}
+
+void PacketTemplate::stamp_into(std::vector<uint8_t>& out) {
+    out.resize(frame_.size());
+    stamp(out.data());
+}
+
+size_t PacketTemplate::stamp_batch(MutableByteSpan out, size_t count, size_t stride) {
+    if (stride == 0) {
+        stride = frame_.size();
+    }
+    require(stride >= frame_.size(), "Stride shorter than the packet");
+    if (count > 0 && out.size() < (count - 1) * stride + frame_.size()) {
+        throw std::length_error("Buffer too small for batch");
+    }
+    for (size_t i = 0; i < count; ++i) {
+        stamp(out.data() + i * stride);
+    }
+    return count;
+}
+
+} // namespace cppscapy
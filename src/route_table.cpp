@@ -0,0 +1,220 @@
+#include "../include/route_table.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace cppscapy {
+
+namespace detail {
+
+namespace {
+    // Parent "group" id standing for the root array
+    constexpr uint32_t ROOT = 0xFFFFFFFF;
+}
+
+template <typename Key, unsigned KeyBits, unsigned FirstStride>
+MultibitTrie<Key, KeyBits, FirstStride>::MultibitTrie(size_t max_groups)
+    : root_(size_t(1) << FirstStride, 0),
+      max_groups_(max_groups < size_t(INDEX_MASK) + 1 ? max_groups : size_t(INDEX_MASK) + 1),
+      rules_(KeyBits + 1) {}
+
+template <typename Key, unsigned KeyBits, unsigned FirstStride>
+uint32_t MultibitTrie<Key, KeyBits, FirstStride>::make_entry(unsigned length, uint32_t value) {
+    auto it = value_index_.find(value);
+    uint32_t index;
+    if (it != value_index_.end()) {
+        index = it->second;
+    } else {
+        if (values_.size() > INDEX_MASK) {
+            throw std::length_error("Too many distinct route values");
+        }
+        index = static_cast<uint32_t>(values_.size());
+        values_.push_back(value);
+        value_index_.emplace(value, index);
+    }
+    return ((length + 1) << DEPTH_SHIFT) | index;
+}
+
+template <typename Key, unsigned KeyBits, unsigned FirstStride>
+uint32_t* MultibitTrie<Key, KeyBits, FirstStride>::slot_at(uint32_t parent_group, size_t index) {
+    return parent_group == ROOT ? &root_[index] : &groups_[slot(parent_group, static_cast<unsigned>(index))];
+}
+
+template <typename Key, unsigned KeyBits, unsigned FirstStride>
+bool MultibitTrie<Key, KeyBits, FirstStride>::allocate_group(uint32_t fill, uint32_t& group) {
+    if (!free_groups_.empty()) {
+        group = free_groups_.back();
+        free_groups_.pop_back();
+    } else if (groups_.size() / GROUP_SIZE < max_groups_) {
+        group = static_cast<uint32_t>(groups_.size() / GROUP_SIZE);
+        groups_.resize(groups_.size() + GROUP_SIZE);
+    } else {
+        return false;
+    }
+    std::fill(groups_.begin() + slot(group, 0), groups_.begin() + slot(group + 1, 0), fill);
+    ++group_count_;
+    return true;
+}
+
+// Inserting: replace every slot owned by an equal or shorter prefix
+template <typename Key, unsigned KeyBits, unsigned FirstStride>
+void MultibitTrie<Key, KeyBits, FirstStride>::overwrite(uint32_t* entry, uint32_t replacement,
+                                                        unsigned length) {
+    if (*entry & EXTENDED) {
+        uint32_t group = *entry & INDEX_MASK;
+        for (unsigned i = 0; i < GROUP_SIZE; ++i) {
+            overwrite(&groups_[slot(group, i)], replacement, length);
+        }
+    } else if (depth(*entry) <= length + 1) {
+        *entry = replacement;
+    }
+}
+
+// Erasing: hand the slots owned by the prefix back to its parent route
+template <typename Key, unsigned KeyBits, unsigned FirstStride>
+void MultibitTrie<Key, KeyBits, FirstStride>::restore(uint32_t* entry, uint32_t replacement,
+                                                      unsigned length, unsigned level_end) {
+    if (*entry & EXTENDED) {
+        uint32_t group = *entry & INDEX_MASK;
+        for (unsigned i = 0; i < GROUP_SIZE; ++i) {
+            restore(&groups_[slot(group, i)], replacement, length, level_end + 8);
+        }
+        fold(entry, level_end);
+    } else if (depth(*entry) == length + 1) {
+        *entry = replacement;
+    }
+}
+
+// Replaces a group whose 256 slots hold the same route by that route. Only
+// routes that fit the parent slot's level qualify: a group made uniform by
+// two sibling prefixes must stay, since erase() walks down to their level.
+template <typename Key, unsigned KeyBits, unsigned FirstStride>
+bool MultibitTrie<Key, KeyBits, FirstStride>::fold(uint32_t* entry, unsigned level_end) {
+    uint32_t group = *entry & INDEX_MASK;
+    uint32_t first = groups_[slot(group, 0)];
+    if ((first & EXTENDED) || depth(first) > level_end + 1) {
+        return false;
+    }
+    for (unsigned i = 1; i < GROUP_SIZE; ++i) {
+        if (groups_[slot(group, i)] != first) {
+            return false;
+        }
+    }
+    free_groups_.push_back(group);
+    --group_count_;
+    *entry = first;
+    return true;
+}
+
+template <typename Key, unsigned KeyBits, unsigned FirstStride>
+bool MultibitTrie<Key, KeyBits, FirstStride>::insert(Key key, unsigned length, uint32_t value) {
+    if (length > KeyBits) {
+        throw std::invalid_argument("Prefix length out of range");
+    }
+    key &= mask(length);
+
+    // Walk down to the level holding the prefix, creating groups on the way;
+    // a new group starts as 256 copies of the slot it replaces
+    uint32_t group = ROOT;
+    size_t index = static_cast<size_t>(key >> (KeyBits - FirstStride));
+    unsigned level_end = FirstStride;
+    while (length > level_end) {
+        uint32_t current = *slot_at(group, index);
+        if (!(current & EXTENDED)) {
+            uint32_t child;
+            if (!allocate_group(current, child)) {
+                return false;
+            }
+            current = EXTENDED | child;
+            *slot_at(group, index) = current;
+        }
+        group = current & INDEX_MASK;
+        level_end += 8;
+        index = static_cast<size_t>(key >> (KeyBits - level_end)) & 0xFF;
+    }
+
+    // The value is interned only now, so a failed insert leaves none behind
+    uint32_t entry = make_entry(length, value);
+    size_t count = size_t(1) << (level_end - length);
+    for (size_t i = 0; i < count; ++i) {
+        overwrite(slot_at(group, index + i), entry, length);
+    }
+    if (rules_[length].insert_or_assign(key, value).second) {
+        ++prefix_count_;
+    }
+    return true;
+}
+
+template <typename Key, unsigned KeyBits, unsigned FirstStride>
+bool MultibitTrie<Key, KeyBits, FirstStride>::erase(Key key, unsigned length) {
+    if (length > KeyBits) {
+        return false;
+    }
+    key &= mask(length);
+    if (rules_[length].erase(key) == 0) {
+        return false;
+    }
+    --prefix_count_;
+
+    // The slots go back to the longest shorter prefix covering this one
+    uint32_t replacement = 0;
+    for (unsigned shorter = length; shorter-- > 0;) {
+        auto it = rules_[shorter].find(key & mask(shorter));
+        if (it != rules_[shorter].end()) {
+            replacement = make_entry(shorter, it->second);
+            break;
+        }
+    }
+
+    struct Step {
+        uint32_t group;
+        size_t index;
+        unsigned level_end;
+    };
+    Step path[(KeyBits - FirstStride) / 8 + 1]{};
+    size_t steps = 0;
+
+    uint32_t group = ROOT;
+    size_t index = static_cast<size_t>(key >> (KeyBits - FirstStride));
+    unsigned level_end = FirstStride;
+    while (length > level_end) {
+        path[steps++] = {group, index, level_end};
+        group = *slot_at(group, index) & INDEX_MASK;
+        level_end += 8;
+        index = static_cast<size_t>(key >> (KeyBits - level_end)) & 0xFF;
+    }
+
+    size_t count = size_t(1) << (level_end - length);
+    for (size_t i = 0; i < count; ++i) {
+        restore(slot_at(group, index + i), replacement, length, level_end);
+    }
+
+    // Fold groups on the path that became uniform, deepest first
+    while (steps > 0) {
+        const Step& step = path[--steps];
+        uint32_t* parent = slot_at(step.group, step.index);
+        if (!fold(parent, step.level_end)) {
+            break;
+        }
+    }
+    return true;
+}
+
+template <typename Key, unsigned KeyBits, unsigned FirstStride>
+size_t MultibitTrie<Key, KeyBits, FirstStride>::memory_usage() const {
+    size_t bytes = (root_.capacity() + groups_.capacity() + values_.capacity()) * sizeof(uint32_t);
+    for (const auto& rules : rules_) {
+        // Node estimate: key, value and two pointers of bucket bookkeeping
+        bytes += rules.size() * (sizeof(Key) + sizeof(uint32_t) + 2 * sizeof(void*)) +
+                 rules.bucket_count() * sizeof(void*);
+    }
+    bytes += value_index_.size() * (2 * sizeof(uint32_t) + 2 * sizeof(void*)) +
+             value_index_.bucket_count() * sizeof(void*);
+    return bytes;
+}
+
+template class MultibitTrie<uint32_t, 32, 24>;
+template class MultibitTrie<uint128, 128, 16>;
+
+} // namespace detail
+
+} // namespace cppscapy
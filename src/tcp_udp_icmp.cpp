@@ -1,166 +1,492 @@
 #include "../include/network_headers.h"
+#include "../include/checksum.h"
+#include "../include/crc.h"
+#include <algorithm>
 #include <cstring>
+#include <utility>
 
 namespace cppscapy {
 
+namespace {
+    constexpr size_t TCP_CHECKSUM_OFFSET = 16;
+    constexpr size_t UDP_CHECKSUM_OFFSET = 6;
+    constexpr size_t ICMP_CHECKSUM_OFFSET = 2;
+    
+    // Write a header image and its options with the checksum field set to
+    // the checksum of the pseudo-header sum, the image, the options and the
+    // payload (summed where it lives)
+    template <size_t N>
+    size_t write_checksummed(uint8_t* out, std::array<uint8_t, N> bytes, size_t checksum_offset,
+                             ByteSpan options, ByteSpan payload, uint16_t pseudo_sum,
+                             bool zero_is_ones = false) {
+        detail::store16(bytes, checksum_offset, 0);
+        uint16_t value = checksum::finish(checksum::partial({
+            {bytes.data(), N},
+            {options.data(), options.size()},
+            {payload.data(), payload.size()}
+        }, pseudo_sum));
+        if (zero_is_ones && value == 0) {
+            value = 0xFFFF;
+        }
+        detail::store16(bytes, checksum_offset, value);
+        detail::copy_out(out, bytes);
+        std::copy(options.begin(), options.end(), out + N);
+        return N + options.size();
+    }
+}
+
 // TCPHeader implementation
-TCPHeader::TCPHeader(uint16_t src_port, uint16_t dst_port) 
-    : src_port_(src_port), dst_port_(dst_port) {}
 
 std::vector<uint8_t> TCPHeader::to_bytes() const {
-    std::vector<uint8_t> result;
-    result.reserve(MIN_SIZE);
-    
-    // Source Port
-    result.push_back((src_port_ >> 8) & 0xFF);
-    result.push_back(src_port_ & 0xFF);
-    
-    // Destination Port
-    result.push_back((dst_port_ >> 8) & 0xFF);
-    result.push_back(dst_port_ & 0xFF);
-    
-    // Sequence Number
-    result.push_back((seq_num_ >> 24) & 0xFF);
-    result.push_back((seq_num_ >> 16) & 0xFF);
-    result.push_back((seq_num_ >> 8) & 0xFF);
-    result.push_back(seq_num_ & 0xFF);
-    
-    // Ack
-    result.push_back((ack_num_ >> 24) & 0xFF);
-    result.push_back((ack_num_ >> 16) & 0xFF);
-    result.push_back((ack_num_ >> 8) & 0xFF);
-    result.push_back(ack_num_ & 0xFF);
-    
-    // Data Offset and Flags
-    result.push_back((data_offset_ << 4) | 0); // Reserved bits are 0
-    result.push_back(flags_);
-    
-    // Window Size
-    result.push_back((window_size_ >> 8) & 0xFF);
-    result.push_back(window_size_ & 0xFF);
-    
-    // Checksum (placeholder)
-    result.push_back(0);
-    result.push_back(0);
-    
-    // Urgent Pointer
-    result.push_back((urgent_ptr_ >> 8) & 0xFF);
-    result.push_back(urgent_ptr_ & 0xFF);
-    
+    std::vector<uint8_t> bytes(wire_size());
+    write_to(bytes.data());
+    return bytes;
+}
+
+std::vector<uint8_t> TCPHeader::to_bytes(const IPv4Address& src_ip, const IPv4Address& dst_ip,
+                                         const std::vector<uint8_t>& payload) const {
+    std::vector<uint8_t> result(wire_size());
+    write_to(result.data(), src_ip, dst_ip, payload);
     return result;
 }
 
+std::vector<uint8_t> TCPHeader::to_bytes(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                                         const std::vector<uint8_t>& payload) const {
+    std::vector<uint8_t> result(wire_size());
+    write_to(result.data(), src_ip, dst_ip, payload);
+    return result;
+}
+
+size_t TCPHeader::write_to(uint8_t* out, const IPv4Address& src_ip, const IPv4Address& dst_ip,
+                           ByteSpan payload) const {
+    uint16_t pseudo_sum = detail::pseudo_header_sum(src_ip, dst_ip, IPv4Header::PROTOCOL_TCP,
+                                                    wire_size() + payload.size());
+    return write_checksummed(out, to_array(), TCP_CHECKSUM_OFFSET, ByteSpan(options_.data(), options_.size()),
+                             payload, pseudo_sum);
+}
+
+size_t TCPHeader::write_to(uint8_t* out, const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                           ByteSpan payload) const {
+    uint16_t pseudo_sum = detail::pseudo_header_sum(src_ip, dst_ip, IPv6Header::NEXT_HEADER_TCP,
+                                                    wire_size() + payload.size());
+    return write_checksummed(out, to_array(), TCP_CHECKSUM_OFFSET, ByteSpan(options_.data(), options_.size()),
+                             payload, pseudo_sum);
+}
+
+uint16_t TCPHeader::calculate_checksum(const IPv4Address& src_ip, const IPv4Address& dst_ip,
+                                      const std::vector<uint8_t>& payload) const {
+    uint8_t bytes[MAX_SIZE];
+    write_to(bytes, src_ip, dst_ip, payload);
+    return detail::load16(bytes + TCP_CHECKSUM_OFFSET);
+}
+
+uint16_t TCPHeader::calculate_checksum(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                                      const std::vector<uint8_t>& payload) const {
+    uint8_t bytes[MAX_SIZE];
+    write_to(bytes, src_ip, dst_ip, payload);
+    return detail::load16(bytes + TCP_CHECKSUM_OFFSET);
+}
+
+TCPHeader& TCPHeader::update_checksum(const IPv4Address& src_ip, const IPv4Address& dst_ip,
+                                     const std::vector<uint8_t>& payload) {
+    checksum_ = calculate_checksum(src_ip, dst_ip, payload);
+    return *this;
+}
+
+TCPHeader& TCPHeader::update_checksum(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                                     const std::vector<uint8_t>& payload) {
+    checksum_ = calculate_checksum(src_ip, dst_ip, payload);
+    return *this;
+}
+
 // UDPHeader implementation
-UDPHeader::UDPHeader(uint16_t src_port, uint16_t dst_port, uint16_t length) 
-    : src_port_(src_port), dst_port_(dst_port), length_(length) {}
 
 std::vector<uint8_t> UDPHeader::to_bytes() const {
-    std::vector<uint8_t> result;
-    result.reserve(SIZE);
-    
-    // Source Port
-    result.push_back((src_port_ >> 8) & 0xFF);
-    result.push_back(src_port_ & 0xFF);
-    
-    // Destination Port
-    result.push_back((dst_port_ >> 8) & 0xFF);
-    result.push_back(dst_port_ & 0xFF);
-    
-    // Length
-    result.push_back((length_ >> 8) & 0xFF);
-    result.push_back(length_ & 0xFF);
-    
-    // Checksum (placeholder)
-    result.push_back(0);
-    result.push_back(0);
-    
-    return result;
+    auto bytes = to_array();
+    return std::vector<uint8_t>(bytes.begin(), bytes.end());
+}
+
+// The length field and the pseudo-header use the same length, as in
+// calculate_checksum()
+size_t UDPHeader::write_to(uint8_t* out, const IPv4Address& src_ip, const IPv4Address& dst_ip,
+                           ByteSpan payload) const {
+    size_t udp_length = SIZE + payload.size();
+    if (udp_length > 0xFFFF) {
+        throw std::length_error("UDP datagram too large for IPv4");
+    }
+    uint16_t pseudo_sum = detail::pseudo_header_sum(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP, udp_length);
+    return write_checksummed(out, to_array(udp_length), UDP_CHECKSUM_OFFSET, {}, payload, pseudo_sum, true);
+}
+
+size_t UDPHeader::write_to(uint8_t* out, const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                           ByteSpan payload) const {
+    size_t udp_length = SIZE + payload.size();
+    uint16_t pseudo_sum = detail::pseudo_header_sum(src_ip, dst_ip, IPv6Header::NEXT_HEADER_UDP, udp_length);
+    return write_checksummed(out, to_array(udp_length), UDP_CHECKSUM_OFFSET, {}, payload, pseudo_sum, true);
 }
 
 // ICMPHeader implementation
-ICMPHeader::ICMPHeader(uint8_t type, uint8_t code) 
-    : type_(type), code_(code) {}
 
 std::vector<uint8_t> ICMPHeader::to_bytes() const {
-    std::vector<uint8_t> result;
-    result.reserve(MIN_SIZE);
-    
-    // Type
-    result.push_back(type_);
-    
-    // Code
-    result.push_back(code_);
-    
-    // Checksum (placeholder)
-    result.push_back(0);
-    result.push_back(0);
-    
-    // Identifier
-    result.push_back((identifier_ >> 8) & 0xFF);
-    result.push_back(identifier_ & 0xFF);
-    
-    // Sequence Number
-    result.push_back((sequence_ >> 8) & 0xFF);
-    result.push_back(sequence_ & 0xFF);
-    
+    auto bytes = to_array();
+    return std::vector<uint8_t>(bytes.begin(), bytes.end());
+}
+
+std::vector<uint8_t> ICMPHeader::to_bytes(const std::vector<uint8_t>& payload) const {
+    std::vector<uint8_t> result(wire_size());
+    write_to(result.data(), payload);
     return result;
 }
 
+std::vector<uint8_t> ICMPHeader::to_bytes(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                                          const std::vector<uint8_t>& payload) const {
+    std::vector<uint8_t> result(wire_size());
+    write_to(result.data(), src_ip, dst_ip, payload);
+    return result;
+}
+
+size_t ICMPHeader::write_to(uint8_t* out, ByteSpan payload) const {
+    return write_checksummed(out, to_array(), ICMP_CHECKSUM_OFFSET, {}, payload, 0);
+}
+
+size_t ICMPHeader::write_to(uint8_t* out, const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                            ByteSpan payload) const {
+    uint16_t pseudo_sum = detail::pseudo_header_sum(src_ip, dst_ip, IPv6Header::NEXT_HEADER_ICMPV6,
+                                                    wire_size() + payload.size());
+    return write_checksummed(out, to_array(), ICMP_CHECKSUM_OFFSET, {}, payload, pseudo_sum);
+}
+
+uint16_t ICMPHeader::calculate_checksum(const std::vector<uint8_t>& payload) const {
+    uint8_t bytes[MIN_SIZE];
+    write_to(bytes, payload);
+    return detail::load16(bytes + ICMP_CHECKSUM_OFFSET);
+}
+
+uint16_t ICMPHeader::calculate_checksum(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                                       const std::vector<uint8_t>& payload) const {
+    uint8_t bytes[MIN_SIZE];
+    write_to(bytes, src_ip, dst_ip, payload);
+    return detail::load16(bytes + ICMP_CHECKSUM_OFFSET);
+}
+
+ICMPHeader& ICMPHeader::update_checksum(const std::vector<uint8_t>& payload) {
+    checksum_ = calculate_checksum(payload);
+    return *this;
+}
+
+ICMPHeader& ICMPHeader::update_checksum(const IPv6Address& src_ip, const IPv6Address& dst_ip,
+                                       const std::vector<uint8_t>& payload) {
+    checksum_ = calculate_checksum(src_ip, dst_ip, payload);
+    return *this;
+}
+
 // PacketBuilder implementation
 PacketBuilder& PacketBuilder::ethernet(const EthernetHeader& eth) {
-    auto bytes = eth.to_bytes();
-    packet_.insert(packet_.end(), bytes.begin(), bytes.end());
+    add_layer(Layer::ETHERNET);
+    append_header(eth);
     return *this;
 }
 
 PacketBuilder& PacketBuilder::ipv4(const IPv4Header& ip) {
-    auto bytes = ip.to_bytes();
-    packet_.insert(packet_.end(), bytes.begin(), bytes.end());
+    add_layer(Layer::IPV4);
+    l4_offset_ = NONE;
+    l3_offset_ = packet_.size();
+    l3_ipv6_ = false;
+    append_header(ip);
     return *this;
 }
 
 PacketBuilder& PacketBuilder::ipv6(const IPv6Header& ip) {
-    auto bytes = ip.to_bytes();
-    packet_.insert(packet_.end(), bytes.begin(), bytes.end());
+    add_layer(Layer::IPV6);
+    l4_offset_ = NONE;
+    l3_offset_ = packet_.size();
+    l3_ipv6_ = true;
+    append_header(ip);
     return *this;
 }
 
 PacketBuilder& PacketBuilder::mpls(const MPLSHeader& mpls) {
-    auto bytes = mpls.to_bytes();
-    packet_.insert(packet_.end(), bytes.begin(), bytes.end());
+    add_layer(Layer::MPLS);
+    append_header(mpls);
     return *this;
 }
 
 PacketBuilder& PacketBuilder::tcp(const TCPHeader& tcp) {
-    auto bytes = tcp.to_bytes();
-    packet_.insert(packet_.end(), bytes.begin(), bytes.end());
+    add_layer(Layer::TCP);
+    begin_transport(IPv4Header::PROTOCOL_TCP, TCP_CHECKSUM_OFFSET, tcp.checksum() == 0);
+    append_header(tcp);
     return *this;
 }
 
 PacketBuilder& PacketBuilder::udp(const UDPHeader& udp) {
-    auto bytes = udp.to_bytes();
-    packet_.insert(packet_.end(), bytes.begin(), bytes.end());
+    add_layer(Layer::UDP);
+    begin_transport(IPv4Header::PROTOCOL_UDP, UDP_CHECKSUM_OFFSET, udp.checksum() == 0);
+    append_header(udp);
     return *this;
 }
 
 PacketBuilder& PacketBuilder::icmp(const ICMPHeader& icmp) {
-    auto bytes = icmp.to_bytes();
-    packet_.insert(packet_.end(), bytes.begin(), bytes.end());
+    add_layer(Layer::ICMP);
+    // ICMPv4 has no pseudo-header, so it can be completed without an IP header
+    uint8_t protocol = (l3_offset_ != NONE && l3_ipv6_) ? IPv6Header::NEXT_HEADER_ICMPV6
+                                                         : IPv4Header::PROTOCOL_ICMP;
+    begin_transport(protocol, ICMP_CHECKSUM_OFFSET, icmp.checksum() == 0);
+    append_header(icmp);
     return *this;
 }
 
 PacketBuilder& PacketBuilder::payload(const std::vector<uint8_t>& data) {
-    packet_.insert(packet_.end(), data.begin(), data.end());
+    append(data.data(), data.size());
     return *this;
 }
 
 PacketBuilder& PacketBuilder::payload(const std::string& data) {
-    packet_.insert(packet_.end(), data.begin(), data.end());
+    append(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    return *this;
+}
+
+PacketBuilder& PacketBuilder::payload(const uint8_t* data, size_t length) {
+    append(data, length);
     return *this;
 }
 
-std::vector<uint8_t> PacketBuilder::build() const {
-    return packet_;
+void PacketBuilder::add_layer(Layer type) {
+    if (layer_count_ < MAX_LAYERS) {
+        layers_[layer_count_] = {type, packet_.size()};
+    }
+    ++layer_count_;
+}
+
+void PacketBuilder::begin_transport(uint8_t protocol, size_t checksum_offset, bool pending) {
+    // Summed whenever it can be completed, so finalize() may still be
+    // enabled after the header was added
+    bool completable = l3_offset_ != NONE || protocol == IPv4Header::PROTOCOL_ICMP;
+    l4_offset_ = completable ? packet_.size() : NONE;
+    l4_checksum_offset_ = checksum_offset;
+    l4_protocol_ = protocol;
+    l4_sum_ = 0;
+    l4_pending_ = pending;
+}
+
+void PacketBuilder::append(const uint8_t* data, size_t length) {
+    if (l4_offset_ == NONE) {
+        packet_.insert(packet_.end(), data, data + length);
+        return;
+    }
+    
+    // Grow in cache-sized steps so the zero fill done by resize() is still
+    // in cache when the fused copy overwrites it
+    constexpr size_t CHUNK_SIZE = 16384;
+    packet_.reserve(packet_.size() + length);
+    while (length > 0) {
+        size_t chunk = std::min(length, CHUNK_SIZE);
+        size_t offset = packet_.size();
+        packet_.resize(offset + chunk);
+        
+        uint16_t sum = checksum::partial_copy(packet_.data() + offset, data, chunk);
+        if ((offset - l4_offset_) & 1) {
+            sum = checksum::swap_sum(sum);
+        }
+        l4_sum_ = checksum::fold(static_cast<uint32_t>(l4_sum_) + sum);
+        
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+PacketBuilder& PacketBuilder::fcs(bool enable) {
+    fcs_ = enable;
+    return *this;
+}
+
+PacketBuilder& PacketBuilder::finalize(bool enable) {
+    finalize_ = enable;
+    return *this;
+}
+
+std::vector<uint8_t> PacketBuilder::build() const & {
+    std::vector<uint8_t> result;
+    build_into(result);
+    return result;
+}
+
+std::vector<uint8_t> PacketBuilder::build() && {
+    size_t length = packet_.size();
+    packet_.resize(size());
+    finish(packet_.data(), length);
+    std::vector<uint8_t> result = std::move(packet_);
+    reset();
+    return result;
+}
+
+void PacketBuilder::build_into(std::vector<uint8_t>& out) const {
+    out.reserve(size());
+    out.assign(packet_.begin(), packet_.end());
+    out.resize(size());
+    finish(out.data(), packet_.size());
+}
+
+size_t PacketBuilder::build_into(MutableByteSpan out) const {
+    size_t length = size();
+    if (out.size() < length) {
+        throw std::length_error("Buffer too small for packet");
+    }
+    std::copy(packet_.begin(), packet_.end(), out.data());
+    finish(out.data(), packet_.size());
+    return length;
+}
+
+size_t PacketBuilder::size() const {
+    if (!fcs_) {
+        return packet_.size();
+    }
+    return std::max(packet_.size(), EthernetHeader::MIN_FRAME_SIZE) + EthernetHeader::FCS_SIZE;
+}
+
+PacketBuilder& PacketBuilder::reserve(size_t bytes) {
+    packet_.reserve(bytes);
+    return *this;
+}
+
+PacketBuilder& PacketBuilder::reset() {
+    std::vector<uint8_t> storage = std::move(packet_);
+    storage.clear();
+    *this = PacketBuilder();
+    packet_ = std::move(storage);
+    return *this;
+}
+
+void PacketBuilder::finish(uint8_t* frame, size_t length) const {
+    if (finalize_) {
+        finalize_layers(frame, length);
+    } else if (l4_offset_ != NONE && l4_pending_) {
+        complete_checksum(frame, length);
+    }
+    if (fcs_) {
+        // Runs last so it covers the completed transport checksum
+        size_t padded = std::max(length, EthernetHeader::MIN_FRAME_SIZE);
+        std::fill(frame + length, frame + padded, 0);
+        uint32_t fcs = crc::ethernet_fcs(frame, padded);
+        // Transmitted least significant byte first
+        for (size_t i = 0; i < EthernetHeader::FCS_SIZE; ++i) {
+            frame[padded + i] = static_cast<uint8_t>(fcs >> (8 * i));
+        }
+    }
+}
+
+void PacketBuilder::complete_checksum(uint8_t* frame, size_t length) const {
+    size_t l4_length = length - l4_offset_;
+    uint32_t sum = l4_sum_;
+    if (l4_protocol_ != IPv4Header::PROTOCOL_ICMP) {
+        const uint8_t* ip = frame + l3_offset_;
+        sum += l3_ipv6_
+            ? checksum::pseudo_header_ipv6(ip + 8, ip + 24, l4_protocol_, static_cast<uint32_t>(l4_length))
+            : checksum::pseudo_header_ipv4(ip + 12, ip + 16, l4_protocol_, static_cast<uint16_t>(l4_length));
+    }
+    
+    uint16_t value = checksum::finish(sum);
+    if (l4_protocol_ == IPv4Header::PROTOCOL_UDP && value == 0) {
+        value = 0xFFFF;
+    }
+    detail::store16(frame + l4_offset_ + l4_checksum_offset_, value);
+}
+
+void PacketBuilder::finalize_layers(uint8_t* frame, size_t length) const {
+    if (layer_count_ > MAX_LAYERS) {
+        throw std::length_error("Too many layers to finalize");
+    }
+    
+    // Innermost first: every layer runs to the end of the packet, so an outer
+    // checksum has to cover the inner headers as they are finally sent
+    for (size_t i = layer_count_; i-- > 0;) {
+        uint8_t* header = frame + layers_[i].offset;
+        size_t extent = length - layers_[i].offset;
+        switch (layers_[i].type) {
+        case Layer::IPV4: {
+            // IPv4Header always serializes a valid checksum, so it only needs
+            // adjusting for the new total length
+            uint16_t total_length = static_cast<uint16_t>(extent);
+            detail::store16(header + 10,
+                            checksum::adjust(detail::load16(header + 10), detail::load16(header + 2), total_length));
+            detail::store16(header + 2, total_length);
+            break;
+        }
+        case Layer::IPV6:
+            detail::store16(header + 4, static_cast<uint16_t>(extent - IPv6Header::SIZE));
+            break;
+        case Layer::MPLS: {
+            bool bottom = i + 1 == layer_count_ || layers_[i + 1].type != Layer::MPLS;
+            header[2] = static_cast<uint8_t>((header[2] & 0xFE) | (bottom ? 1 : 0));
+            break;
+        }
+        case Layer::TCP:
+        case Layer::UDP:
+        case Layer::ICMP:
+            finalize_transport(frame, length, i);
+            break;
+        case Layer::ETHERNET:
+            break;
+        }
+    }
+}
+
+void PacketBuilder::finalize_transport(uint8_t* frame, size_t length, size_t index) const {
+    const LayerRecord& layer = layers_[index];
+    uint8_t* header = frame + layer.offset;
+    size_t extent = length - layer.offset;
+    
+    const LayerRecord* ip = nullptr;
+    for (size_t i = index; i-- > 0;) {
+        if (layers_[i].type == Layer::IPV4 || layers_[i].type == Layer::IPV6) {
+            ip = &layers_[i];
+            break;
+        }
+    }
+    bool ipv6 = ip && ip->type == Layer::IPV6;
+    
+    uint8_t protocol = IPv4Header::PROTOCOL_TCP;
+    size_t checksum_offset = TCP_CHECKSUM_OFFSET;
+    if (layer.type == Layer::UDP) {
+        protocol = IPv4Header::PROTOCOL_UDP;
+        checksum_offset = UDP_CHECKSUM_OFFSET;
+    } else if (layer.type == Layer::ICMP) {
+        protocol = ipv6 ? IPv6Header::NEXT_HEADER_ICMPV6 : IPv4Header::PROTOCOL_ICMP;
+        checksum_offset = ICMP_CHECKSUM_OFFSET;
+    }
+    
+    uint16_t old_length = 0;
+    if (layer.type == Layer::UDP) {
+        old_length = detail::load16(header + 4);
+        detail::store16(header + 4, static_cast<uint16_t>(extent));
+    }
+    if (!ip && protocol != IPv4Header::PROTOCOL_ICMP) {
+        return;  // no addresses for the pseudo-header
+    }
+    
+    uint32_t sum;
+    if (layer.offset == l4_offset_ && index + 1 == layer_count_) {
+        // The sum taken while copying in, less the fields rewritten here
+        sum = l4_sum_ + static_cast<uint16_t>(~detail::load16(header + checksum_offset));
+        if (layer.type == Layer::UDP) {
+            sum += static_cast<uint16_t>(~old_length) + static_cast<uint16_t>(extent);
+        }
+        detail::store16(header + checksum_offset, 0);
+    } else {
+        detail::store16(header + checksum_offset, 0);
+        sum = checksum::partial(header, extent);
+    }
+    if (protocol != IPv4Header::PROTOCOL_ICMP) {
+        const uint8_t* addresses = frame + ip->offset;
+        sum += ipv6
+            ? checksum::pseudo_header_ipv6(addresses + 8, addresses + 24, protocol, static_cast<uint32_t>(extent))
+            : checksum::pseudo_header_ipv4(addresses + 12, addresses + 16, protocol, static_cast<uint16_t>(extent));
+    }
+    
+    uint16_t value = checksum::finish(sum);
+    if (protocol == IPv4Header::PROTOCOL_UDP && value == 0) {
+        value = 0xFFFF;
+    }
+    detail::store16(header + checksum_offset, value);
 }
 
 // Utility patterns implementation
@@ -170,44 +496,30 @@ std::vector<uint8_t> ipv4_packet(
     const IPv4Address& src, const IPv4Address& dst, 
     uint8_t protocol, const std::vector<uint8_t>& payload) {
     
-    IPv4Header ip(src, dst, protocol);
-    ip.length(IPv4Header::MIN_SIZE + payload.size());
-    
     PacketBuilder builder;
-    builder.ipv4(ip).payload(payload);
+    builder.reserve(IPv4Header::MIN_SIZE + payload.size())
+           .ipv4(IPv4Header(src, dst, protocol)).payload(payload).finalize();
     
-    return builder.build();
+    return std::move(builder).build();
 }
 
 std::vector<uint8_t> ipv6_packet(
     const IPv6Address& src, const IPv6Address& dst, 
     uint8_t next_header, const std::vector<uint8_t>& payload) {
     
-    IPv6Header ip(src, dst, next_header);
-    ip.payload_length(payload.size());
-    
     PacketBuilder builder;
-    builder.ipv6(ip).payload(payload);
+    builder.reserve(IPv6Header::SIZE + payload.size())
+           .ipv6(IPv6Header(src, dst, next_header)).payload(payload).finalize();
     
-    return builder.build();
+    return std::move(builder).build();
 }
 
 std::vector<uint8_t> tcp_syn(
     const IPv4Address& src_ip, const IPv4Address& dst_ip,
     uint16_t src_port, uint16_t dst_port, uint32_t seq_num) {
     
-    TCPHeader tcp(src_port, dst_port);
-    tcp.seq_num(seq_num).flags(TCPHeader::FLAG_SYN);
-    
-    auto tcp_bytes = tcp.to_bytes();
-    
-    IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_TCP);
-    ip.length(IPv4Header::MIN_SIZE + tcp_bytes.size());
-    
-    PacketBuilder builder;
-    builder.ipv4(ip).tcp(tcp);
-    
-    return builder.build();
+    auto packet = tcp_syn_array(src_ip, dst_ip, src_port, dst_port, seq_num);
+    return std::vector<uint8_t>(packet.begin(), packet.end());
 }
 
 std::vector<uint8_t> udp_packet(
@@ -215,35 +527,20 @@ std::vector<uint8_t> udp_packet(
     uint16_t src_port, uint16_t dst_port, 
     const std::vector<uint8_t>& payload) {
     
-    UDPHeader udp(src_port, dst_port, UDPHeader::SIZE + payload.size());
-    
-    auto udp_bytes = udp.to_bytes();
-    
-    IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP);
-    ip.length(IPv4Header::MIN_SIZE + udp_bytes.size() + payload.size());
-    
     PacketBuilder builder;
-    builder.ipv4(ip).udp(udp).payload(payload);
+    builder.reserve(IPv4Header::MIN_SIZE + UDPHeader::SIZE + payload.size())
+           .ipv4(IPv4Header(src_ip, dst_ip, IPv4Header::PROTOCOL_UDP))
+           .udp(UDPHeader(src_port, dst_port)).payload(payload).finalize();
     
-    return builder.build();
+    return std::move(builder).build();
 }
 
 std::vector<uint8_t> icmp_ping(
     const IPv4Address& src_ip, const IPv4Address& dst_ip,
     uint16_t identifier, uint16_t sequence) {
     
-    ICMPHeader icmp(ICMPHeader::TYPE_ECHO_REQUEST, 0);
-    icmp.identifier(identifier).sequence(sequence);
-    
-    auto icmp_bytes = icmp.to_bytes();
-    
-    IPv4Header ip(src_ip, dst_ip, IPv4Header::PROTOCOL_ICMP);
-    ip.length(IPv4Header::MIN_SIZE + icmp_bytes.size());
-    
-    PacketBuilder builder;
-    builder.ipv4(ip).icmp(icmp);
-    
-    return builder.build();
+    auto packet = icmp_ping_array(src_ip, dst_ip, identifier, sequence);
+    return std::vector<uint8_t>(packet.begin(), packet.end());
 }
 
 std::vector<uint8_t> ethernet_frame(
@@ -253,9 +550,9 @@ std::vector<uint8_t> ethernet_frame(
     EthernetHeader eth(dst_mac, src_mac, ethertype);
     
     PacketBuilder builder;
-    builder.ethernet(eth).payload(payload);
+    builder.reserve(EthernetHeader::SIZE + payload.size()).ethernet(eth).payload(payload);
     
-    return builder.build();
+    return std::move(builder).build();
 }
 
 std::vector<uint8_t> mpls_packet(
@@ -265,9 +562,9 @@ std::vector<uint8_t> mpls_packet(
     MPLSHeader mpls(label, tc, true, ttl);
     
     PacketBuilder builder;
-    builder.mpls(mpls).payload(payload);
+    builder.reserve(MPLSHeader::SIZE + payload.size()).mpls(mpls).payload(payload);
     
-    return builder.build();
+    return std::move(builder).build();
 }
 
 std::vector<uint8_t> mpls_ethernet_frame(
@@ -279,9 +576,10 @@ std::vector<uint8_t> mpls_ethernet_frame(
     MPLSHeader mpls(label, tc, true, ttl);
     
     PacketBuilder builder;
-    builder.ethernet(eth).mpls(mpls).payload(payload);
+    builder.reserve(EthernetHeader::SIZE + MPLSHeader::SIZE + payload.size())
+           .ethernet(eth).mpls(mpls).payload(payload);
     
-    return builder.build();
+    return std::move(builder).build();
 }
 
 } // namespace patterns
@@ -1,94 +1,35 @@
 #include "network_headers.h"
+#include "checksum.h"
 #include <algorithm>
 #include <numeric>
 
 namespace cppscapy {
 
 namespace {
-    // Helper function to calculate 16-bit checksum using one's complement
-    uint16_t calculate_checksum_16(const std::vector<uint8_t>& data) {
-        uint32_t sum = 0;
-        
-        // Sum all 16-bit words
-        for (size_t i = 0; i < data.size(); i += 2) {
-            if (i + 1 < data.size()) {
-                // Network byte order (big-endian)
-                uint16_t word = (static_cast<uint16_t>(data[i]) << 8) | data[i + 1];
-                sum += word;
-            } else {
-                // Odd byte - pad with zero
-                uint16_t word = static_cast<uint16_t>(data[i]) << 8;
-                sum += word;
-            }
-        }
-        
-        // Add carry bits
-        while (sum >> 16) {
-            sum = (sum & 0xFFFF) + (sum >> 16);
-        }
-        
-        // One's complement
-        return static_cast<uint16_t>(~sum);
-    }
-    
-    // Create IPv4 pseudo-header for UDP checksum
-    std::vector<uint8_t> create_ipv4_pseudo_header(const IPv4Address& src_ip, 
-                                                   const IPv4Address& dst_ip, 
-                                                   uint16_t udp_length) {
-        std::vector<uint8_t> pseudo_header;
-        pseudo_header.reserve(12);
-        
-        // Source IP (4 bytes)
-        auto src_bytes = src_ip.to_bytes();
-        pseudo_header.insert(pseudo_header.end(), src_bytes.begin(), src_bytes.end());
-        
-        // Destination IP (4 bytes)
-        auto dst_bytes = dst_ip.to_bytes();
-        pseudo_header.insert(pseudo_header.end(), dst_bytes.begin(), dst_bytes.end());
-        
-        // Zero byte
-        pseudo_header.push_back(0);
-        
-        // Protocol (UDP = 17)
-        pseudo_header.push_back(17);
-        
-        // UDP length (2 bytes, network byte order)
-        pseudo_header.push_back((udp_length >> 8) & 0xFF);
-        pseudo_header.push_back(udp_length & 0xFF);
-        
-        return pseudo_header;
+    constexpr uint8_t UDP_PROTOCOL = 17;
+    
+    // UDP header with the checksum field set to zero, on the stack
+    std::array<uint8_t, UDPHeader::SIZE> udp_header_bytes(uint16_t src_port, uint16_t dst_port,
+                                                          uint16_t udp_length) {
+        return {
+            static_cast<uint8_t>((src_port >> 8) & 0xFF), static_cast<uint8_t>(src_port & 0xFF),
+            static_cast<uint8_t>((dst_port >> 8) & 0xFF), static_cast<uint8_t>(dst_port & 0xFF),
+            static_cast<uint8_t>((udp_length >> 8) & 0xFF), static_cast<uint8_t>(udp_length & 0xFF),
+            0, 0 // Checksum = 0 for calculation
+        };
     }
     
-    // Create IPv6 pseudo-header for UDP checksum
-    std::vector<uint8_t> create_ipv6_pseudo_header(const IPv6Address& src_ip, 
-                                                   const IPv6Address& dst_ip, 
-                                                   uint16_t udp_length) {
-        std::vector<uint8_t> pseudo_header;
-        pseudo_header.reserve(40);
-        
-        // Source IP (16 bytes)
-        auto src_bytes = src_ip.to_bytes();
-        pseudo_header.insert(pseudo_header.end(), src_bytes.begin(), src_bytes.end());
-        
-        // Destination IP (16 bytes)
-        auto dst_bytes = dst_ip.to_bytes();
-        pseudo_header.insert(pseudo_header.end(), dst_bytes.begin(), dst_bytes.end());
-        
-        // UDP length (4 bytes, network byte order, upper 2 bytes are zero)
-        pseudo_header.push_back(0);
-        pseudo_header.push_back(0);
-        pseudo_header.push_back((udp_length >> 8) & 0xFF);
-        pseudo_header.push_back(udp_length & 0xFF);
+    // Sum UDP header + payload where they live, on top of a pseudo-header sum
+    uint16_t udp_checksum(uint16_t pseudo_sum, const std::array<uint8_t, UDPHeader::SIZE>& header,
+                          const std::vector<uint8_t>& payload) {
+        uint16_t checksum = checksum::finish(checksum::partial({
+            {header.data(), header.size()},
+            {payload.data(), payload.size()}
+        }, pseudo_sum));
         
-        // Zeros (3 bytes)
-        pseudo_header.push_back(0);
-        pseudo_header.push_back(0);
-        pseudo_header.push_back(0);
-        
-        // Next Header (UDP = 17)
-        pseudo_header.push_back(17);
-        
-        return pseudo_header;
+        // Special case: if checksum is 0, use 0xFFFF (all 1s)
+        // This is because UDP uses 0 to indicate "no checksum computed"
+        return (checksum == 0) ? 0xFFFF : checksum;
     }
 }
 
@@ -97,77 +38,30 @@ uint16_t UDPHeader::calculate_checksum(const IPv4Address& src_ip, const IPv4Addr
     // Calculate total UDP length (header + payload)
     uint16_t udp_length = static_cast<uint16_t>(SIZE + payload.size());
     
-    // Create pseudo-header
-    auto pseudo_header = create_ipv4_pseudo_header(src_ip, dst_ip, udp_length);
-    
-    // Create UDP header with checksum field set to zero
-    std::vector<uint8_t> udp_data;
-    udp_data.reserve(SIZE + payload.size());
-    
-    // UDP header (with checksum = 0)
-    udp_data.push_back((src_port_ >> 8) & 0xFF);
-    udp_data.push_back(src_port_ & 0xFF);
-    udp_data.push_back((dst_port_ >> 8) & 0xFF);
-    udp_data.push_back(dst_port_ & 0xFF);
-    udp_data.push_back((udp_length >> 8) & 0xFF);
-    udp_data.push_back(udp_length & 0xFF);
-    udp_data.push_back(0); // Checksum = 0 for calculation
-    udp_data.push_back(0);
-    
-    // Add payload
-    udp_data.insert(udp_data.end(), payload.begin(), payload.end());
-    
-    // Combine pseudo-header + UDP header + payload
-    std::vector<uint8_t> checksum_data;
-    checksum_data.reserve(pseudo_header.size() + udp_data.size());
-    checksum_data.insert(checksum_data.end(), pseudo_header.begin(), pseudo_header.end());
-    checksum_data.insert(checksum_data.end(), udp_data.begin(), udp_data.end());
-    
-    // Calculate checksum
-    uint16_t checksum = calculate_checksum_16(checksum_data);
+    // Pseudo-header is summed arithmetically, nothing is concatenated
+    auto src_bytes = src_ip.to_bytes();
+    auto dst_bytes = dst_ip.to_bytes();
+    uint16_t pseudo_sum = checksum::pseudo_header_ipv4(src_bytes.data(), dst_bytes.data(),
+                                                       UDP_PROTOCOL, udp_length);
     
-    // Special case: if checksum is 0, use 0xFFFF (all 1s)
-    // This is because UDP uses 0 to indicate "no checksum computed"
-    return (checksum == 0) ? 0xFFFF : checksum;
+    return udp_checksum(pseudo_sum, udp_header_bytes(src_port_, dst_port_, udp_length), payload);
 }
 
 uint16_t UDPHeader::calculate_checksum(const IPv6Address& src_ip, const IPv6Address& dst_ip, 
                                       const std::vector<uint8_t>& payload) const {
-    // Calculate total UDP length (header + payload)
-    uint16_t udp_length = static_cast<uint16_t>(SIZE + payload.size());
-    
-    // Create pseudo-header
-    auto pseudo_header = create_ipv6_pseudo_header(src_ip, dst_ip, udp_length);
-    
-    // Create UDP header with checksum field set to zero
-    std::vector<uint8_t> udp_data;
-    udp_data.reserve(SIZE + payload.size());
-    
-    // UDP header (with checksum = 0)
-    udp_data.push_back((src_port_ >> 8) & 0xFF);
-    udp_data.push_back(src_port_ & 0xFF);
-    udp_data.push_back((dst_port_ >> 8) & 0xFF);
-    udp_data.push_back(dst_port_ & 0xFF);
-    udp_data.push_back((udp_length >> 8) & 0xFF);
-    udp_data.push_back(udp_length & 0xFF);
-    udp_data.push_back(0); // Checksum = 0 for calculation
-    udp_data.push_back(0);
-    
-    // Add payload
-    udp_data.insert(udp_data.end(), payload.begin(), payload.end());
-    
-    // Combine pseudo-header + UDP header + payload
-    std::vector<uint8_t> checksum_data;
-    checksum_data.reserve(pseudo_header.size() + udp_data.size());
-    checksum_data.insert(checksum_data.end(), pseudo_header.begin(), pseudo_header.end());
-    checksum_data.insert(checksum_data.end(), udp_data.begin(), udp_data.end());
+    // Calculate total UDP length (header + payload). Jumbograms (RFC 2675)
+    // carry 0 in the length field and the real length in the pseudo-header.
+    uint32_t udp_length = static_cast<uint32_t>(SIZE + payload.size());
+    uint16_t length_field = (udp_length > 0xFFFF) ? 0 : static_cast<uint16_t>(udp_length);
     
-    // Calculate checksum
-    uint16_t checksum = calculate_checksum_16(checksum_data);
+    auto src_bytes = src_ip.to_bytes();
+    auto dst_bytes = dst_ip.to_bytes();
+    uint16_t pseudo_sum = checksum::pseudo_header_ipv6(src_bytes.data(), dst_bytes.data(),
+                                                       UDP_PROTOCOL, udp_length);
     
     // Note: For IPv6 UDP, checksum is mandatory and cannot be 0
-    // If calculated checksum is 0, use 0xFFFF
-    return (checksum == 0) ? 0xFFFF : checksum;
+    // udp_checksum() maps a computed 0 to 0xFFFF
+    return udp_checksum(pseudo_sum, udp_header_bytes(src_port_, dst_port_, length_field), payload);
 }
 
 UDPHeader& UDPHeader::update_checksum(const IPv4Address& src_ip, const IPv4Address& dst_ip, 
@@ -1,4 +1,5 @@
 #include "../include/utils.h"
+#include "../include/checksum.h"
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
@@ -97,24 +98,7 @@ std::vector<uint8_t> from_hex_string(const std::string& hex_str) {
 
 // Calculate IP checksum
 uint16_t calculate_ip_checksum(const std::vector<uint8_t>& header) {
-    uint32_t sum = 0;
-    
-    // Sum all 16-bit words
-    for (size_t i = 0; i < header.size() - 1; i += 2) {
-        sum += (header[i] << 8) + header[i + 1];
-    }
-    
-    // Add odd byte if present
-    if (header.size() % 2 == 1) {
-        sum += header[header.size() - 1] << 8;
-    }
-    
-    // Fold 32-bit sum to 16 bits
-    while (sum >> 16) {
-        sum = (sum & 0xFFFF) + (sum >> 16);
-    }
-    
-    return ~sum;
+    return checksum::compute(header);
 }
 
 // Calculate IPv4 header checksum (automatically clears checksum field)
@@ -141,41 +125,24 @@ uint16_t calculate_ipv4_header_checksum(const std::vector<uint8_t>& header) {
     return calculate_ip_checksum(header_copy);
 }
 
-// Calculate TCP checksum (simplified - doesn't include pseudo-header)
+// Calculate TCP checksum over the IPv4 pseudo-header, header and payload
 uint16_t calculate_tcp_checksum(const std::vector<uint8_t>& tcp_header, 
                                const IPv4Address& src_ip, 
                                const IPv4Address& dst_ip,
                                const std::vector<uint8_t>& payload) {
     
-    // Create pseudo-header
-    std::vector<uint8_t> pseudo_header;
-    
-    // Source IP (4 bytes)
+    // Pseudo-header sum (addresses, protocol, TCP length) without building it
     auto src_bytes = src_ip.to_bytes();
-    pseudo_header.insert(pseudo_header.end(), src_bytes.begin(), src_bytes.end());
-    
-    // Destination IP (4 bytes)
     auto dst_bytes = dst_ip.to_bytes();
-    pseudo_header.insert(pseudo_header.end(), dst_bytes.begin(), dst_bytes.end());
-    
-    // Reserved (1 byte)
-    pseudo_header.push_back(0);
-    
-    // Protocol (1 byte)
-    pseudo_header.push_back(6); // TCP
-    
-    // TCP length (2 bytes)
     uint16_t tcp_length = tcp_header.size() + payload.size();
-    pseudo_header.push_back((tcp_length >> 8) & 0xFF);
-    pseudo_header.push_back(tcp_length & 0xFF);
+    uint16_t pseudo_sum = checksum::pseudo_header_ipv4(src_bytes.data(), dst_bytes.data(),
+                                                       6, tcp_length); // TCP
     
-    // Combine pseudo-header, TCP header, and payload
-    std::vector<uint8_t> combined;
-    combined.insert(combined.end(), pseudo_header.begin(), pseudo_header.end());
-    combined.insert(combined.end(), tcp_header.begin(), tcp_header.end());
-    combined.insert(combined.end(), payload.begin(), payload.end());
-    
-    return calculate_ip_checksum(combined);
+    // Header and payload are summed in place
+    return checksum::finish(checksum::partial({
+        {tcp_header.data(), tcp_header.size()},
+        {payload.data(), payload.size()}
+    }, pseudo_sum));
 }
 
 // Verify IPv4 header checksum - raw pointer version
@@ -191,37 +158,9 @@ bool verify_ipv4_checksum(const uint8_t* data, size_t length) {
         return false; // Invalid header length
     }
     
-    // Calculate checksum for the IPv4 header
-    uint32_t sum = 0;
-    
-    // Sum all 16-bit words, skipping the checksum field (bytes 10-11)
-    for (size_t i = 0; i < ihl; i += 2) {
-        if (i == 10) {
-            // Skip the checksum field - treat as zero
-            continue;
-        }
-        
-        uint16_t word;
-        if (i + 1 < ihl) {
-            word = (data[i] << 8) + data[i + 1];
-        } else {
-            word = data[i] << 8; // Last byte if odd length
-        }
-        sum += word;
-    }
-    
-    // Fold 32-bit sum to 16 bits
-    while (sum >> 16) {
-        sum = (sum & 0xFFFF) + (sum >> 16);
-    }
-    
-    // Get the checksum from the header
-    uint16_t header_checksum = (data[10] << 8) + data[11];
-    
-    // The calculated checksum should be the complement of the header checksum
-    uint16_t calculated_checksum = ~sum;
-    
-    return calculated_checksum == header_checksum;
+    // Summing the whole header including the stored checksum gives 0xFFFF
+    // when the checksum is correct
+    return checksum::partial(data, ihl) == 0xFFFF;
 }
 
 // Verify IPv4 header checksum - vector version
@@ -232,66 +171,194 @@ bool verify_ipv4_checksum(const std::vector<uint8_t>& header) {
     return verify_ipv4_checksum(header.data(), header.size());
 }
 
+namespace {
+    bool transport_checksum_valid(const PacketRef& packet) {
+        if (packet.l4_offset < packet.l3_offset || packet.l4_offset > packet.length) {
+            return false;
+        }
+
+        const uint8_t* ip = packet.data + packet.l3_offset;
+        const uint8_t* l4 = packet.data + packet.l4_offset;
+        size_t l3_span = packet.l4_offset - packet.l3_offset;
+        bool ipv4 = (ip[0] >> 4) == 4;
+
+        uint8_t protocol;
+        size_t datagram_length;
+        if (ipv4) {
+            // Fragments carry only part of the checksummed data
+            bool more_fragments = (ip[6] & 0x20) != 0;
+            uint16_t fragment_offset = ((ip[6] << 8) | ip[7]) & 0x1FFF;
+            if (more_fragments || fragment_offset != 0) {
+                return true;
+            }
+            protocol = ip[9];
+            datagram_length = (ip[2] << 8) | ip[3];
+        } else {
+            // The next header field must name the transport directly
+            protocol = ip[6];
+            datagram_length = IPv6Header::SIZE + ((ip[4] << 8) | ip[5]);
+        }
+
+        if (datagram_length < l3_span) {
+            return false;
+        }
+        size_t l4_length = datagram_length - l3_span;
+        if (l4_length > packet.length - packet.l4_offset) {
+            return false; // Truncated capture
+        }
+
+        switch (protocol) {
+            case IPv4Header::PROTOCOL_UDP:
+                if (l4_length < UDPHeader::SIZE) {
+                    return false;
+                }
+                if (ipv4 && l4[6] == 0 && l4[7] == 0) {
+                    return true; // No checksum
+                }
+                break;
+            case IPv4Header::PROTOCOL_TCP:
+                if (l4_length < TCPHeader::MIN_SIZE) {
+                    return false;
+                }
+                break;
+            case IPv4Header::PROTOCOL_ICMP:
+                if (!ipv4) {
+                    return true;
+                }
+                return l4_length >= 4 && checksum::partial(l4, l4_length) == 0xFFFF;
+            case IPv6Header::NEXT_HEADER_ICMPV6:
+                if (ipv4) {
+                    return true;
+                }
+                if (l4_length < 4) {
+                    return false;
+                }
+                break;
+            default:
+                return true;
+        }
+
+        uint16_t pseudo_sum = ipv4
+            ? checksum::pseudo_header_ipv4(ip + 12, ip + 16, protocol, static_cast<uint16_t>(l4_length))
+            : checksum::pseudo_header_ipv6(ip + 8, ip + 24, protocol, static_cast<uint32_t>(l4_length));
+        return checksum::partial(l4, l4_length, pseudo_sum) == 0xFFFF;
+    }
+}
+
+std::vector<uint64_t> verify_checksums(const PacketRef* packets, size_t count) {
+    std::vector<uint64_t> failures((count + 63) / 64, 0);
+    auto fail = [&failures](size_t i) { failures[i / 64] |= uint64_t(1) << (i % 64); };
+
+    // 20-byte IPv4 headers are queued and summed in SIMD batches
+    constexpr size_t BATCH_SIZE = 64;
+    const uint8_t* headers[BATCH_SIZE];
+    size_t indices[BATCH_SIZE];
+    uint16_t sums[BATCH_SIZE];
+    size_t queued = 0;
+
+    auto flush = [&]() {
+        checksum::partial_ipv4_headers(headers, queued, sums);
+        for (size_t k = 0; k < queued; ++k) {
+            if (sums[k] != 0xFFFF) {
+                fail(indices[k]);
+            }
+        }
+        queued = 0;
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        const PacketRef& packet = packets[i];
+        if (!packet.data || packet.l3_offset >= packet.length) {
+            fail(i);
+            continue;
+        }
+
+        const uint8_t* ip = packet.data + packet.l3_offset;
+        size_t available = packet.length - packet.l3_offset;
+        uint8_t version = ip[0] >> 4;
+
+        if (version == 4) {
+            size_t ihl = (ip[0] & 0x0F) * 4;
+            if (ihl < IPv4Header::MIN_SIZE || available < ihl) {
+                fail(i);
+                continue;
+            }
+            if (ihl == IPv4Header::MIN_SIZE) {
+                headers[queued] = ip;
+                indices[queued++] = i;
+                if (queued == BATCH_SIZE) {
+                    flush();
+                }
+            } else if (checksum::partial(ip, ihl) != 0xFFFF) {
+                fail(i);
+            }
+        } else if (version != 6 || available < IPv6Header::SIZE) {
+            fail(i);
+            continue;
+        }
+
+        if (packet.l4_offset != 0 && !transport_checksum_valid(packet)) {
+            fail(i);
+        }
+    }
+    if (queued != 0) {
+        flush();
+    }
+
+    return failures;
+}
+
+std::vector<uint64_t> verify_checksums(const std::vector<PacketRef>& packets) {
+    return verify_checksums(packets.data(), packets.size());
+}
+
 // Parse packet and extract information
 PacketInfo analyze_packet(const std::vector<uint8_t>& packet) {
     PacketInfo info;
+    const uint8_t* data = packet.data();
+    size_t size = packet.size();
     size_t offset = 0;
     
-    // Check if packet is large enough for Ethernet header
-    if (packet.size() < 14) {
+    auto eth = EthernetHeader::parse(data, size);
+    if (!eth) {
         return info;
     }
-    
-    // Parse Ethernet header
     info.has_ethernet = true;
-    
-    // Extract MAC addresses
-    std::array<uint8_t, 6> dst_mac_bytes, src_mac_bytes;
-    std::copy(packet.begin(), packet.begin() + 6, dst_mac_bytes.begin());
-    std::copy(packet.begin() + 6, packet.begin() + 12, src_mac_bytes.begin());
-    
-    info.dst_mac = MacAddress(dst_mac_bytes);
-    info.src_mac = MacAddress(src_mac_bytes);
-    
-    // Extract EtherType
-    info.ethertype = (packet[12] << 8) | packet[13];
-    offset = 14;
+    info.dst_mac = eth->dst();
+    info.src_mac = eth->src();
+    info.ethertype = eth->ethertype();
+    offset = EthernetHeader::SIZE;
     
     // Parse IP header based on EtherType
-    if (info.ethertype == 0x0800 && packet.size() >= offset + 20) { // IPv4
-        info.has_ipv4 = true;
-        
-        // Extract protocol
-        info.ip_protocol = packet[offset + 9];
+    if (info.ethertype == EthernetHeader::ETHERTYPE_IPV4) {
+        if (auto ip = IPv4Header::parse(data + offset, size - offset)) {
+            info.has_ipv4 = true;
+            info.ip_protocol = ip->protocol();
+            info.src_ipv4 = ip->src();
+            info.dst_ipv4 = ip->dst();
+            offset += ip->ihl() * 4u;
         
-        // Extract IP addresses
-        std::array<uint8_t, 4> src_ip_bytes, dst_ip_bytes;
-        std::copy(packet.begin() + offset + 12, packet.begin() + offset + 16, src_ip_bytes.begin());
-        std::copy(packet.begin() + offset + 16, packet.begin() + offset + 20, dst_ip_bytes.begin());
-        
-        info.src_ipv4 = IPv4Address(src_ip_bytes[0], src_ip_bytes[1], src_ip_bytes[2], src_ip_bytes[3]);
-        info.dst_ipv4 = IPv4Address(dst_ip_bytes[0], dst_ip_bytes[1], dst_ip_bytes[2], dst_ip_bytes[3]);
-        
-        // Get IP header length
-        uint8_t ihl = (packet[offset] & 0x0F) * 4;
-        offset += ihl;
-        
-        // Parse transport layer
-        if (info.ip_protocol == 6 && packet.size() >= offset + 20) { // TCP
-            info.has_tcp = true;
-            info.src_port = (packet[offset] << 8) | packet[offset + 1];
-            info.dst_port = (packet[offset + 2] << 8) | packet[offset + 3];
-            
-            uint8_t tcp_header_length = ((packet[offset + 12] >> 4) & 0x0F) * 4;
-            offset += tcp_header_length;
-        } else if (info.ip_protocol == 17 && packet.size() >= offset + 8) { // UDP
-            info.has_udp = true;
-            info.src_port = (packet[offset] << 8) | packet[offset + 1];
-            info.dst_port = (packet[offset + 2] << 8) | packet[offset + 3];
-            offset += 8;
-        } else if (info.ip_protocol == 1 && packet.size() >= offset + 8) { // ICMP
-            info.has_icmp = true;
-            offset += 8;
+            // Parse transport layer
+            if (info.ip_protocol == IPv4Header::PROTOCOL_TCP) {
+                if (auto tcp = TCPHeader::parse(data + offset, size - offset)) {
+                    info.has_tcp = true;
+                    info.src_port = tcp->src_port();
+                    info.dst_port = tcp->dst_port();
+                    offset += tcp->data_offset() * 4u;
+                }
+            } else if (info.ip_protocol == IPv4Header::PROTOCOL_UDP) {
+                if (auto udp = UDPHeader::parse(data + offset, size - offset)) {
+                    info.has_udp = true;
+                    info.src_port = udp->src_port();
+                    info.dst_port = udp->dst_port();
+                    offset += UDPHeader::SIZE;
+                }
+            } else if (info.ip_protocol == IPv4Header::PROTOCOL_ICMP) {
+                if (ICMPHeader::parse(data + offset, size - offset)) {
+                    info.has_icmp = true;
+                    offset += ICMPHeader::MIN_SIZE;
+                }
+            }
         }
     }
     